@@ -6,6 +6,7 @@ extern "C" {
 #include <vector>
 #include <algorithm>
 #include <cstdarg>
+#include <cstring>
 #include <display_interface.h>
 #include "input_interface.h"
 
@@ -28,6 +29,7 @@ struct __window
     int attron(chtype);
     int attroff(chtype);
     int attrset(chtype attr);
+    chtype getattrs() const;
     int clear();
     int clrtoeol();
     int erase();
@@ -167,6 +169,11 @@ int __window::attrset(chtype a)
     return OK;
 }
 
+chtype __window::getattrs() const
+{
+    return attr;
+}
+
 int __window::attron(chtype ch)
 {
     if ((ch | A_COLOR) && (attr | A_COLOR))
@@ -194,8 +201,9 @@ int __window::erase()
 
 int __window::getch()
 {
+    //with no player attached (level sweeps) just get past any prompt
     if (!s_input)
-        return ERR;
+        return ' ';
     int ch = s_input->GetChar(!no_delay, false, nullptr);
     return ch ? ch : ERR;
 }
@@ -330,17 +338,27 @@ int __window::refresh()
     std::vector<Region> changed_regions;
     Region region = window_region();
 
+    //only the cells between the first and last change in a line go to the
+    //screen; look() redraws the same few around the hero every turn
     for (int r = 0; r < dimensions.y; ++r) {
-        if (memcmp(curscr->data(r + origin.y, origin.x), data(r, 0), dimensions.x * sizeof(chtype)) != 0) {
-            memcpy(curscr->data(r + origin.y, origin.x), data(r, 0), dimensions.x * sizeof(chtype));
-
-            Region rect;
-            rect.Top = origin.y + r;
-            rect.Left = origin.x;
-            rect.Bottom = rect.Top;
-            rect.Right = rect.Left + dimensions.x - 1;
-            changed_regions.push_back(rect);
-        }
+        chtype* screen = curscr->data(r + origin.y, origin.x);
+        chtype* line = data(r, 0);
+        int first = 0;
+        while (first < dimensions.x && screen[first] == line[first])
+            ++first;
+        if (first == dimensions.x)
+            continue;
+        int last = dimensions.x - 1;
+        while (screen[last] == line[last])
+            --last;
+        memcpy(screen + first, line + first, (last - first + 1) * sizeof(chtype));
+
+        Region rect;
+        rect.Top = origin.y + r;
+        rect.Left = origin.x + first;
+        rect.Bottom = rect.Top;
+        rect.Right = origin.x + last;
+        changed_regions.push_back(rect);
     }
 
     if (s_screen) {
@@ -577,6 +595,11 @@ int getcury(WINDOW* w)
     return w->getcury();
 }
 
+chtype getattrs(WINDOW* w)
+{
+    return w->getattrs();
+}
+
 int getcurx(WINDOW* w)
 {
     return w->getcurx();
@@ -27,7 +27,8 @@ HEADERS += \
     qrogue_display.h \
     qrogue_input.h \
     tile_provider.h \
-    colors.h
+    colors.h \
+    $$PWD/../../Shared/render_model.h
 
 SOURCES += \
     plugin.cpp \
@@ -45,7 +46,8 @@ SOURCES += \
     text_provider.cpp \
     tile_provider.cpp \
     font_provider.cpp \
-    colors.cpp
+    colors.cpp \
+    $$PWD/../../Shared/render_model.cpp
 
 win32 {
     DEFINES += "WINVER=0x0500"
@@ -4,7 +4,6 @@
 #include <QRectF>
 #include <QKeyEvent>
 #include <QGuiApplication>
-#include <pc_gfx_charmap.h>
 #include "qrogue_display.h"
 #include "qrogue_input.h"
 #include "dos_to_unicode.h"
@@ -15,57 +14,6 @@
 namespace
 {
     const int kMaxQueueSize = 10;
-
-    uint32_t CharText(uint32_t ch)
-    {
-        return ch & 0x0000ffff;
-    }
-
-    uint32_t CharColor(uint32_t ch)
-    {
-        return (ch >> 24) & 0xff;
-    }
-
-    bool IsText(uint32_t ch)
-    {
-        return (ch & 0x010000) == 0;
-    }
-
-    bool BlinkChar(uint32_t ch)
-    {
-        return CharText(ch) == STAIRS;
-    }
-
-    unsigned int FlipColor(unsigned int c)
-    {
-        return ((c & 0x0f) << 4) | ((c & 0xf0) >> 4);
-    }
-
-    std::map<int, int> unix_chars = {
-        { PASSAGE,   '#' },
-        { DOOR,      '+' },
-        { FLOOR,     '.' },
-        { PLAYER,    '@' },
-        { TRAP,      '^' },
-        { STAIRS,    '%' },
-        { GOLD,      '*' },
-        { POTION,    '!' },
-        { SCROLL,    '?' },
-        { FOOD,      ':' },
-        { STICK,     '/' },
-        { ARMOR,     ']' },
-        { AMULET,    ',' },
-        { RING,      '=' },
-        { WEAPON,    ')' },
-        { VWALL,     '|' },
-        { HWALL,     '-' },
-        { ULWALL,    '-' },
-        { URWALL,    '-' },
-        { LLWALL,    '-' },
-        { LRWALL,    '-' },
-        { 204,       '|' },
-        { 185,       '|' },
-    };
 }
 
 QRogueDisplay::QRogueDisplay(QRogue* parent, Coord screen_size, const std::string& graphics)
@@ -210,6 +158,8 @@ bool QRogueDisplay::Monochrome() const
 void QRogueDisplay::SetMonochrome(bool enable)
 {
     monochrome_ = enable;
+    if (config_)
+        BuildModel();
 }
 
 bool QRogueDisplay::Sound() const
@@ -333,10 +283,11 @@ void QRogueDisplay::Render(QPainter *painter)
 
 void QRogueDisplay::RenderRegion(QPainter *painter, uint32_t *data, Region rect)
 {
+    grid_.resize(TotalChars());
+    model_->Resolve(data, { screen_size_.width(), screen_size_.height() }, rect, grid_.data());
     for (int y = rect.Top; y <= rect.Bottom; ++y) {
         for (int x = rect.Left; x <= rect.Right; ++x) {
-            uint32_t info = data[Index(x,y)];
-            PaintChar(painter, x, y, CharText(info), CharColor(info), IsText(info));
+            PaintCell(painter, x, y, grid_[Index(x,y)]);
         }
     }
 }
@@ -364,119 +315,19 @@ void QRogueDisplay::RenderCounterOverlay(QPainter* painter, const std::string& l
     for (size_t i = 0; i < len; ++i) {
         int x = screen_size_.width() - (len - i) - 1;
         int y = screen_size_.height() - 1;
-        PaintChar(painter, x, y, s[i], 0x70, true);
+        PaintCell(painter, x, y, model_->Resolve((unsigned char)s[i] | 0x70000000, y));
     }
 }
 
-unsigned int GetTileColor(int ch, int color)
-{
-    //if it is inside a room
-    if (color == 0x07 || color == 0)
-        switch (ch)
-        {
-        case DOOR:
-        case VWALL:
-        case HWALL:
-        case ULWALL:
-        case URWALL:
-        case LLWALL:
-        case LRWALL:
-            return 0x06; //brown
-        case FLOOR:
-            return 0x0a; //light green
-        case STAIRS:
-            return 0x20; //black on light green
-        case TRAP:
-            return 0x05; //magenta
-        case GOLD:
-        case PLAYER:
-            return 0x0e; //yellow
-        case POTION:
-        case SCROLL:
-        case STICK:
-        case ARMOR:
-        case AMULET:
-        case RING:
-        case WEAPON:
-            return 0x09; //light blue
-        case FOOD:
-            return 0x04; //red
-        }
-
-    //if inside a passage or a maze
-    else if (color == 0x70)
-        switch (ch)
-        {
-        case FOOD:
-            return 0x74; //red on grey
-        case GOLD:
-        case PLAYER:
-            return 0x7e; //yellow on grey
-        case POTION:
-        case SCROLL:
-        case STICK:
-        case ARMOR:
-        case AMULET:
-        case RING:
-        case WEAPON:
-            return 0x71; //blue on grey
-        }
-
-    return color;
-}
-
-void QRogueDisplay::PaintChar(QPainter *painter, int x, int y, int ch, int color, bool is_text)
+void QRogueDisplay::PaintCell(QPainter *painter, int x, int y, RenderCell cell)
 {
-    // Hack for consistent standout in msg lines.  Unix versions use '-'.
-    // PC uses ' ' with background color.  We want consistent behavior.
-    if (y == 0 && color == 0x70) {
-        if (Gfx().use_standout && ch == '-')
-            ch = ' ';
-        else if (!Gfx().use_standout && ch == ' ')
-            ch = '-';
-    }
-
-    // Tiles from Unix versions come in with either color=0x00 (for regular state)
-    // or color=0x70 (for standout).  We need to translate these into more diverse
-    // colors.  Tiles from PC versions already have the correct color, so we
-    // technically don't need to do anything here, but it doesn't hurt to set
-    // the colors again.
-    if (!is_text) {
-        color = GetTileColor(ch, color);
-    }
-    color = TranslateColor(color, is_text);
-
-    ch = TranslateChar(ch, is_text);
-
     auto w = TileSize().width();
     auto h = TileSize().height();
     QRect r(w*x, h*y, w, h);
-    if (is_text)
-        TextPainter()->PaintTile(painter, r, ch, color);
+    if (cell.flags & RenderCell::kTile)
+        TilePainter()->PaintTile(painter, r, cell.glyph, cell.color);
     else
-        TilePainter()->PaintTile(painter, r, ch, color);
-}
-
-int QRogueDisplay::TranslateChar(int ch, bool is_text) const
-{
-    if (!is_text && tile_provider_)
-        return ch;
-
-    if (Gfx().animate && frame_%2 == 1 && BlinkChar(ch)){
-        ch = ' ';
-    }
-
-    if (!is_text && Gfx().use_unix_gfx){
-        auto i = unix_chars.find(ch);
-        if (i != unix_chars.end()) {
-            ch = i->second;
-        }
-    }
-
-    if (text_provider_)
-        return ch;
-
-    return DosToUnicode(ch);
+        TextPainter()->PaintTile(painter, r, cell.Glyph(frame_ % 2), cell.color);
 }
 
 int QRogueDisplay::DefaultColor() const
@@ -484,24 +335,6 @@ int QRogueDisplay::DefaultColor() const
     return Gfx().text ? Gfx().text->colors.front() : 0x07;
 }
 
-int QRogueDisplay::TranslateColor(int color, bool is_text) const
-{    
-    if (!color)
-        color = DefaultColor();
-
-    // The tile provider relies on the original color to select correct bolt tile
-    if (!is_text && TilePainter() == tile_provider_.get())
-        return color;
-
-    if (!Gfx().use_colors || monochrome_) {
-        if (Gfx().use_standout && ((color>>4) == 0x07 || (Gfx().use_colors && color > 0x0f)))
-            color = FlipColor(DefaultColor());
-        else
-            color = DefaultColor();
-    }
-    return color;
-}
-
 int QRogueDisplay::Index(int x, int y) const
 {
     return y*screen_size_.width() + x;
@@ -534,15 +367,14 @@ void QRogueDisplay::Animate()
         lock.unlock();
 
         for (int i = 0; i < TotalChars(); ++i) {
-            uint32_t info = copy.data[i];
-            if (!BlinkChar(info))
-                continue;
-
             int x = i % copy.dimensions.x;
             int y = i / copy.dimensions.x;
+            RenderCell cell = model_->Resolve(copy.data[i], y);
+            if (!(cell.flags & RenderCell::kBlink))
+                continue;
 
             QPainter screen_painter(screen_buffer_.get());
-            PaintChar(&screen_painter, x, y, CharText(info), CharColor(info), IsText(info));
+            PaintCell(&screen_painter, x, y, cell);
             update = true;
         }
     }
@@ -594,9 +426,27 @@ void QRogueDisplay::LoadAssets()
         text_provider_.reset(new TextProvider(*Gfx().text));
     }
 
+    BuildModel();
     parent_->tileSizeChanged();
 }
 
+void QRogueDisplay::BuildModel()
+{
+    RenderOptions options;
+    options.default_color = DefaultColor();
+    options.tiles = tile_provider_ != nullptr;
+    options.use_unix_gfx = Gfx().use_unix_gfx;
+    options.use_colors = Gfx().use_colors && !monochrome_;
+    options.use_standout = Gfx().use_standout;
+    options.animate = Gfx().animate;
+
+    //the bundled font is laid out in Unicode, the text sheets in code page 437
+    RenderModel::GlyphMap map = nullptr;
+    if (!text_provider_)
+        map = DosToUnicode;
+    model_.reset(new RenderModel(options, map));
+}
+
 QRogueDisplay::ThreadData::ThreadData(QRogueDisplay::ThreadData &other)
 {
     dimensions = other.dimensions;
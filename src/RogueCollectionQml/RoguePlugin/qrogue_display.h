@@ -10,6 +10,7 @@
 #include <QSoundEffect>
 #include <coord.h>
 #include <display_interface.h>
+#include <render_model.h>
 #include "game_config.h"
 #include "colors.h"
 
@@ -69,10 +70,9 @@ public:
 
 private:
     void LoadAssets();
-    void PaintChar(QPainter *painter, int x, int y, int ch, int color, bool is_text);
-    int TranslateChar(int ch, bool is_text) const;
+    void BuildModel();
+    void PaintCell(QPainter *painter, int x, int y, RenderCell cell);
     int DefaultColor() const;
-    int TranslateColor(int color, bool is_text) const;
     int Index(int x, int y) const;
 
     QPainter& ScreenPainter();
@@ -93,6 +93,8 @@ private:
     std::string gfx_mode_;
     int frame_ = 0;
     std::unique_ptr<QPixmap> screen_buffer_;
+    std::unique_ptr<RenderModel> model_;
+    std::vector<RenderCell> grid_;
     std::map<std::string, QSoundEffect*> sounds_;
 
     struct ThreadData
@@ -8,11 +8,6 @@ xcopy ..\..\res\fonts\Px437_IBM_VGA8.ttf .\staging\res\fonts\
 xcopy ..\..\res\fonts\*.txt .\staging\res\fonts\
 xcopy ..\..\res\sounds\*.wav .\staging\res\sounds\
 
-xcopy ..\..\data\scrolls.dat .\staging\data\
-xcopy ..\..\data\potions.dat .\staging\data\
-xcopy ..\..\data\sticks.dat .\staging\data\
-xcopy ..\..\data\rings.dat .\staging\data\
-
 xcopy ..\..\src\RogueCollectionQml\gpl-3.0.txt .\staging\license\
 copy ..\..\src\RogueVersions\Rogue_5_4_2\LICENSE.TXT  .\staging\license\unix-rogue.txt
 
@@ -30,6 +30,25 @@ bool LoadArg(Args& a, const std::string& arg, const std::string& next)
         a.fontfile = next;
         return true;
     }
+    else if (arg == "--record") {
+        a.record_path = next;
+        return true;
+    }
+    else if (arg == "--play") {
+        a.play_path = next;
+        return true;
+    }
+    else if (arg == "--export") {
+        a.export_path = next;
+        return true;
+    }
+    else if (arg == "--watch") {
+        a.watch_path = next;
+        return true;
+    }
+    else if (arg == "--crt-benchmark") {
+        a.crt_benchmark = true;
+    }
     else if (arg == "--profile") {
         //reserved for Retro Rogue
         return true;
@@ -15,6 +15,11 @@ struct Args
     bool start_paused = false;
     std::string pause_at;
     bool small_screen = false;
+    std::string record_path;
+    std::string play_path;
+    std::string export_path;
+    std::string watch_path;
+    bool crt_benchmark = false;
 };
 
 
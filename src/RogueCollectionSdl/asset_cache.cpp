@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <stdexcept>
+#include <SDL_image.h>
+#include "asset_cache.h"
+#include "text_provider.h"
+#include "startup_timeline.h"
+
+struct AssetCache::Entry
+{
+    std::string key;
+    Loader load;
+    SDL::Scoped::Surface surface = SDL::Scoped::Surface(nullptr, SDL_FreeSurface);
+    std::string error;
+    bool started = false;
+    bool done = false;
+};
+
+namespace
+{
+    struct Asset
+    {
+        std::string key;
+        std::function<SDL::Scoped::Surface()> load;
+    };
+
+    Asset BmpAsset(const std::string& filename)
+    {
+        return { "bmp:" + filename, [filename]() { return LoadBmp(filename); } };
+    }
+
+    Asset ImageAsset(const std::string& filename)
+    {
+        return { "image:" + filename, [filename]() { return LoadImage(filename); } };
+    }
+
+    Asset GlyphAsset(const FontConfig& cfg)
+    {
+        return { "font:" + cfg.fontfile + ":" + std::to_string(cfg.size), [cfg]() { return RenderGlyphs(cfg); } };
+    }
+
+    //What a graphics mode loads, picked the same way ScreenRenderer and CreateTextProvider pick it
+    std::vector<Asset> GraphicsAssets(const GraphicsConfig& cfg)
+    {
+        std::vector<Asset> assets;
+        if (cfg.font && !cfg.font->fontfile.empty())
+            assets.push_back(GlyphAsset(*cfg.font));
+        else if (cfg.text->generate_colors)
+            assets.push_back(BmpAsset(GetResourcePath("") + cfg.text->imagefile));
+        else
+            assets.push_back(ImageAsset(GetResourcePath("") + cfg.text->imagefile));
+
+        if (cfg.tiles)
+            assets.push_back(BmpAsset(GetResourcePath("") + cfg.tiles->filename));
+        return assets;
+    }
+
+    SDL::Scoped::Surface CopySurface(SDL_Surface* surface)
+    {
+        SDL::Scoped::Surface copy(SDL_ConvertSurface(surface, surface->format, 0), SDL_FreeSurface);
+        if (copy == nullptr)
+            throw_error("SDL_ConvertSurface");
+        return copy;
+    }
+}
+
+AssetCache& AssetCache::Instance()
+{
+    static AssetCache cache;
+    return cache;
+}
+
+AssetCache::AssetCache()
+{
+}
+
+AssetCache::~AssetCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_cv.notify_all();
+    }
+    for (auto& t : m_workers)
+        t.join();
+}
+
+void AssetCache::Preload(const std::vector<GameConfig>& options)
+{
+    //loading the PNG decoder isn't safe from several threads at once
+    IMG_Init(IMG_INIT_PNG);
+
+    for (const char* file : { "title3.png", "epyx.png" }) {
+        Asset a = ImageAsset(GetResourcePath("") + file);
+        Queue(a.key, a.load);
+    }
+    for (const GameConfig& game : options) {
+        for (const GraphicsConfig& cfg : game.gfx_options) {
+            for (Asset& a : GraphicsAssets(cfg))
+                Queue(a.key, a.load);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_workers.empty())
+        return;
+    int count = std::max(1, std::min((int)std::thread::hardware_concurrency(), (int)m_queue.size()));
+    for (int i = 0; i < count; ++i)
+        m_workers.push_back(std::thread(&AssetCache::Work, this));
+}
+
+SDL::Scoped::Surface AssetCache::Bmp(const std::string& filename)
+{
+    Asset a = BmpAsset(filename);
+    return Get(a.key, a.load);
+}
+
+SDL::Scoped::Surface AssetCache::Image(const std::string& filename)
+{
+    Asset a = ImageAsset(filename);
+    return Get(a.key, a.load);
+}
+
+SDL::Scoped::Surface AssetCache::Glyphs(const FontConfig& cfg)
+{
+    Asset a = GlyphAsset(cfg);
+    return Get(a.key, a.load);
+}
+
+bool AssetCache::IsReady(const GraphicsConfig& cfg)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (Asset& a : GraphicsAssets(cfg)) {
+        auto i = m_entries.find(a.key);
+        if (i == m_entries.end() || !i->second->done || !i->second->error.empty())
+            return false;
+    }
+    return true;
+}
+
+bool AssetCache::IsDecoding(const GraphicsConfig& cfg)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (Asset& a : GraphicsAssets(cfg)) {
+        auto i = m_entries.find(a.key);
+        if (i != m_entries.end() && !i->second->done)
+            return true;
+    }
+    return false;
+}
+
+void AssetCache::Queue(const std::string& key, Loader load)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_entries.count(key))
+        return;
+
+    Entry* entry = new Entry;
+    entry->key = key;
+    entry->load = load;
+    m_entries[key].reset(entry);
+    m_queue.push_back(entry);
+    m_cv.notify_all();
+}
+
+SDL::Scoped::Surface AssetCache::Get(const std::string& key, Loader load)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::unique_ptr<Entry>& p = m_entries[key];
+    if (!p) {
+        p.reset(new Entry);
+        p->key = key;
+        p->load = load;
+    }
+    Entry* entry = p.get();
+
+    //rather than wait for a worker to get to it
+    if (!entry->started)
+        Load(entry, lock);
+    m_cv.wait(lock, [entry] { return entry->done; });
+
+    if (!entry->error.empty())
+        throw_error(entry->error);
+    //copied under the lock, as converting a surface touches the original too
+    return CopySurface(entry->surface.get());
+}
+
+//Called and returns with the lock held, but lets go of it while decoding
+void AssetCache::Load(Entry* entry, std::unique_lock<std::mutex>& lock)
+{
+    entry->started = true;
+    m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), entry), m_queue.end());
+    lock.unlock();
+
+    SDL::Scoped::Surface surface(nullptr, SDL_FreeSurface);
+    std::string error;
+    try {
+        surface = entry->load();
+    }
+    catch (const std::exception& e) {
+        error = e.what();
+    }
+    MarkStartup("decoded " + entry->key);
+
+    lock.lock();
+    entry->surface = std::move(surface);
+    entry->error = error;
+    entry->done = true;
+    m_cv.notify_all();
+}
+
+void AssetCache::Work()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_cv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+        if (m_stop)
+            return;
+        Load(m_queue.front(), lock);
+    }
+}
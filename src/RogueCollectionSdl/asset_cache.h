@@ -0,0 +1,54 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sdl_utility.h"
+#include "game_config.h"
+
+//Decodes the images and fonts the menus and graphics modes use on a pool of
+//background threads, so they're waiting in memory by the time the render
+//thread wants to make textures of them.  Every caller gets its own copy of a
+//surface, so threads never share SDL state through the cache.
+struct AssetCache
+{
+    static AssetCache& Instance();
+    ~AssetCache();
+
+    //Starts decoding everything the menus and the given games could show
+    void Preload(const std::vector<GameConfig>& options);
+
+    //These wait for an asset that's still being decoded, and decode one that
+    //was never preloaded on the spot
+    SDL::Scoped::Surface Bmp(const std::string& filename);
+    SDL::Scoped::Surface Image(const std::string& filename);
+    SDL::Scoped::Surface Glyphs(const FontConfig& cfg);
+
+    //If everything a graphics mode uses has been decoded
+    bool IsReady(const GraphicsConfig& cfg);
+    //If anything a graphics mode uses is still queued or being decoded
+    bool IsDecoding(const GraphicsConfig& cfg);
+
+private:
+    typedef std::function<SDL::Scoped::Surface()> Loader;
+    struct Entry;
+
+    AssetCache();
+
+    void Queue(const std::string& key, Loader load);
+    SDL::Scoped::Surface Get(const std::string& key, Loader load);
+    void Load(Entry* entry, std::unique_lock<std::mutex>& lock);
+    void Work();
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::map<std::string, std::unique_ptr<Entry>> m_entries;
+    std::deque<Entry*> m_queue;
+    std::vector<std::thread> m_workers;
+    bool m_stop = false;
+};
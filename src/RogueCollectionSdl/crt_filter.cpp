@@ -0,0 +1,508 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include "crt_filter.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CRT_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define CRT_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    const uint32_t kDecay = 200;          //how much of the afterglow is left each frame, out of 256
+    const uint32_t kBloomStrength = 160;  //out of 256
+    const int kBloomScale = 4;
+    const int kBloomRadius = 2;
+    const double kCurvature = 0.12;
+    const double kScanlineDepth = 0.35;
+
+    uint32_t Scale(uint32_t px, uint32_t w)
+    {
+        uint32_t rb = ((px & 0x00ff00ff) * w >> 8) & 0x00ff00ff;
+        uint32_t ag = (((px >> 8) & 0x00ff00ff) * w) & 0xff00ff00;
+        return rb | ag;
+    }
+
+    uint32_t Max(uint32_t a, uint32_t b)
+    {
+        uint32_t r = 0;
+        for (int s = 0; s < 32; s += 8)
+            r |= std::max((a >> s) & 0xff, (b >> s) & 0xff) << s;
+        return r;
+    }
+
+    uint32_t AddSaturate(uint32_t a, uint32_t b)
+    {
+        uint32_t r = 0;
+        for (int s = 0; s < 32; s += 8)
+            r |= std::min<uint32_t>(((a >> s) & 0xff) + ((b >> s) & 0xff), 0xff) << s;
+        return r;
+    }
+}
+
+//Runs the bands of a frame on a fixed set of threads.  The calling thread
+//works too, and every worker wakes exactly once per Run, so a slow one can't
+//pick up a band of the next frame with the last frame's job.
+struct CrtWorkers
+{
+    explicit CrtWorkers(int count)
+    {
+        for (int i = 0; i < count; ++i)
+            m_threads.push_back(std::thread(&CrtWorkers::Work, this));
+    }
+
+    ~CrtWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (auto& t : m_threads)
+            t.join();
+    }
+
+    int Size() const
+    {
+        return (int)m_threads.size() + 1;
+    }
+
+    //Calls job for every band below count and returns once they're all done
+    void Run(int count, const std::function<void(int)>& job)
+    {
+        if (m_threads.empty() || count == 1) {
+            for (int i = 0; i < count; ++i)
+                job(i);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = &job;
+            m_count = count;
+            m_next = 0;
+            m_busy = (int)m_threads.size();
+            ++m_generation;
+        }
+        m_cv.notify_all();
+        Drain(job, count);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_busy == 0; });
+    }
+
+private:
+    void Drain(const std::function<void(int)>& job, int count)
+    {
+        for (int i = m_next++; i < count; i = m_next++)
+            job(i);
+    }
+
+    void Work()
+    {
+        unsigned seen = 0;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            m_cv.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop)
+                return;
+            seen = m_generation;
+            const std::function<void(int)>& job = *m_job;
+            int count = m_count;
+
+            lock.unlock();
+            Drain(job, count);
+            lock.lock();
+
+            if (--m_busy == 0)
+                m_done.notify_all();
+        }
+    }
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::condition_variable m_done;
+    const std::function<void(int)>* m_job = nullptr;
+    int m_count = 0;
+    std::atomic<int> m_next{ 0 };
+    int m_busy = 0;
+    unsigned m_generation = 0;
+    bool m_stop = false;
+};
+
+bool CrtOptions::Enabled() const
+{
+    return scanlines || persistence || bloom || curvature;
+}
+
+CrtOptions ParseCrtOptions(const std::string& value)
+{
+    CrtOptions options;
+    if (value == "true") {
+        options.scanlines = options.persistence = options.bloom = options.curvature = true;
+        return options;
+    }
+
+    std::istringstream ss(value);
+    std::string effect;
+    while (std::getline(ss, effect, ',')) {
+        effect.erase(0, effect.find_first_not_of(" \t"));
+        effect.erase(effect.find_last_not_of(" \t") + 1);
+        if (effect == "scanlines")
+            options.scanlines = true;
+        else if (effect == "persistence")
+            options.persistence = true;
+        else if (effect == "bloom")
+            options.bloom = true;
+        else if (effect == "curvature")
+            options.curvature = true;
+    }
+    return options;
+}
+
+CrtFilter::CrtFilter(const CrtOptions& options, int threads) :
+    m_options(options),
+    m_fading(false)
+{
+    if (threads <= 0)
+        threads = std::max(1, (int)std::thread::hardware_concurrency());
+    m_workers.reset(new CrtWorkers(threads - 1));
+}
+
+CrtFilter::~CrtFilter()
+{
+}
+
+bool CrtFilter::Fading() const
+{
+    return m_fading;
+}
+
+//Several bands per thread, so one that's slow to start doesn't hold up the frame
+int CrtFilter::Bands(int rows) const
+{
+    return std::max(1, std::min(rows, m_workers->Size() * 4));
+}
+
+void CrtFilter::Process(const uint32_t* src, int src_w, int src_h, uint32_t* out, int out_w, int out_h, int out_pitch)
+{
+    if (src_w != m_src_w || src_h != m_src_h || out_w != m_out_w || out_h != m_out_h)
+        Resize(src_w, src_h, out_w, out_h);
+
+    m_fading = false;
+    int bands = Bands(src_h);
+    m_workers->Run(bands, [&](int i) {
+        Glow(src, src_h * i / bands * src_w, src_h * (i + 1) / bands * src_w);
+    });
+
+    if (m_options.bloom) {
+        bands = Bands(m_bloom_h);
+        m_workers->Run(bands, [&](int i) {
+            Downsample(m_bloom_h * i / bands, m_bloom_h * (i + 1) / bands);
+        });
+        Blur();
+    }
+
+    bands = Bands(out_h);
+    m_workers->Run(bands, [&](int i) {
+        Remap(out, out_pitch, out_h * i / bands, out_h * (i + 1) / bands);
+    });
+}
+
+void CrtFilter::Resize(int src_w, int src_h, int out_w, int out_h)
+{
+    m_src_w = src_w;
+    m_src_h = src_h;
+    m_out_w = out_w;
+    m_out_h = out_h;
+    m_bloom_w = (src_w + kBloomScale - 1) / kBloomScale;
+    m_bloom_h = (src_h + kBloomScale - 1) / kBloomScale;
+
+    const int32_t off_glow = src_w * src_h;
+    const int32_t off_bloom = m_bloom_w * m_bloom_h;
+    m_glow.assign(off_glow + 1, 0);
+    m_bloom.assign(off_bloom + 1, 0);
+    m_blur.assign(off_bloom, 0);
+
+    //scanlines only show once each line of the game has a few pixels to itself
+    double depth = m_options.scanlines ? kScanlineDepth * std::min(std::max((double)out_h / src_h - 1, 0.0), 1.0) : 0;
+
+    int total = out_w * out_h;
+    m_map.resize(total);
+    m_bloom_map.resize(total);
+    m_weight.resize(total);
+    for (int y = 0; y < out_h; ++y) {
+        for (int x = 0; x < out_w; ++x) {
+            double cx = (x + 0.5) / out_w - 0.5;
+            double cy = (y + 0.5) / out_h - 0.5;
+            if (m_options.curvature) {
+                //the bulge of the tube, as in ShaderTerminal.qml, but pushing
+                //the corners out of view instead of the edges of the screen
+                double d = (cx * cx + cy * cy) * kCurvature;
+                cx += cx * (1 + d) * d;
+                cy += cy * (1 + d) * d;
+            }
+            double fx = (cx + 0.5) * src_w;
+            double fy = (cy + 0.5) * src_h;
+
+            int i = y * out_w + x;
+            if (fx < 0 || fy < 0 || fx >= src_w || fy >= src_h) {
+                m_map[i] = off_glow;
+                m_bloom_map[i] = off_bloom;
+                m_weight[i] = 0;
+                continue;
+            }
+
+            int sx = (int)fx;
+            int sy = (int)fy;
+            double edge = (fy - sy - 0.5) * 2;
+            uint32_t w = (uint32_t)std::lround(256 * (1 - depth * edge * edge));
+            m_map[i] = sy * src_w + sx;
+            m_bloom_map[i] = (sy / kBloomScale) * m_bloom_w + sx / kBloomScale;
+            m_weight[i] = w | (w << 16);
+        }
+    }
+}
+
+//Keeps the brighter of the new frame and what's left of the old glow
+void CrtFilter::Glow(const uint32_t* src, int begin, int end)
+{
+    uint32_t* glow = m_glow.data();
+    if (!m_options.persistence) {
+        memcpy(glow + begin, src + begin, (end - begin) * sizeof(uint32_t));
+        return;
+    }
+
+    bool fading = false;
+    int i = begin;
+#if defined(CRT_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i decay = _mm_set1_epi16((short)kDecay);
+    __m128i differ = zero;
+    for (; i + 4 <= end; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i g = _mm_loadu_si128((const __m128i*)(glow + i));
+        __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(g, zero), decay), 8);
+        __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(g, zero), decay), 8);
+        g = _mm_max_epu8(_mm_packus_epi16(lo, hi), s);
+        differ = _mm_or_si128(differ, _mm_xor_si128(g, s));
+        _mm_storeu_si128((__m128i*)(glow + i), g);
+    }
+    fading = _mm_movemask_epi8(_mm_cmpeq_epi8(differ, zero)) != 0xffff;
+#elif defined(CRT_NEON)
+    const uint8x8_t decay = vdup_n_u8((uint8_t)kDecay);
+    uint8x16_t differ = vdupq_n_u8(0);
+    for (; i + 4 <= end; i += 4) {
+        uint8x16_t s = vld1q_u8((const uint8_t*)(src + i));
+        uint8x16_t g = vld1q_u8((const uint8_t*)(glow + i));
+        uint8x8_t lo = vshrn_n_u16(vmull_u8(vget_low_u8(g), decay), 8);
+        uint8x8_t hi = vshrn_n_u16(vmull_u8(vget_high_u8(g), decay), 8);
+        g = vmaxq_u8(vcombine_u8(lo, hi), s);
+        differ = vorrq_u8(differ, veorq_u8(g, s));
+        vst1q_u8((uint8_t*)(glow + i), g);
+    }
+    uint64x2_t d = vreinterpretq_u64_u8(differ);
+    fading = (vgetq_lane_u64(d, 0) | vgetq_lane_u64(d, 1)) != 0;
+#endif
+    for (; i < end; ++i) {
+        glow[i] = Max(Scale(glow[i], kDecay), src[i]);
+        fading |= glow[i] != src[i];
+    }
+
+    if (fading)
+        m_fading = true;
+}
+
+//Averages blocks of the glow into the bloom buffer, rows begin to end of it
+void CrtFilter::Downsample(int begin, int end)
+{
+    const int area = kBloomScale * kBloomScale;
+    for (int by = begin; by < end; ++by) {
+        for (int bx = 0; bx < m_bloom_w; ++bx) {
+            uint32_t sum[4] = { 0, 0, 0, 0 };
+            for (int y = by * kBloomScale; y < std::min((by + 1) * kBloomScale, m_src_h); ++y) {
+                const uint32_t* row = &m_glow[y * m_src_w];
+                for (int x = bx * kBloomScale; x < std::min((bx + 1) * kBloomScale, m_src_w); ++x) {
+                    uint32_t px = row[x];
+                    sum[0] += px & 0xff;
+                    sum[1] += (px >> 8) & 0xff;
+                    sum[2] += (px >> 16) & 0xff;
+                }
+            }
+            m_bloom[by * m_bloom_w + bx] = (sum[0] / area) | ((sum[1] / area) << 8) | ((sum[2] / area) << 16);
+        }
+    }
+}
+
+//A box blur across and then down.  At a quarter of the resolution this is a
+//small part of the frame, so it runs on one thread.
+void CrtFilter::Blur()
+{
+    const int n = 2 * kBloomRadius + 1;
+    for (int pass = 0; pass < 2; ++pass) {
+        const uint32_t* from = pass == 0 ? m_bloom.data() : m_blur.data();
+        uint32_t* to = pass == 0 ? m_blur.data() : m_bloom.data();
+        int len = pass == 0 ? m_bloom_w : m_bloom_h;
+        int lines = pass == 0 ? m_bloom_h : m_bloom_w;
+        int step = pass == 0 ? 1 : m_bloom_w;
+        int stride = pass == 0 ? m_bloom_w : 1;
+
+        for (int line = 0; line < lines; ++line) {
+            const uint32_t* in = from + line * stride;
+            uint32_t* out = to + line * stride;
+            for (int i = 0; i < len; ++i) {
+                uint32_t sum[3] = { 0, 0, 0 };
+                for (int k = std::max(0, i - kBloomRadius); k <= std::min(len - 1, i + kBloomRadius); ++k) {
+                    uint32_t px = in[k * step];
+                    sum[0] += px & 0xff;
+                    sum[1] += (px >> 8) & 0xff;
+                    sum[2] += (px >> 16) & 0xff;
+                }
+                out[i * step] = (sum[0] / n) | ((sum[1] / n) << 8) | ((sum[2] / n) << 16);
+            }
+        }
+    }
+}
+
+//Scales the glow up to the window through the lookup tables, darkening the
+//edges of each line and adding the bloom on top
+void CrtFilter::Remap(uint32_t* out, int out_pitch, int begin, int end)
+{
+    const uint32_t* glow = m_glow.data();
+    const uint32_t* bloom = m_bloom.data();
+    bool use_bloom = m_options.bloom;
+
+    for (int y = begin; y < end; ++y) {
+        uint32_t* row = (uint32_t*)((char*)out + y * out_pitch);
+        const int32_t* map = &m_map[y * m_out_w];
+        const int32_t* bloom_map = &m_bloom_map[y * m_out_w];
+        const uint32_t* weight = &m_weight[y * m_out_w];
+
+        int x = 0;
+#if defined(CRT_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i strength = _mm_set1_epi16((short)kBloomStrength);
+        for (; x + 4 <= m_out_w; x += 4) {
+            __m128i px = _mm_set_epi32(glow[map[x + 3]], glow[map[x + 2]], glow[map[x + 1]], glow[map[x]]);
+            __m128i w = _mm_loadu_si128((const __m128i*)(weight + x));
+            __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(px, zero), _mm_unpacklo_epi32(w, w)), 8);
+            __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(px, zero), _mm_unpackhi_epi32(w, w)), 8);
+            px = _mm_packus_epi16(lo, hi);
+            if (use_bloom) {
+                __m128i b = _mm_set_epi32(bloom[bloom_map[x + 3]], bloom[bloom_map[x + 2]], bloom[bloom_map[x + 1]], bloom[bloom_map[x]]);
+                lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), strength), 8);
+                hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), strength), 8);
+                px = _mm_adds_epu8(px, _mm_packus_epi16(lo, hi));
+            }
+            _mm_storeu_si128((__m128i*)(row + x), px);
+        }
+#elif defined(CRT_NEON)
+        const uint8x8_t strength = vdup_n_u8((uint8_t)kBloomStrength);
+        for (; x + 4 <= m_out_w; x += 4) {
+            uint32_t gathered[4] = { glow[map[x]], glow[map[x + 1]], glow[map[x + 2]], glow[map[x + 3]] };
+            uint8x16_t px = vld1q_u8((const uint8_t*)gathered);
+            uint32x4_t w = vld1q_u32(weight + x);
+            uint32x4x2_t wz = vzipq_u32(w, w);
+            uint8x8_t lo = vshrn_n_u16(vmulq_u16(vmovl_u8(vget_low_u8(px)), vreinterpretq_u16_u32(wz.val[0])), 8);
+            uint8x8_t hi = vshrn_n_u16(vmulq_u16(vmovl_u8(vget_high_u8(px)), vreinterpretq_u16_u32(wz.val[1])), 8);
+            px = vcombine_u8(lo, hi);
+            if (use_bloom) {
+                uint32_t b[4] = { bloom[bloom_map[x]], bloom[bloom_map[x + 1]], bloom[bloom_map[x + 2]], bloom[bloom_map[x + 3]] };
+                uint8x16_t bv = vld1q_u8((const uint8_t*)b);
+                lo = vshrn_n_u16(vmull_u8(vget_low_u8(bv), strength), 8);
+                hi = vshrn_n_u16(vmull_u8(vget_high_u8(bv), strength), 8);
+                px = vqaddq_u8(px, vcombine_u8(lo, hi));
+            }
+            vst1q_u8((uint8_t*)(row + x), px);
+        }
+#endif
+        for (; x < m_out_w; ++x) {
+            uint32_t px = Scale(glow[map[x]], weight[x] & 0xffff);
+            if (use_bloom)
+                px = AddSaturate(px, Scale(bloom[bloom_map[x]], kBloomStrength));
+            row[x] = px;
+        }
+    }
+}
+
+void BenchmarkCrt(std::ostream& out, int out_w, int out_h)
+{
+    //two screens of 80x25 cells of 8x16 pixels with some text-like noise in
+    //them, switched between so the afterglow always has something to do
+    const int src_w = 640, src_h = 400;
+    std::vector<uint32_t> screens[2];
+    uint32_t seed = 12345;
+    for (auto& screen : screens) {
+        screen.resize(src_w * src_h);
+        for (int cy = 0; cy < 25; ++cy) {
+            for (int cx = 0; cx < 80; ++cx) {
+                seed = seed * 1103515245 + 12345;
+                bool lit = (seed >> 16) % 3 == 0;
+                uint32_t color = 0xff000000 | (seed & 0x00ffffff) | 0x404040;
+                for (int y = 0; y < 16; ++y) {
+                    for (int x = 0; x < 8; ++x) {
+                        seed = seed * 1103515245 + 12345;
+                        bool on = lit && (seed >> 16) % 2 == 0;
+                        screen[(cy * 16 + y) * src_w + cx * 8 + x] = on ? color : 0xff000000;
+                    }
+                }
+            }
+        }
+    }
+    std::vector<uint32_t> output(out_w * out_h);
+
+    struct Effect
+    {
+        const char* name;
+        CrtOptions options;
+    };
+    std::vector<Effect> effects(6);
+    effects[0].name = "scale only";
+    effects[1].name = "scanlines";
+    effects[1].options.scanlines = true;
+    effects[2].name = "persistence";
+    effects[2].options.persistence = true;
+    effects[3].name = "bloom";
+    effects[3].options.bloom = true;
+    effects[4].name = "curvature";
+    effects[4].options.curvature = true;
+    effects[5].name = "all";
+    effects[5].options = ParseCrtOptions("true");
+
+    int cores = std::max(1, (int)std::thread::hardware_concurrency());
+    const int kWarmup = 10;
+    const int kFrames = 120;
+
+    out << src_w << "x" << src_h << " to " << out_w << "x" << out_h << ", ms per frame" << std::endl;
+    out << std::left << std::setw(14) << "effect" << std::setw(12) << "1 thread" << cores << " threads" << std::endl;
+    for (const Effect& effect : effects) {
+        out << std::left << std::setw(14) << effect.name;
+        for (int threads : { 1, cores }) {
+            CrtFilter filter(effect.options, threads);
+            for (int i = 0; i < kWarmup; ++i)
+                filter.Process(screens[i % 2].data(), src_w, src_h, output.data(), out_w, out_h, out_w * 4);
+
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < kFrames; ++i)
+                filter.Process(screens[i % 2].data(), src_w, src_h, output.data(), out_w, out_h, out_w * 4);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+            std::ostringstream ms;
+            ms << std::fixed << std::setprecision(2) << elapsed.count() / kFrames;
+            out << std::setw(12) << ms.str();
+        }
+        out << std::endl;
+    }
+}
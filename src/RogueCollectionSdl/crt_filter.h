@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct CrtOptions
+{
+    bool scanlines = false;
+    bool persistence = false;  //phosphor afterglow
+    bool bloom = false;
+    bool curvature = false;
+
+    bool Enabled() const;
+};
+
+//Reads the crt option: true for every effect, or a comma separated list of
+//scanlines, persistence, bloom and curvature
+CrtOptions ParseCrtOptions(const std::string& value);
+
+struct CrtWorkers;
+
+//A software take on the screen effects Retro Rogue draws with shaders, so the
+//SDL build can have them without a GPU.  The game's screen goes in at its own
+//resolution as XRGB8888 and comes out scaled to the window with the effects
+//applied.  Rows are split into bands across a pool of threads, and the inner
+//loops use SSE2 or NEON when the compiler has them.
+struct CrtFilter
+{
+    explicit CrtFilter(const CrtOptions& options, int threads = 0);
+    ~CrtFilter();
+
+    void Process(const uint32_t* src, int src_w, int src_h, uint32_t* out, int out_w, int out_h, int out_pitch);
+
+    //If earlier frames are still fading out, so Process should be called
+    //again even when the screen hasn't changed
+    bool Fading() const;
+
+private:
+    void Resize(int src_w, int src_h, int out_w, int out_h);
+    void Glow(const uint32_t* src, int begin, int end);
+    void Downsample(int begin, int end);
+    void Blur();
+    void Remap(uint32_t* out, int out_pitch, int begin, int end);
+    int Bands(int rows) const;
+
+    CrtOptions m_options;
+    std::unique_ptr<CrtWorkers> m_workers;
+    int m_src_w = 0;
+    int m_src_h = 0;
+    int m_out_w = 0;
+    int m_out_h = 0;
+    int m_bloom_w = 0;
+    int m_bloom_h = 0;
+
+    //each ends with a black pixel that everything off the screen maps to
+    std::vector<uint32_t> m_glow;   //the frame with the afterglow of earlier ones
+    std::vector<uint32_t> m_bloom;  //blurred, at a quarter of the resolution
+    std::vector<uint32_t> m_blur;
+
+    //for every output pixel, where it comes from and how bright its scanline is
+    std::vector<int32_t> m_map;
+    std::vector<int32_t> m_bloom_map;
+    std::vector<uint32_t> m_weight;  //0-256, in both halves so a pixel's channels can share it
+
+    std::atomic<bool> m_fading;
+};
+
+//Times each effect on a made up screen scaled to the given size, with one
+//thread and with all of them, and prints the milliseconds per frame
+void BenchmarkCrt(std::ostream& out, int out_w, int out_h);
@@ -76,6 +76,14 @@ void Environment::ApplyArgs(const Args& args)
         Set("replay_paused", "true");
     if (!args.pause_at.empty())
         Set("replay_pause_at", args.pause_at);
+    if (!args.record_path.empty())
+        Set("record", args.record_path);
+    if (!args.play_path.empty())
+        Set("play", args.play_path);
+    if (!args.export_path.empty())
+        Set("export", args.export_path);
+    if (!args.watch_path.empty())
+        Set("watch", args.watch_path);
 }
 
 void Environment::Deserialize(std::istream& in)
@@ -162,10 +170,9 @@ bool Environment::Fullscreen() const
     return Get("fullscreen", &value) && value == "true";
 }
 
-bool Environment::WriteToOs(bool for_unix)
+std::string Environment::RogueOpts(bool for_unix) const
 {
     std::ostringstream ss;
-    ss << "ROGUEOPTS=";
     for (auto i = m_environment.begin(); i != m_environment.end(); ++i)
     {
         if (for_unix)
@@ -173,6 +180,13 @@ bool Environment::WriteToOs(bool for_unix)
         else
             WriteEnvPc(ss, i->first, i->second);
     }
+    return ss.str();
+}
+
+bool Environment::WriteToOs(bool for_unix)
+{
+    std::ostringstream ss;
+    ss << "ROGUEOPTS=" << RogueOpts(for_unix);
     if (_putenv(ss.str().c_str()) != 0)
         return false;
 
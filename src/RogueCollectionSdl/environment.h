@@ -25,6 +25,8 @@ struct Environment
     int WindowScaling() const;
     bool Fullscreen() const;
 
+    //The options as the game reads them from ROGUEOPTS
+    std::string RogueOpts(bool for_unix) const;
     bool WriteToOs(bool for_unix);
     void Serialize(std::ostream& file);
     void Deserialize(std::istream& in);
@@ -3,13 +3,14 @@
 #include "game_select.h"
 #include "environment.h"
 #include "sdl_utility.h"
+#include "asset_cache.h"
 
 GameSelect::GameSelect(SDL_Window * window, SDL_Renderer* renderer, const std::vector<GameConfig>& options, Environment* current_env) :
     m_window(window), 
     m_renderer(renderer),
     m_options(options), 
     m_font(LoadFont(GetResourcePath("fonts")+"Px437_IBM_BIOS.ttf", 16)),
-    m_logo(LoadImage(GetResourcePath("") + "title3.png", renderer)),
+    m_logo(CreateTexture(AssetCache::Instance().Image(GetResourcePath("") + "title3.png").get(), renderer)),
     m_current_env(current_env),
     m_sizer(window, renderer, current_env)
 {
@@ -141,7 +142,7 @@ TitleScreen::TitleScreen(SDL_Window * window, SDL_Renderer * renderer, const std
     m_window(window),
     m_renderer(renderer),
     m_sizer(window, renderer, current_env),
-    m_title_screen(LoadImage(GetResourcePath("") + "epyx.png", renderer))
+    m_title_screen(CreateTexture(AssetCache::Instance().Image(GetResourcePath("") + "epyx.png").get(), renderer))
 {
 }
 
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include "gif_encoder.h"
+
+namespace
+{
+    const int kMaxCode = 4095;
+    const int kHashSize = 5003;
+
+    void PutShort(std::string* out, int n)
+    {
+        out->push_back(char(n & 0xff));
+        out->push_back(char((n >> 8) & 0xff));
+    }
+
+    //Packs variable length codes into the 255 byte sub-blocks GIF expects
+    struct CodeWriter
+    {
+        CodeWriter(std::string* out) : m_out(out) {}
+
+        void Write(int code, int size)
+        {
+            m_acc |= uint32_t(code) << m_bits;
+            m_bits += size;
+            while (m_bits >= 8) {
+                PutByte(m_acc & 0xff);
+                m_acc >>= 8;
+                m_bits -= 8;
+            }
+        }
+
+        void Finish()
+        {
+            if (m_bits > 0)
+                PutByte(m_acc & 0xff);
+            FlushBlock();
+            m_out->push_back(0);
+        }
+
+    private:
+        void PutByte(uint32_t b)
+        {
+            m_block[m_block_size++] = (char)b;
+            if (m_block_size == 255)
+                FlushBlock();
+        }
+
+        void FlushBlock()
+        {
+            if (!m_block_size)
+                return;
+            m_out->push_back((char)m_block_size);
+            m_out->append(m_block, m_block_size);
+            m_block_size = 0;
+        }
+
+        std::string* m_out;
+        uint32_t m_acc = 0;
+        int m_bits = 0;
+        char m_block[255];
+        int m_block_size = 0;
+    };
+
+    void CompressLzw(const std::vector<uint8_t>& indices, int min_code_size, std::string* out)
+    {
+        const int clear = 1 << min_code_size;
+        const int eoi = clear + 1;
+
+        //(prefix, next index) -> code, open addressed as in Unix compress
+        std::vector<int32_t> keys(kHashSize);
+        std::vector<uint16_t> codes(kHashSize);
+        auto reset = [&]() { std::fill(keys.begin(), keys.end(), -1); };
+
+        CodeWriter writer(out);
+        int code_size = min_code_size + 1;
+        int max_code = eoi;
+        reset();
+        writer.Write(clear, code_size);
+
+        int prefix = indices[0];
+        for (size_t i = 1; i < indices.size(); ++i) {
+            int k = indices[i];
+            int32_t key = (prefix << 8) | k;
+            int h = key % kHashSize;
+            while (keys[h] != -1 && keys[h] != key) {
+                if (++h == kHashSize)
+                    h = 0;
+            }
+            if (keys[h] == key) {
+                prefix = codes[h];
+                continue;
+            }
+
+            writer.Write(prefix, code_size);
+            keys[h] = key;
+            codes[h] = (uint16_t)++max_code;
+            if (max_code >= (1 << code_size))
+                ++code_size;
+            if (max_code == kMaxCode) {
+                writer.Write(clear, code_size);
+                reset();
+                code_size = min_code_size + 1;
+                max_code = eoi;
+            }
+            prefix = k;
+        }
+        writer.Write(prefix, code_size);
+        //the decoder adds one more entry when it reads the last code
+        if (max_code + 1 >= (1 << code_size))
+            ++code_size;
+        writer.Write(eoi, code_size);
+        writer.Finish();
+    }
+
+    //Maps each pixel to a palette entry.  Text modes only use a handful of
+    //colors so the palette is usually exact; busier tile frames fall back to
+    //a fixed 3-3-2 palette.
+    std::vector<uint32_t> BuildPalette(const uint32_t* pixels, int pitch, int x, int y, int w, int h, std::vector<uint8_t>* indices)
+    {
+        std::vector<uint32_t> palette;
+        std::unordered_map<uint32_t, uint8_t> lookup;
+        indices->resize(size_t(w) * h);
+
+        bool exact = true;
+        for (int j = 0; j < h && exact; ++j) {
+            const uint32_t* row = pixels + size_t(y + j) * pitch + x;
+            for (int i = 0; i < w; ++i) {
+                uint32_t c = row[i] & 0xffffff;
+                auto p = lookup.find(c);
+                if (p == lookup.end()) {
+                    if (palette.size() == 256) {
+                        exact = false;
+                        break;
+                    }
+                    p = lookup.insert(std::make_pair(c, (uint8_t)palette.size())).first;
+                    palette.push_back(c);
+                }
+                (*indices)[size_t(j) * w + i] = p->second;
+            }
+        }
+        if (exact)
+            return palette;
+
+        palette.resize(256);
+        for (int i = 0; i < 256; ++i) {
+            uint32_t r = ((i >> 5) & 7) * 255 / 7;
+            uint32_t g = ((i >> 2) & 7) * 255 / 7;
+            uint32_t b = (i & 3) * 255 / 3;
+            palette[i] = (r << 16) | (g << 8) | b;
+        }
+        for (int j = 0; j < h; ++j) {
+            const uint32_t* row = pixels + size_t(y + j) * pitch + x;
+            for (int i = 0; i < w; ++i) {
+                uint32_t c = row[i];
+                (*indices)[size_t(j) * w + i] = uint8_t(((c >> 16) & 0xe0) | ((c >> 11) & 0x1c) | ((c >> 6) & 0x03));
+            }
+        }
+        return palette;
+    }
+}
+
+void WriteGifHeader(std::ostream& out, Coord size)
+{
+    std::string header("GIF89a");
+    PutShort(&header, size.x);
+    PutShort(&header, size.y);
+    header.push_back(0); //no global color table
+    header.push_back(0); //background color
+    header.push_back(0); //pixel aspect ratio
+    out.write(header.data(), header.size());
+}
+
+void WriteGifTrailer(std::ostream& out)
+{
+    out.put(0x3b);
+}
+
+void EncodeGifFrame(const uint32_t* pixels, int pitch, int x, int y, int w, int h, int delay, std::string* out)
+{
+    std::vector<uint8_t> indices;
+    std::vector<uint32_t> palette = BuildPalette(pixels, pitch, x, y, w, h, &indices);
+
+    int bits = 1;
+    while ((1 << bits) < (int)palette.size())
+        ++bits;
+
+    //graphic control extension: keep the previous frame, no transparency
+    out->push_back('\x21');
+    out->push_back('\xf9');
+    out->push_back(4);
+    out->push_back(1 << 2);
+    PutShort(out, std::min(delay, 0xffff));
+    out->push_back(0);
+    out->push_back(0);
+
+    //image descriptor with a local color table
+    out->push_back('\x2c');
+    PutShort(out, x);
+    PutShort(out, y);
+    PutShort(out, w);
+    PutShort(out, h);
+    out->push_back(char(0x80 | (bits - 1)));
+    for (int i = 0; i < (1 << bits); ++i) {
+        uint32_t c = i < (int)palette.size() ? palette[i] : 0;
+        out->push_back(char((c >> 16) & 0xff));
+        out->push_back(char((c >> 8) & 0xff));
+        out->push_back(char(c & 0xff));
+    }
+
+    int min_code_size = std::max(2, bits);
+    out->push_back((char)min_code_size);
+    CompressLzw(indices, min_code_size, out);
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <coord.h>
+
+//Minimal GIF89a writer.  Each frame is encoded independently with its own
+//color table, so frames can be produced on worker threads and written out in
+//order afterwards.
+void WriteGifHeader(std::ostream& out, Coord size);
+void WriteGifTrailer(std::ostream& out);
+
+//Encodes the w x h rectangle at (x,y) of an 0x00RRGGBB image as one frame.
+//pitch is in pixels and delay is in hundredths of a second.
+void EncodeGifFrame(const uint32_t* pixels, int pitch, int x, int y, int w, int h, int delay, std::string* out);
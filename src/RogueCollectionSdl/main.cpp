@@ -1,3 +1,4 @@
+#include <iostream>
 #include <memory>
 #include <thread>
 #include <fstream>
@@ -6,6 +7,9 @@
 #include <input_interface.h>
 #include <display_interface.h>
 #include "sdl_rogue.h"
+#include "sdl_player.h"
+#include "tiled_viewer.h"
+#include "replay_exporter.h"
 #include "text_provider.h"
 #include "tile_provider.h"
 #include "game_select.h"
@@ -14,12 +18,22 @@
 #include "game_config.h"
 #include "run_game.h"
 #include "args.h"
+#include "asset_cache.h"
+#include "startup_timeline.h"
+#include "crt_filter.h"
 
 int main(int argc, char** argv)
 {
+    MarkStartup("main");
     Args args(argc, argv);
     std::shared_ptr<Environment> current_env(new Environment(args));
     InitGameConfig(current_env.get());
+    MarkStartup("options read");
+
+    if (args.crt_benchmark) {
+        BenchmarkCrt(std::cout, 1920, 1080);
+        return 0;
+    }
     
     int i = -1;
     std::string replay_path;
@@ -40,6 +54,20 @@ int main(int argc, char** argv)
     SDL::Scoped::Renderer renderer(nullptr, SDL_DestroyRenderer);
     std::shared_ptr<SdlRogue> sdl_rogue;
     try {
+        std::string export_path;
+        current_env->Get("export", &export_path);
+        if (!export_path.empty()) {
+            //render offscreen without creating a window
+            if (replay_path.empty())
+                throw_error("A save file is required to export a replay");
+            if (TTF_Init() != 0)
+                throw_error("TTF_Init");
+
+            ExportReplay(current_env, replay_path, export_path, argc, argv);
+            SDL_Quit();
+            return 0;
+        }
+
         if (SDL_Init(SDL_INIT_VIDEO) != 0) {
             throw_error("SDL_Init");
         }
@@ -47,6 +75,10 @@ int main(int argc, char** argv)
         if (TTF_Init() != 0) {
             throw_error("TTF_Init");
         }
+        MarkStartup("SDL started");
+
+        //decode while the window is made and the menus are up
+        AssetCache::Instance().Preload(s_options);
         
         Coord window_size = GetScaledCoord({ kWindowWidth, kWindowHeight }, current_env->WindowScaling());
         window = SDL::Scoped::Window(SDL_CreateWindow(SdlRogue::kWindowTitle, 100, 100, window_size.x, window_size.y, SDL_WINDOW_ALLOW_HIGHDPI | SDL_WINDOW_SHOWN), SDL_DestroyWindow);
@@ -63,12 +95,19 @@ int main(int argc, char** argv)
         {
             SetFullscreen(window.get(), true);
         }
+        MarkStartup("window created");
+
+        std::string recording_path;
+        current_env->Get("play", &recording_path);
+        std::string watch_path;
+        current_env->Get("watch", &watch_path);
 
-        if (i == -1 && replay_path.empty()) {
+        if (i == -1 && replay_path.empty() && recording_path.empty() && watch_path.empty()) {
             GameSelect select(window.get(), renderer.get(), s_options, current_env.get());
             auto selection = select.GetSelection();
             i = selection.first;
             replay_path = selection.second;
+            MarkStartup("game chosen");
         }
 
         if (i >= 0 && s_options[i].name == "PC Rogue 1.48") {
@@ -80,6 +119,7 @@ int main(int argc, char** argv)
                     i = -1;
                     replay_path.clear();
                 }
+                MarkStartup("title screen closed");
             }
         }
 
@@ -91,12 +131,21 @@ int main(int argc, char** argv)
         }
 
         if (sdl_rogue) {
+            MarkStartup("game display ready");
             //start rogue engine on a background thread
             std::thread rogue(RunGame<SdlRogue>, sdl_rogue->Options().dll_name, argc, argv, sdl_rogue.get());
             rogue.detach();
 
             sdl_rogue->Run();
         }
+        else if (!recording_path.empty()) {
+            SdlPlayer player(window.get(), renderer.get(), current_env, recording_path);
+            player.Run();
+        }
+        else if (!watch_path.empty()) {
+            TiledViewer viewer(window.get(), renderer.get(), current_env, watch_path);
+            viewer.Run();
+        }
     }
     catch (const std::runtime_error& e)
     {
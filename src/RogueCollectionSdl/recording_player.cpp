@@ -0,0 +1,429 @@
+#include <cstring>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <display_interface.h>
+#include "recording_player.h"
+#include "utility.h"
+
+namespace
+{
+    const double kMinSpeed = 1.0 / 16;
+    const double kMaxSpeed = 64.0;
+    const size_t kBlockHeaderSize = 4 * sizeof(uint32_t);
+    const size_t kTrailerSize = sizeof(uint64_t) + 4;
+
+    std::string FormatTime(uint32_t ms)
+    {
+        uint32_t s = ms / 1000;
+        std::ostringstream ss;
+        ss << s / 60 << ":" << std::setw(2) << std::setfill('0') << s % 60;
+        return ss.str();
+    }
+}
+
+RecordingReader::RecordingReader(const std::string& path) :
+    m_file(path, std::ios::binary | std::ios::in)
+{
+    if (!m_file)
+        throw_error("Couldn't open recording: " + path);
+
+    char magic[4];
+    m_file.read(magic, 4);
+    if (!m_file || memcmp(magic, kRecordingMagic, 4) != 0)
+        throw_error("This file is not a Rogue Collection recording: " + path);
+
+    unsigned char version;
+    Read(m_file, &version);
+    if (version > kRecordingVersion)
+        throw_error("This recording was made with a newer version of Rogue Collection.  Please download the latest version and try again.");
+
+    ReadShortString(m_file, &m_game_name);
+    uint16_t cols = 0, lines = 0;
+    Read(m_file, &cols);
+    Read(m_file, &lines);
+    m_dimensions = { cols, lines };
+    if (!m_file || cols == 0 || lines == 0)
+        throw_error("Corrupt recording header: " + path);
+
+    m_data_offset = (uint64_t)m_file.tellg();
+    m_scan_offset = m_data_offset;
+    m_file.seekg(0, std::ios::end);
+    m_file_size = (uint64_t)m_file.tellg();
+
+    m_finished = ReadIndex();
+    if (!m_finished)
+        ScanIndex();
+    if (m_index.empty())
+        throw_error("Recording is empty: " + path);
+
+    std::vector<RecordingFrame> frames;
+    ReadBlock(BlockCount() - 1, &frames);
+}
+
+bool RecordingReader::Refresh()
+{
+    m_file.clear();
+    m_file.seekg(0, std::ios::end);
+    uint64_t size = (uint64_t)m_file.tellg();
+    if (size == m_file_size)
+        return true;
+    //a finished recording never changes, and one being made only grows
+    if (m_finished || size < m_file_size)
+        return false;
+
+    //a new game writes a different first block
+    uint32_t first_time = 0, frame_count = 0;
+    m_file.seekg(m_index.front().offset);
+    Read(m_file, &first_time);
+    Read(m_file, &frame_count);
+    if (!m_file || first_time != m_index.front().first_time || frame_count != m_index.front().frame_count) {
+        m_file.clear();
+        return false;
+    }
+
+    m_file_size = size;
+    std::vector<RecordingBlockInfo> scanned;
+    scanned.swap(m_index);
+    m_finished = ReadIndex();
+    if (!m_finished) {
+        m_index.swap(scanned);
+        ScanIndex();
+    }
+    return true;
+}
+
+bool RecordingReader::ReadIndex()
+{
+    if (m_file_size < m_data_offset + kTrailerSize)
+        return false;
+
+    uint64_t index_offset = 0;
+    char magic[4];
+    m_file.seekg(m_file_size - kTrailerSize);
+    Read(m_file, &index_offset);
+    m_file.read(magic, 4);
+    if (!m_file || memcmp(magic, kRecordingIndexMagic, 4) != 0 || index_offset >= m_file_size) {
+        m_file.clear();
+        return false;
+    }
+
+    uint32_t count = 0;
+    m_file.seekg(index_offset);
+    Read(m_file, &count);
+    for (uint32_t i = 0; i < count && m_file; ++i) {
+        RecordingBlockInfo info;
+        Read(m_file, &info.offset);
+        Read(m_file, &info.first_frame);
+        Read(m_file, &info.first_time);
+        Read(m_file, &info.frame_count);
+        m_index.push_back(info);
+    }
+    if (!m_file) {
+        m_file.clear();
+        m_index.clear();
+        return false;
+    }
+    return true;
+}
+
+void RecordingReader::ScanIndex()
+{
+    uint64_t offset = m_scan_offset;
+    uint32_t frame = m_index.empty() ? 0 : m_index.back().first_frame + m_index.back().frame_count;
+
+    while (offset + kBlockHeaderSize <= m_file_size) {
+        RecordingBlockInfo info;
+        uint32_t raw_size = 0, packed_size = 0;
+
+        m_file.clear();
+        m_file.seekg(offset);
+        Read(m_file, &info.first_time);
+        Read(m_file, &info.frame_count);
+        Read(m_file, &raw_size);
+        Read(m_file, &packed_size);
+        if (!m_file || info.frame_count == 0 || info.frame_count > ScreenRecorder::kFramesPerBlock)
+            break;
+        //a partially written block is dropped
+        if (offset + kBlockHeaderSize + packed_size > m_file_size)
+            break;
+
+        info.offset = offset;
+        info.first_frame = frame;
+        m_index.push_back(info);
+
+        frame += info.frame_count;
+        offset += kBlockHeaderSize + packed_size;
+    }
+    m_scan_offset = offset;
+    m_file.clear();
+}
+
+const std::string & RecordingReader::GameName() const
+{
+    return m_game_name;
+}
+
+Coord RecordingReader::Dimensions() const
+{
+    return m_dimensions;
+}
+
+uint32_t RecordingReader::FrameCount() const
+{
+    return m_index.back().first_frame + m_index.back().frame_count;
+}
+
+uint32_t RecordingReader::Duration() const
+{
+    return m_duration;
+}
+
+int RecordingReader::BlockCount() const
+{
+    return (int)m_index.size();
+}
+
+int RecordingReader::FindBlock(uint32_t time) const
+{
+    auto i = std::upper_bound(m_index.begin(), m_index.end(), time, [](uint32_t t, const RecordingBlockInfo& info) {
+        return t < info.first_time;
+    });
+    if (i == m_index.begin())
+        return 0;
+    return (int)(i - m_index.begin()) - 1;
+}
+
+bool RecordingReader::ReadBlock(int i, std::vector<RecordingFrame>* frames)
+{
+    frames->clear();
+    if (i < 0 || i >= BlockCount())
+        return false;
+
+    const RecordingBlockInfo& info = m_index[i];
+    uint32_t first_time, frame_count, raw_size, packed_size;
+    m_file.clear();
+    m_file.seekg(info.offset);
+    Read(m_file, &first_time);
+    Read(m_file, &frame_count);
+    Read(m_file, &raw_size);
+    Read(m_file, &packed_size);
+    if (!m_file || frame_count != info.frame_count)
+        return false;
+
+    std::vector<unsigned char> packed(packed_size);
+    m_file.read((char*)packed.data(), packed_size);
+    if (!m_file)
+        return false;
+
+    std::vector<unsigned char> raw;
+    if (!DecompressBlock(packed.data(), packed.size(), raw_size, &raw))
+        return false;
+
+    RecordingFrame frame;
+    frames->reserve(frame_count);
+    if (!DecodeBlock(raw, frame_count, m_dimensions, &frame, frames))
+        return false;
+    if (!frames->empty())
+        m_duration = std::max(m_duration, frames->back().time);
+    return true;
+}
+
+RecordingPlayer::RecordingPlayer(RecordingReader* reader, DisplayInterface* display) :
+    m_reader(reader),
+    m_display(display)
+{
+}
+
+void RecordingPlayer::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    size_t next = 0;
+
+    while (!m_stop)
+    {
+        if (m_seek_pending) {
+            m_seek_pending = false;
+            m_position = std::min(m_seek_target, m_reader->Duration());
+            if (!LoadBlock(m_reader->FindBlock(m_position)))
+                break;
+
+            auto i = std::upper_bound(m_frames.begin(), m_frames.end(), m_position, [](uint32_t t, const RecordingFrame& f) {
+                return t < f.time;
+            });
+            next = std::max<size_t>(i - m_frames.begin(), 1);
+            Present(m_frames[next - 1], true);
+            continue;
+        }
+
+        if (next >= m_frames.size()) {
+            if (m_block + 1 >= m_reader->BlockCount()) {
+                m_paused = true;
+            }
+            else if (LoadBlock(m_block + 1)) {
+                next = 0;
+            }
+            else {
+                break;
+            }
+        }
+
+        if (m_paused) {
+            m_cv.wait(lock);
+            continue;
+        }
+
+        const RecordingFrame& frame = m_frames[next];
+        if (frame.time > m_position) {
+            double speed = m_speed;
+            auto begin = std::chrono::steady_clock::now();
+            auto delay = std::chrono::milliseconds((long long)((frame.time - m_position) / speed));
+            bool interrupted = m_cv.wait_until(lock, begin + delay, [this, speed] {
+                return m_stop || m_paused || m_seek_pending || m_speed != speed;
+            });
+
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+            m_position = std::min(frame.time, m_position + (uint32_t)(elapsed * speed));
+            if (interrupted)
+                continue;
+        }
+
+        m_position = frame.time;
+        Present(frame, false);
+        ++next;
+    }
+}
+
+void RecordingPlayer::Stop()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+    m_cv.notify_all();
+}
+
+void RecordingPlayer::TogglePause()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_paused = !m_paused;
+    if (!m_paused && m_position >= m_reader->Duration()) {
+        //restart from the beginning if we're at the end
+        m_seek_pending = true;
+        m_seek_target = 0;
+    }
+    m_cv.notify_all();
+}
+
+void RecordingPlayer::IncreaseSpeed()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_speed = std::min(m_speed * 2, kMaxSpeed);
+    m_cv.notify_all();
+}
+
+void RecordingPlayer::DecreaseSpeed()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_speed = std::max(m_speed / 2, kMinSpeed);
+    m_cv.notify_all();
+}
+
+void RecordingPlayer::SeekTo(uint32_t time)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_seek_pending = true;
+    m_seek_target = time;
+    m_cv.notify_all();
+}
+
+void RecordingPlayer::SeekRelative(int ms)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    long long target = (long long)m_position + ms;
+    m_seek_pending = true;
+    m_seek_target = (uint32_t)std::max(0ll, target);
+    m_cv.notify_all();
+}
+
+bool RecordingPlayer::GetStatusText(std::string* text)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::ostringstream ss;
+    if (m_paused)
+        ss << "Paused ";
+    else
+        ss << "Playing x" << m_speed << " ";
+    ss << FormatTime(m_position) << "/" << FormatTime(m_reader->Duration());
+    *text = ss.str();
+    return true;
+}
+
+bool RecordingPlayer::LoadBlock(int i)
+{
+    if (i == m_block)
+        return true;
+    if (!m_reader->ReadBlock(i, &m_frames) || m_frames.empty())
+        return false;
+    m_block = i;
+    return true;
+}
+
+void RecordingPlayer::Present(const RecordingFrame& frame, bool full)
+{
+    m_screen = frame.data;
+    if (full) {
+        m_display->UpdateRegion(m_screen.data());
+    }
+    else if (frame.changed.Right >= frame.changed.Left) {
+        m_display->UpdateRegion(m_screen.data(), frame.changed);
+    }
+    m_display->MoveCursor(frame.cursor_pos);
+    m_display->SetCursor(frame.show_cursor);
+}
+
+RecordingFollower::RecordingFollower(const std::string& path, DisplayInterface* display) :
+    m_path(path),
+    m_display(display)
+{
+}
+
+bool RecordingFollower::Poll()
+{
+    if (m_reader && !m_reader->Refresh())
+        m_reader.reset();
+
+    bool opened = false;
+    if (!m_reader) {
+        //not started yet, or only the header is written so far
+        try {
+            m_reader.reset(new RecordingReader(m_path));
+        }
+        catch (const std::runtime_error&) {
+            return false;
+        }
+        m_block = -1;
+        m_display->SetDimensions(m_reader->Dimensions());
+        opened = true;
+    }
+
+    //every block starts with the whole screen, so only the last one is read
+    int last = m_reader->BlockCount() - 1;
+    if (last != m_block && m_reader->ReadBlock(last, &m_frames) && !m_frames.empty()) {
+        m_block = last;
+        RecordingFrame& frame = m_frames.back();
+        m_display->UpdateRegion(frame.data.data());
+        m_display->MoveCursor(frame.cursor_pos);
+        m_display->SetCursor(frame.show_cursor);
+    }
+    return opened;
+}
+
+const std::string& RecordingFollower::Path() const
+{
+    return m_path;
+}
+
+const std::string& RecordingFollower::GameName() const
+{
+    return m_reader->GameName();
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "screen_recorder.h"
+
+struct DisplayInterface;
+
+//Reads the screen recordings written by ScreenRecorder
+struct RecordingReader
+{
+    RecordingReader(const std::string& path);
+
+    const std::string& GameName() const;
+    Coord Dimensions() const;
+    uint32_t FrameCount() const;
+    uint32_t Duration() const;
+
+    int BlockCount() const;
+    //Returns the block containing the frame shown at the given time
+    int FindBlock(uint32_t time) const;
+    bool ReadBlock(int i, std::vector<RecordingFrame>* frames);
+
+    //Picks up the blocks written since the file was opened, if it's still
+    //being recorded.  Returns false if it has been started over since.
+    bool Refresh();
+
+private:
+    bool ReadIndex();
+    void ScanIndex();
+
+    std::ifstream m_file;
+    std::string m_game_name;
+    Coord m_dimensions = { 0, 0 };
+    uint64_t m_data_offset = 0;
+    uint64_t m_file_size = 0;
+    uint64_t m_scan_offset = 0;  //where the next block will be written, while there's no index
+    bool m_finished = false;     //the index is written, so nothing more is coming
+    uint32_t m_duration = 0;
+    std::vector<RecordingBlockInfo> m_index;
+};
+
+//Plays a recording back to a display.  Run() is called on a background
+//thread, and the remaining methods may be called from any thread.
+struct RecordingPlayer
+{
+    RecordingPlayer(RecordingReader* reader, DisplayInterface* display);
+
+    void Run();
+    void Stop();
+
+    void TogglePause();
+    void IncreaseSpeed();
+    void DecreaseSpeed();
+    void SeekTo(uint32_t time);
+    void SeekRelative(int ms);
+
+    bool GetStatusText(std::string* text);
+
+private:
+    bool LoadBlock(int i);
+    void Present(const RecordingFrame& frame, bool full);
+
+    RecordingReader* m_reader;
+    DisplayInterface* m_display;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+    bool m_paused = false;
+    bool m_seek_pending = true;
+    uint32_t m_seek_target = 0;
+    double m_speed = 1.0;
+    uint32_t m_position = 0;
+
+    int m_block = -1;
+    std::vector<RecordingFrame> m_frames;
+    std::vector<uint32_t> m_screen;
+};
+
+//Shows the latest screen of a recording that is still being made, for
+//watching a game live.  Poll() is called every so often from one background
+//thread.  The recording doesn't have to exist yet, and if it's started over
+//for a new game, the new game is followed.
+struct RecordingFollower
+{
+    RecordingFollower(const std::string& path, DisplayInterface* display);
+
+    //Returns true if a recording was opened, after SetDimensions has been sent
+    bool Poll();
+
+    const std::string& Path() const;
+    const std::string& GameName() const;
+
+private:
+    std::string m_path;
+    DisplayInterface* m_display;
+    std::unique_ptr<RecordingReader> m_reader;
+    int m_block = -1;
+    std::vector<RecordingFrame> m_frames;
+};
@@ -0,0 +1,450 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+#include <SDL.h>
+#include "replay_exporter.h"
+#include "screen_renderer.h"
+#include "gif_encoder.h"
+#include "sdl_rogue.h"
+#include "sdl_utility.h"
+#include "environment.h"
+#include "run_game.h"
+
+namespace
+{
+    //how long the last screen stays up at the end of a GIF
+    const uint32_t kFinalFrameDelay = 2000;
+
+    SDL::Scoped::Surface CreateFrameSurface(Coord size)
+    {
+        SDL::Scoped::Surface surface(SDL_CreateRGBSurface(0, size.x, size.y, 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0), SDL_FreeSurface);
+        if (!surface)
+            throw_error("SDL_CreateRGBSurface");
+        return surface;
+    }
+
+    SDL::Scoped::Renderer CreateSoftwareRenderer(SDL_Surface* surface)
+    {
+        SDL::Scoped::Renderer renderer(SDL_CreateSoftwareRenderer(surface), SDL_DestroyRenderer);
+        if (!renderer)
+            throw_error("SDL_CreateSoftwareRenderer");
+        return renderer;
+    }
+
+    bool HasExtension(std::string path, const std::string& ext)
+    {
+        std::transform(path.begin(), path.end(), path.begin(), [](char c) { return (char)tolower(c); });
+        return path.size() >= ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0;
+    }
+
+    bool Contains(Region r, Coord p)
+    {
+        return p.x >= r.Left && p.x <= r.Right && p.y >= r.Top && p.y <= r.Bottom;
+    }
+
+    void Include(Region* r, Coord p)
+    {
+        if (r->Right < r->Left) {
+            *r = { p.x, p.y, p.x, p.y };
+            return;
+        }
+        r->Left = std::min(r->Left, p.x);
+        r->Top = std::min(r->Top, p.y);
+        r->Right = std::max(r->Right, p.x);
+        r->Bottom = std::max(r->Bottom, p.y);
+    }
+}
+
+//Each worker renders into its own surface with its own copy of the assets, so
+//workers never share SDL state
+struct ExportWorker
+{
+    ExportWorker(Coord size, const GraphicsConfig& cfg, Coord dimensions) :
+        surface(CreateFrameSurface(size)),
+        renderer(CreateSoftwareRenderer(surface.get())),
+        screen(new ScreenRenderer(renderer.get(), cfg, dimensions))
+    {
+    }
+
+    SDL::Scoped::Surface surface;
+    SDL::Scoped::Renderer renderer;
+    std::unique_ptr<ScreenRenderer> screen;
+};
+
+ReplayExporter::ReplayExporter(std::shared_ptr<Environment> current_env, const std::string& savefile, const std::string& output) :
+    m_current_env(current_env),
+    m_game_env(new Environment()),
+    m_output(output),
+    m_gif(HasExtension(output, ".gif"))
+{
+    std::ifstream file(savefile, std::ios::binary | std::ios::in);
+    if (!file) {
+        throw_error("Couldn't open save file: " + savefile);
+    }
+
+    std::string name;
+    uint16_t restore_count;
+    SdlRogue::ReadSaveHeader(file, m_current_env.get(), m_game_env.get(), &name, &restore_count);
+    m_options = s_options[SdlRogue::FindGame(name)];
+    SdlRogue::SetupGameEnv(m_options, m_game_env.get());
+    m_keys.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    std::string value;
+    if (m_current_env->Get("gfx", &value)) {
+        for (int i = 0; i < (int)m_options.gfx_options.size(); ++i)
+        {
+            if (m_options.gfx_options[i].name == value) {
+                m_gfx_mode = i;
+                break;
+            }
+        }
+    }
+    if (m_current_env->Get("export_frame_delay", &value)) {
+        m_frame_delay = std::max(10, atoi(value.c_str()));
+    }
+    m_thread_count = (int)std::thread::hardware_concurrency();
+    if (m_current_env->Get("export_threads", &value)) {
+        m_thread_count = atoi(value.c_str());
+    }
+    m_thread_count = std::max(1, m_thread_count);
+
+    m_dimensions = { m_game_env->Columns(), m_game_env->Lines() };
+    m_screen.resize(TotalChars());
+
+    //load the assets once up front to size the frames and report any errors
+    SDL::Scoped::Surface probe(CreateFrameSurface({ 1, 1 }));
+    SDL::Scoped::Renderer renderer(CreateSoftwareRenderer(probe.get()));
+    m_frame_size = ScreenRenderer(renderer.get(), graphics_cfg(), m_dimensions).ScreenSize();
+}
+
+ReplayExporter::~ReplayExporter()
+{
+}
+
+void ReplayExporter::Run()
+{
+    std::vector<std::unique_ptr<ExportWorker>> workers;
+    for (int i = 0; i < m_thread_count; ++i)
+        workers.emplace_back(new ExportWorker(m_frame_size, graphics_cfg(), m_dimensions));
+
+    std::ofstream file;
+    std::ostream* out = &std::cout;
+    if (m_output == "-") {
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    }
+    else {
+        file.open(m_output, std::ios::binary | std::ios::out);
+        if (!file)
+            throw_error("Couldn't open export file: " + m_output);
+        out = &file;
+    }
+
+    std::cerr << "Exporting " << m_frame_size.x << "x" << m_frame_size.y;
+    if (!m_gif)
+        std::cerr << " rgb24 frames at " << 1000.0 / m_frame_delay << " fps";
+    std::cerr << " on " << m_thread_count << " threads" << std::endl;
+
+    auto begin = std::chrono::steady_clock::now();
+    if (m_gif)
+        WriteGifHeader(*out, m_frame_size);
+
+    std::vector<std::thread> threads;
+    for (auto& worker : workers)
+        threads.emplace_back(&ReplayExporter::RunWorker, this, worker.get());
+
+    int frames = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            m_cv.wait(lock, [this] {
+                return m_encoded.count(m_next_write) || m_next_write == m_total_frames;
+            });
+            if (m_next_write == m_total_frames)
+                break;
+
+            auto i = m_encoded.find(m_next_write);
+            std::pair<std::string, uint32_t> encoded(std::move(i->second));
+            m_encoded.erase(i);
+            ++m_next_write;
+            m_cv.notify_all();
+
+            lock.unlock();
+            WriteFrame(*out, encoded.first, encoded.second);
+            ++frames;
+            lock.lock();
+        }
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    if (m_gif)
+        WriteGifTrailer(*out);
+    out->flush();
+    if (!*out)
+        throw_error("Error writing to file: " + m_output);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+    std::cerr << "Exported " << frames << " frames covering " << m_time / 1000 << "s of play in " << elapsed << "ms" << std::endl;
+}
+
+void ReplayExporter::RunWorker(ExportWorker* worker)
+{
+    for (;;) {
+        std::unique_ptr<ExportFrame> frame;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            //don't get too far ahead of the writer
+            m_cv.wait(lock, [this] {
+                return (!m_queue.empty() && m_queue.front()->index < m_next_write + kMaxQueuedFrames) ||
+                    (m_queue.empty() && m_total_frames >= 0);
+            });
+            if (m_queue.empty())
+                return;
+            frame = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_cv.notify_all();
+        }
+
+        std::string encoded;
+        EncodeFrame(worker, *frame, &encoded);
+
+        uint32_t repeat = 1;
+        if (!m_gif)
+            repeat = (frame->time + frame->duration) / m_frame_delay - frame->time / m_frame_delay;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_encoded[frame->index] = std::make_pair(std::move(encoded), repeat);
+        m_cv.notify_all();
+    }
+}
+
+void ReplayExporter::EncodeFrame(ExportWorker* worker, const ExportFrame& frame, std::string* out)
+{
+    //the worker's surface holds some earlier frame, so raw output needs a
+    //full render while GIF frames only cover the changed cells
+    Region r = m_gif ? frame.changed : FullRegion();
+    worker->screen->RenderRegion(const_cast<uint32_t*>(frame.data.data()), r);
+    if (frame.show_cursor && Contains(r, frame.cursor_pos))
+        worker->screen->RenderCursor(frame.cursor_pos);
+
+    SDL_Surface* surface = worker->surface.get();
+    const uint32_t* pixels = static_cast<const uint32_t*>(surface->pixels);
+    int pitch = surface->pitch / 4;
+
+    if (m_gif) {
+        SDL_Rect topleft = worker->screen->ScreenRegion({ r.Left, r.Top });
+        SDL_Rect bottomright = worker->screen->ScreenRegion({ r.Right, r.Bottom });
+        int w = bottomright.x + bottomright.w - topleft.x;
+        int h = bottomright.y + bottomright.h - topleft.y;
+        int delay = (frame.time + frame.duration) / 10 - frame.time / 10;
+        EncodeGifFrame(pixels, pitch, topleft.x, topleft.y, w, h, delay, out);
+        return;
+    }
+
+    out->resize(size_t(m_frame_size.x) * m_frame_size.y * 3);
+    char* p = &(*out)[0];
+    for (int y = 0; y < m_frame_size.y; ++y) {
+        const uint32_t* row = pixels + size_t(y) * pitch;
+        for (int x = 0; x < m_frame_size.x; ++x) {
+            *p++ = char((row[x] >> 16) & 0xff);
+            *p++ = char((row[x] >> 8) & 0xff);
+            *p++ = char(row[x] & 0xff);
+        }
+    }
+}
+
+void ReplayExporter::WriteFrame(std::ostream& out, const std::string& frame, uint32_t repeat)
+{
+    for (uint32_t i = 0; i < repeat; ++i)
+        out.write(frame.data(), frame.size());
+}
+
+void ReplayExporter::CaptureFrame()
+{
+    if (m_finished || !m_has_screen)
+        return;
+
+    Region changed = { 0, 0, -1, -1 };
+    if (!m_pending) {
+        changed = FullRegion();
+    }
+    else {
+        const ExportFrame& prev = *m_pending;
+        for (int i = 0; i < TotalChars(); ++i) {
+            if (m_screen[i] != prev.data[i])
+                Include(&changed, { i % m_dimensions.x, i / m_dimensions.x });
+        }
+        bool cursor_moved = prev.cursor_pos.x != m_cursor_pos.x || prev.cursor_pos.y != m_cursor_pos.y;
+        if (prev.show_cursor != m_show_cursor || cursor_moved) {
+            if (prev.show_cursor)
+                Include(&changed, prev.cursor_pos);
+            if (m_show_cursor)
+                Include(&changed, m_cursor_pos);
+        }
+        //nothing changed, so the pending frame just stays up longer
+        if (changed.Right < changed.Left)
+            return;
+    }
+
+    if (m_pending) {
+        m_pending->duration = m_time - m_pending->time;
+        PushFrame(std::move(m_pending));
+    }
+
+    m_pending.reset(new ExportFrame);
+    m_pending->index = m_frame_count++;
+    m_pending->time = m_time;
+    m_pending->data = m_screen;
+    m_pending->show_cursor = m_show_cursor;
+    m_pending->cursor_pos = m_cursor_pos;
+    m_pending->changed = changed;
+}
+
+void ReplayExporter::PushFrame(std::unique_ptr<ExportFrame> frame)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_queue.size() < kMaxQueuedFrames; });
+    m_queue.push_back(std::move(frame));
+    m_cv.notify_all();
+}
+
+void ReplayExporter::FinishCapture()
+{
+    if (m_finished)
+        return;
+
+    CaptureFrame();
+    m_finished = true;
+    if (m_pending) {
+        m_pending->duration = m_time - m_pending->time + kFinalFrameDelay;
+        m_time += kFinalFrameDelay;
+        PushFrame(std::move(m_pending));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_total_frames = m_frame_count;
+    m_cv.notify_all();
+}
+
+DisplayInterface* ReplayExporter::Display()
+{
+    return this;
+}
+
+InputInterface* ReplayExporter::Input()
+{
+    return this;
+}
+
+Environment* ReplayExporter::GameEnv() const
+{
+    return m_game_env.get();
+}
+
+GameConfig ReplayExporter::Options() const
+{
+    return m_options;
+}
+
+void ReplayExporter::PostQuit()
+{
+    FinishCapture();
+}
+
+void ReplayExporter::SetDimensions(Coord dimensions)
+{
+}
+
+void ReplayExporter::UpdateRegion(uint32_t* buf)
+{
+    UpdateRegion(buf, FullRegion());
+}
+
+void ReplayExporter::UpdateRegion(uint32_t* buf, Region rect)
+{
+    //the game always passes the whole buffer; the region only says what changed
+    std::copy(buf, buf + TotalChars(), m_screen.begin());
+    m_has_screen = true;
+}
+
+void ReplayExporter::MoveCursor(Coord pos)
+{
+    m_cursor_pos = pos;
+}
+
+void ReplayExporter::SetCursor(bool enable)
+{
+    m_show_cursor = enable;
+}
+
+void ReplayExporter::PlaySound(const std::string& id)
+{
+}
+
+char ReplayExporter::GetChar(bool block, bool for_string, bool *is_replay)
+{
+    if (!m_keys.empty()) {
+        CaptureFrame();
+        m_time += m_frame_delay;
+
+        char c = m_keys.front();
+        m_keys.pop_front();
+        if (is_replay)
+            *is_replay = true;
+        return c;
+    }
+
+    FinishCapture();
+    if (!block)
+        return 0;
+
+    //the replay is over; park the game thread until the process exits
+    for (;;)
+        std::this_thread::sleep_for(std::chrono::hours(1));
+}
+
+void ReplayExporter::Flush()
+{
+}
+
+const GraphicsConfig& ReplayExporter::graphics_cfg() const
+{
+    return m_options.gfx_options[m_gfx_mode];
+}
+
+Region ReplayExporter::FullRegion() const
+{
+    Region r;
+    r.Left = 0;
+    r.Top = 0;
+    r.Right = short(m_dimensions.x - 1);
+    r.Bottom = short(m_dimensions.y - 1);
+    return r;
+}
+
+int ReplayExporter::TotalChars() const
+{
+    return m_dimensions.x * m_dimensions.y;
+}
+
+void ExportReplay(std::shared_ptr<Environment> current_env, const std::string& savefile, const std::string& output, int argc, char** argv)
+{
+    ReplayExporter exporter(current_env, savefile, output);
+
+    //start rogue engine on a background thread
+    std::thread rogue(RunGame<ReplayExporter>, exporter.Options().dll_name, argc, argv, &exporter);
+    rogue.detach();
+
+    exporter.Run();
+}
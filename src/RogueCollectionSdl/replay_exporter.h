@@ -0,0 +1,107 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <display_interface.h>
+#include <input_interface.h>
+#include "game_config.h"
+
+struct Environment;
+struct ExportWorker;
+
+//A distinct screen captured during the replay
+struct ExportFrame
+{
+    int index = 0;
+    uint32_t time = 0;
+    uint32_t duration = 0;
+    std::vector<uint32_t> data;
+    bool show_cursor = false;
+    Coord cursor_pos = { 0, 0 };
+    //cells that differ from the previous frame
+    Region changed = { 0, 0, -1, -1 };
+};
+
+//Replays a save file without a window and writes every distinct screen to an
+//animated GIF, or as raw RGB24 frames for an external encoder.  The game runs
+//at full speed on its own thread, and worker threads render and encode the
+//frames offscreen while the main thread writes them out in order.
+struct ReplayExporter : public DisplayInterface, public InputInterface
+{
+    ReplayExporter(std::shared_ptr<Environment> current_env, const std::string& savefile, const std::string& output);
+    ~ReplayExporter();
+
+    void Run();
+
+    DisplayInterface* Display();
+    InputInterface* Input();
+    Environment* GameEnv() const;
+    GameConfig Options() const;
+    void PostQuit();
+
+    //display interface
+    virtual void SetDimensions(Coord dimensions) override;
+    virtual void UpdateRegion(uint32_t* buf) override;
+    virtual void UpdateRegion(uint32_t* buf, Region rect) override;
+    virtual void MoveCursor(Coord pos) override;
+    virtual void SetCursor(bool enable) override;
+    virtual void PlaySound(const std::string& id) override;
+
+    //input interface
+    virtual char GetChar(bool block, bool for_string, bool *is_replay) override;
+    virtual void Flush() override;
+
+    static const int kDefaultFrameDelay = 100;
+    static const int kMaxQueuedFrames = 256;
+
+private:
+    void CaptureFrame();
+    void PushFrame(std::unique_ptr<ExportFrame> frame);
+    void FinishCapture();
+
+    void RunWorker(ExportWorker* worker);
+    void EncodeFrame(ExportWorker* worker, const ExportFrame& frame, std::string* out);
+    void WriteFrame(std::ostream& out, const std::string& frame, uint32_t duration);
+
+    const GraphicsConfig& graphics_cfg() const;
+    Region FullRegion() const;
+    int TotalChars() const;
+
+    std::shared_ptr<Environment> m_current_env;
+    std::unique_ptr<Environment> m_game_env;
+    GameConfig m_options;
+    int m_gfx_mode = 0;
+    std::string m_output;
+    bool m_gif = true;
+    int m_frame_delay = kDefaultFrameDelay;
+    int m_thread_count = 1;
+
+    Coord m_dimensions = { 0, 0 };
+    Coord m_frame_size = { 0, 0 };
+
+    //game thread state
+    std::deque<unsigned char> m_keys;
+    std::vector<uint32_t> m_screen;
+    bool m_has_screen = false;
+    bool m_show_cursor = false;
+    Coord m_cursor_pos = { 0, 0 };
+    std::unique_ptr<ExportFrame> m_pending;
+    uint32_t m_time = 0;
+    int m_frame_count = 0;
+    bool m_finished = false;
+
+    //shared with the workers and writer
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::unique_ptr<ExportFrame>> m_queue;
+    std::map<int, std::pair<std::string, uint32_t>> m_encoded;
+    int m_next_write = 0;
+    int m_total_frames = -1;
+};
+
+void ExportReplay(std::shared_ptr<Environment> current_env, const std::string& savefile, const std::string& output, int argc, char** argv);
@@ -0,0 +1,419 @@
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+#include "screen_recorder.h"
+#include "utility.h"
+
+namespace
+{
+    const unsigned char kKeyframe = 0x01;
+    const unsigned char kCursorVisible = 0x02;
+
+    const int kMinMatch = 4;
+    const int kHashBits = 12;
+
+    template <typename T>
+    void Append(std::vector<unsigned char>& v, T t)
+    {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(&t);
+        v.insert(v.end(), p, p + sizeof(T));
+    }
+
+    template <typename T>
+    bool Extract(const std::vector<unsigned char>& v, size_t* pos, T* t)
+    {
+        if (*pos + sizeof(T) > v.size())
+            return false;
+        memcpy(t, &v[*pos], sizeof(T));
+        *pos += sizeof(T);
+        return true;
+    }
+
+    void AppendLength(std::vector<unsigned char>& out, size_t n)
+    {
+        while (n >= 255) {
+            out.push_back(255);
+            n -= 255;
+        }
+        out.push_back((unsigned char)n);
+    }
+
+    bool ExtractLength(const unsigned char*& in, const unsigned char* end, size_t* n)
+    {
+        unsigned char b;
+        do {
+            if (in == end)
+                return false;
+            b = *in++;
+            *n += b;
+        } while (b == 255);
+        return true;
+    }
+
+    void AppendSequence(std::vector<unsigned char>& out, const unsigned char* literals, size_t literal_len, size_t offset, size_t match_len)
+    {
+        size_t m = match_len ? match_len - kMinMatch : 0;
+        unsigned char token = (unsigned char)(((literal_len < 15 ? literal_len : 15) << 4) | (m < 15 ? m : 15));
+        out.push_back(token);
+        if (literal_len >= 15)
+            AppendLength(out, literal_len - 15);
+        out.insert(out.end(), literals, literals + literal_len);
+
+        if (match_len) {
+            out.push_back((unsigned char)(offset & 0xff));
+            out.push_back((unsigned char)(offset >> 8));
+            if (m >= 15)
+                AppendLength(out, m - 15);
+        }
+    }
+
+    void ExpandRegion(Region* r, int x, int y)
+    {
+        if (r->Right < r->Left) {
+            r->Left = r->Right = x;
+            r->Top = r->Bottom = y;
+            return;
+        }
+        r->Left = std::min(r->Left, x);
+        r->Right = std::max(r->Right, x);
+        r->Top = std::min(r->Top, y);
+        r->Bottom = std::max(r->Bottom, y);
+    }
+}
+
+std::vector<unsigned char> CompressBlock(const std::vector<unsigned char>& in)
+{
+    std::vector<unsigned char> out;
+    out.reserve(in.size() / 2);
+
+    std::vector<int> table(1 << kHashBits, -1);
+    const size_t n = in.size();
+    size_t anchor = 0;
+    size_t i = 0;
+
+    while (i + kMinMatch <= n) {
+        uint32_t seq;
+        memcpy(&seq, &in[i], sizeof(seq));
+        uint32_t h = (seq * 2654435761u) >> (32 - kHashBits);
+        int ref = table[h];
+        table[h] = (int)i;
+
+        if (ref >= 0 && i - ref <= 0xffff && memcmp(&in[ref], &in[i], kMinMatch) == 0) {
+            size_t len = kMinMatch;
+            while (i + len < n && in[ref + len] == in[i + len])
+                ++len;
+            AppendSequence(out, in.data() + anchor, i - anchor, i - ref, len);
+            i += len;
+            anchor = i;
+        }
+        else {
+            ++i;
+        }
+    }
+
+    //the last sequence is literals only
+    AppendSequence(out, in.data() + anchor, n - anchor, 0, 0);
+    return out;
+}
+
+bool DecompressBlock(const unsigned char* in, size_t size, size_t raw_size, std::vector<unsigned char>* out)
+{
+    const unsigned char* end = in + size;
+    out->clear();
+    out->reserve(raw_size);
+
+    while (in < end) {
+        unsigned char token = *in++;
+
+        size_t literal_len = token >> 4;
+        if (literal_len == 15 && !ExtractLength(in, end, &literal_len))
+            return false;
+        if ((size_t)(end - in) < literal_len)
+            return false;
+        out->insert(out->end(), in, in + literal_len);
+        in += literal_len;
+
+        if (in == end)
+            break;
+
+        if (end - in < 2)
+            return false;
+        size_t offset = in[0] | (in[1] << 8);
+        in += 2;
+        size_t match_len = token & 0x0f;
+        if (match_len == 15 && !ExtractLength(in, end, &match_len))
+            return false;
+        match_len += kMinMatch;
+
+        if (offset == 0 || offset > out->size())
+            return false;
+        //matches may overlap the bytes they produce, so copy one at a time
+        size_t from = out->size() - offset;
+        for (size_t i = 0; i < match_len; ++i)
+            out->push_back((*out)[from + i]);
+    }
+    return out->size() == raw_size;
+}
+
+bool DecodeBlock(const std::vector<unsigned char>& raw, uint32_t frame_count, Coord dimensions, RecordingFrame* frame, std::vector<RecordingFrame>* frames)
+{
+    const size_t total = dimensions.x * dimensions.y;
+    frame->data.resize(total);
+
+    size_t pos = 0;
+    for (uint32_t i = 0; i < frame_count; ++i)
+    {
+        unsigned char flags, x, y;
+        if (!Extract(raw, &pos, &frame->time) || !Extract(raw, &pos, &flags) ||
+            !Extract(raw, &pos, &x) || !Extract(raw, &pos, &y))
+            return false;
+        frame->show_cursor = (flags & kCursorVisible) != 0;
+        frame->cursor_pos = { x, y };
+        frame->changed = { 0, 0, -1, -1 };
+
+        if (flags & kKeyframe) {
+            if (pos + total * sizeof(uint32_t) > raw.size())
+                return false;
+            memcpy(frame->data.data(), &raw[pos], total * sizeof(uint32_t));
+            pos += total * sizeof(uint32_t);
+            frame->changed = { 0, 0, dimensions.x - 1, dimensions.y - 1 };
+        }
+        else {
+            uint16_t runs;
+            if (!Extract(raw, &pos, &runs))
+                return false;
+            while (runs-- > 0) {
+                uint16_t start, count;
+                if (!Extract(raw, &pos, &start) || !Extract(raw, &pos, &count))
+                    return false;
+                if (start + count > total || pos + count * sizeof(uint32_t) > raw.size())
+                    return false;
+                memcpy(&frame->data[start], &raw[pos], count * sizeof(uint32_t));
+                pos += count * sizeof(uint32_t);
+                ExpandRegion(&frame->changed, start % dimensions.x, start / dimensions.x);
+                ExpandRegion(&frame->changed, (start + count - 1) % dimensions.x, (start + count - 1) / dimensions.x);
+                if (start / dimensions.x != (start + count - 1) / dimensions.x) {
+                    //the run wraps around a line, so it touches every column
+                    ExpandRegion(&frame->changed, 0, start / dimensions.x);
+                    ExpandRegion(&frame->changed, dimensions.x - 1, start / dimensions.x);
+                }
+            }
+        }
+
+        if (frames)
+            frames->push_back(*frame);
+    }
+    return true;
+}
+
+ScreenRecorder::ScreenRecorder(DisplayInterface* display, const std::string& path, const std::string& game_name, Coord dimensions) :
+    m_display(display),
+    m_file(path, std::ios::binary | std::ios::out),
+    m_dimensions(dimensions),
+    m_start(std::chrono::steady_clock::now()),
+    m_current(dimensions.x * dimensions.y, ' '),
+    m_last(dimensions.x * dimensions.y, ' ')
+{
+    if (!m_file)
+        throw_error("Couldn't open recording file: " + path);
+
+    m_file.write(kRecordingMagic, 4);
+    Write(m_file, kRecordingVersion);
+    WriteShortString(m_file, game_name);
+    Write(m_file, (uint16_t)dimensions.x);
+    Write(m_file, (uint16_t)dimensions.y);
+}
+
+ScreenRecorder::~ScreenRecorder()
+{
+    Finish();
+}
+
+void ScreenRecorder::Finish()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_finished)
+        return;
+    m_finished = true;
+
+    if (m_dirty)
+        EmitFrame();
+    FlushBlock();
+
+    uint64_t index_offset = (uint64_t)m_file.tellp();
+    Write(m_file, (uint32_t)m_index.size());
+    for (auto i = m_index.begin(); i != m_index.end(); ++i) {
+        Write(m_file, i->offset);
+        Write(m_file, i->first_frame);
+        Write(m_file, i->first_time);
+        Write(m_file, i->frame_count);
+    }
+    Write(m_file, index_offset);
+    m_file.write(kRecordingIndexMagic, 4);
+    m_file.close();
+}
+
+uint32_t ScreenRecorder::Now() const
+{
+    auto elapsed = std::chrono::steady_clock::now() - m_start;
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
+
+void ScreenRecorder::SetDimensions(Coord dimensions)
+{
+    m_display->SetDimensions(dimensions);
+}
+
+void ScreenRecorder::UpdateRegion(uint32_t* buf)
+{
+    UpdateRegion(buf, { 0, 0, m_dimensions.x - 1, m_dimensions.y - 1 });
+}
+
+void ScreenRecorder::UpdateRegion(uint32_t* buf, Region rect)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_finished) {
+            for (int y = rect.Top; y <= rect.Bottom; ++y) {
+                int i = y * m_dimensions.x + rect.Left;
+                memcpy(&m_current[i], &buf[i], rect.Width() * sizeof(uint32_t));
+            }
+            m_dirty = true;
+        }
+    }
+    m_display->UpdateRegion(buf, rect);
+}
+
+// Curses sends one region per changed line, followed by the cursor position,
+// so we complete a frame when the cursor is updated.
+void ScreenRecorder::MoveCursor(Coord pos)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_finished) {
+            if (pos.x != m_cursor_pos.x || pos.y != m_cursor_pos.y)
+                m_dirty = true;
+            m_cursor_pos = pos;
+            if (m_dirty)
+                EmitFrame();
+        }
+    }
+    m_display->MoveCursor(pos);
+}
+
+void ScreenRecorder::SetCursor(bool enable)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_finished) {
+            if (enable != m_show_cursor)
+                m_dirty = true;
+            m_show_cursor = enable;
+            if (m_dirty)
+                EmitFrame();
+        }
+    }
+    m_display->SetCursor(enable);
+}
+
+void ScreenRecorder::PlaySound(const std::string & id)
+{
+    m_display->PlaySound(id);
+}
+
+void ScreenRecorder::EmitFrame()
+{
+    uint32_t now = Now();
+    if (m_block_frames == 0)
+        m_block_time = now;
+
+    unsigned char flags = 0;
+    if (m_block_frames == 0)
+        flags |= kKeyframe;
+    if (m_show_cursor)
+        flags |= kCursorVisible;
+
+    Append(m_block, now);
+    Append(m_block, flags);
+    Append(m_block, (unsigned char)m_cursor_pos.x);
+    Append(m_block, (unsigned char)m_cursor_pos.y);
+
+    if (flags & kKeyframe)
+        EncodeKeyframe();
+    else
+        EncodeDiff();
+
+    m_last = m_current;
+    m_dirty = false;
+    ++m_block_frames;
+    ++m_frame_count;
+
+    if (m_block_frames >= kFramesPerBlock || m_block.size() >= kMaxBlockSize || now - m_block_time >= kMaxBlockTime)
+        FlushBlock();
+}
+
+void ScreenRecorder::EncodeKeyframe()
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(m_current.data());
+    m_block.insert(m_block.end(), p, p + m_current.size() * sizeof(uint32_t));
+}
+
+void ScreenRecorder::EncodeDiff()
+{
+    size_t count_pos = m_block.size();
+    uint16_t runs = 0;
+    Append(m_block, runs);
+
+    const size_t total = m_current.size();
+    size_t i = 0;
+    while (i < total) {
+        if (m_current[i] == m_last[i]) {
+            ++i;
+            continue;
+        }
+
+        //Extend the run over short stretches of unchanged cells, it's cheaper
+        //than starting a new run.
+        size_t start = i;
+        size_t end = i + 1;
+        for (size_t j = end; j < total && j - start < 0xffff; ++j) {
+            if (m_current[j] != m_last[j])
+                end = j + 1;
+            else if (j - end >= 2)
+                break;
+        }
+
+        Append(m_block, (uint16_t)start);
+        Append(m_block, (uint16_t)(end - start));
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(&m_current[start]);
+        m_block.insert(m_block.end(), p, p + (end - start) * sizeof(uint32_t));
+        ++runs;
+        i = end;
+    }
+    memcpy(&m_block[count_pos], &runs, sizeof(runs));
+}
+
+void ScreenRecorder::FlushBlock()
+{
+    if (m_block_frames == 0)
+        return;
+
+    std::vector<unsigned char> packed(CompressBlock(m_block));
+
+    RecordingBlockInfo info;
+    info.offset = (uint64_t)m_file.tellp();
+    info.first_frame = m_frame_count - m_block_frames;
+    info.first_time = m_block_time;
+    info.frame_count = m_block_frames;
+    m_index.push_back(info);
+
+    Write(m_file, info.first_time);
+    Write(m_file, info.frame_count);
+    Write(m_file, (uint32_t)m_block.size());
+    Write(m_file, (uint32_t)packed.size());
+    m_file.write((const char*)packed.data(), packed.size());
+    m_file.flush();
+
+    m_block.clear();
+    m_block_frames = 0;
+}
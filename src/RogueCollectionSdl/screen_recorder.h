@@ -0,0 +1,102 @@
+#pragma once
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <display_interface.h>
+
+// A screen recording is a stream of timestamped cell buffers that can be
+// played back without the engine that produced it.  Frames are grouped into
+// blocks.  Each block starts with a full keyframe, the remaining frames only
+// store the cells that changed, and each block is compressed on its own.
+// An index of blocks is written at the end of the file so a player can seek
+// by binary search and decode a single block.  A block is written out at
+// least once a second while frames are coming in, so a recording can be
+// watched while it's being made.
+//
+// File layout:
+//   header:  "RREC", version, game name, columns, lines
+//   blocks:  first time, frame count, raw size, packed size, packed frames
+//   index:   block count, { offset, first frame, first time, frame count }...
+//   trailer: index offset, "RIDX"
+//
+// If the trailer is missing (e.g. the engine called exit()), the reader
+// rebuilds the index by walking the block headers.
+
+const char kRecordingMagic[] = "RREC";
+const char kRecordingIndexMagic[] = "RIDX";
+const unsigned char kRecordingVersion = 1;
+
+struct RecordingBlockInfo
+{
+    uint64_t offset;       //file offset of the block header
+    uint32_t first_frame;  //index of the keyframe that starts the block
+    uint32_t first_time;   //timestamp of the keyframe in ms
+    uint32_t frame_count;
+};
+
+struct RecordingFrame
+{
+    uint32_t time = 0;          //ms since the start of the recording
+    bool show_cursor = false;
+    Coord cursor_pos = { 0, 0 };
+    Region changed = { 0, 0, -1, -1 };  //bounding box of the cells changed by this frame
+    std::vector<uint32_t> data;
+};
+
+//LZ77 block compression used for recording blocks
+std::vector<unsigned char> CompressBlock(const std::vector<unsigned char>& in);
+bool DecompressBlock(const unsigned char* in, size_t size, size_t raw_size, std::vector<unsigned char>* out);
+
+//Decodes the frames of one uncompressed block.  'frame' must hold the screen
+//state before the block (it is ignored if the block starts with a keyframe).
+bool DecodeBlock(const std::vector<unsigned char>& raw, uint32_t frame_count, Coord dimensions, RecordingFrame* frame, std::vector<RecordingFrame>* frames);
+
+//Records everything sent to a display, and forwards it on to that display.
+struct ScreenRecorder : public DisplayInterface
+{
+    static const uint32_t kFramesPerBlock = 256;
+    static const size_t kMaxBlockSize = 256 * 1024;
+    static const uint32_t kMaxBlockTime = 1000;
+
+    ScreenRecorder(DisplayInterface* display, const std::string& path, const std::string& game_name, Coord dimensions);
+    ~ScreenRecorder();
+
+    //display interface
+    virtual void SetDimensions(Coord dimensions) override;
+    virtual void UpdateRegion(uint32_t* buf) override;
+    virtual void UpdateRegion(uint32_t* buf, Region rect) override;
+    virtual void MoveCursor(Coord pos) override;
+    virtual void SetCursor(bool enable) override;
+    virtual void PlaySound(const std::string& id) override;
+
+    //Writes any pending frames along with the index.  No further frames are recorded.
+    void Finish();
+
+private:
+    uint32_t Now() const;
+    void EmitFrame();
+    void EncodeKeyframe();
+    void EncodeDiff();
+    void FlushBlock();
+
+    DisplayInterface* m_display;
+    std::ofstream m_file;
+    Coord m_dimensions;
+    std::chrono::steady_clock::time_point m_start;
+    std::mutex m_mutex;
+
+    std::vector<uint32_t> m_current;  //latest screen contents
+    std::vector<uint32_t> m_last;     //screen contents as of the last frame
+    Coord m_cursor_pos = { 0, 0 };
+    bool m_show_cursor = false;
+    bool m_dirty = false;
+    bool m_finished = false;
+
+    std::vector<unsigned char> m_block;
+    uint32_t m_block_frames = 0;
+    uint32_t m_block_time = 0;
+    uint32_t m_frame_count = 0;
+    std::vector<RecordingBlockInfo> m_index;
+};
@@ -0,0 +1,160 @@
+#include <sstream>
+#include "screen_renderer.h"
+#include "text_provider.h"
+#include "tile_provider.h"
+
+namespace
+{
+    RenderOptions GetRenderOptions(const GraphicsConfig& cfg)
+    {
+        RenderOptions options;
+        options.default_color = cfg.text->colors.front();
+        options.tiles = cfg.tiles != nullptr;
+        options.use_unix_gfx = cfg.use_unix_gfx;
+        options.use_colors = cfg.use_colors;
+        options.use_standout = cfg.use_standout;
+        options.animate = cfg.animate;
+        return options;
+    }
+}
+
+ScreenRenderer::ScreenRenderer(SDL_Renderer* renderer, const GraphicsConfig& cfg, Coord dimensions) :
+    m_renderer(renderer),
+    m_cfg(cfg),
+    m_dimensions(dimensions),
+    m_model(GetRenderOptions(cfg)),
+    m_grid(dimensions.x * dimensions.y)
+{
+    m_text_provider = CreateTextProvider(m_cfg.font, m_cfg.text, m_renderer);
+    m_block_size = m_text_provider->Dimensions();
+
+    if (m_cfg.tiles)
+    {
+        m_tile_provider.reset(new TileProvider(*m_cfg.tiles, m_renderer));
+        m_block_size = m_tile_provider->Dimensions();
+    }
+}
+
+ScreenRenderer::~ScreenRenderer()
+{
+}
+
+Coord ScreenRenderer::BlockSize() const
+{
+    return m_block_size;
+}
+
+Coord ScreenRenderer::ScreenSize() const
+{
+    return { m_block_size.x * m_dimensions.x, m_block_size.y * m_dimensions.y };
+}
+
+void ScreenRenderer::SetFrameNumber(int n)
+{
+    m_frame_number = n;
+}
+
+void ScreenRenderer::RenderRegion(uint32_t* data, Region rect)
+{
+    m_model.Resolve(data, m_dimensions, rect, m_grid.data());
+    for (int y = rect.Top; y <= rect.Bottom; ++y) {
+        for (int x = rect.Left; x <= rect.Right; ++x) {
+            DrawCell(m_grid[y*m_dimensions.x + x], ScreenRegion({ x, y }));
+        }
+    }
+}
+
+void ScreenRenderer::FindBlinkingCells(std::vector<int>* cells) const
+{
+    cells->clear();
+    for (int i = 0; i < (int)m_grid.size(); ++i) {
+        if (m_grid[i].flags & RenderCell::kBlink)
+            cells->push_back(i);
+    }
+}
+
+bool ScreenRenderer::RenderStairs(const std::vector<int>& cells)
+{
+    for (int i : cells) {
+        int x = i % m_dimensions.x;
+        int y = i / m_dimensions.x;
+        DrawCell(m_grid[i], ScreenRegion({ x, y }));
+    }
+    return !cells.empty();
+}
+
+void ScreenRenderer::DrawCell(const RenderCell& cell, SDL_Rect r)
+{
+    SDL_Texture* texture;
+    SDL_Rect clip;
+    if (cell.flags & RenderCell::kTile) {
+        if (m_tile_provider->GetTexture(cell.glyph, cell.color, &texture, &clip)) {
+            SDL_RenderCopy(m_renderer, texture, &clip, &r);
+            return;
+        }
+        //draw a black tile if we don't have a tile for this character
+        SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
+        SDL_RenderFillRect(m_renderer, &r);
+        return;
+    }
+
+    m_text_provider->GetTexture(cell.Glyph(m_frame_number), cell.color, &texture, &clip);
+    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
+    SDL_RenderFillRect(m_renderer, &r);
+    SDL_RenderCopy(m_renderer, texture, &clip, &r);
+}
+
+void ScreenRenderer::RenderCursor(Coord pos)
+{
+    pos = ScreenPosition(pos);
+
+    SDL_Rect r;
+    r.x = pos.x;
+    r.y = pos.y + (m_block_size.y * 3 / 4);
+    r.w = m_block_size.x;
+    r.h = m_block_size.y / 8;
+
+    int color = m_frame_number ? 0x00 : 0x07;
+
+    SDL_Rect clip;
+    SDL_Texture* text;
+    m_text_provider->GetTexture(0xdb, color, &text, &clip);
+
+    SDL_RenderCopy(m_renderer, text, &clip, &r);
+}
+
+void ScreenRenderer::RenderCounterOverlay(const std::string& label, int n)
+{
+    std::ostringstream ss;
+    ss << label;
+    if (n > 0)
+        ss << n;
+    std::string s(ss.str());
+    int len = (int)s.size();
+    for (int i = 0; i < len; ++i) {
+        Coord pos = { m_dimensions.x - (len - i) - 1, m_dimensions.y - 1 };
+        DrawCell(m_model.Resolve((unsigned char)s[i] | 0x70000000, pos.y), ScreenRegion(pos));
+    }
+}
+
+Coord ScreenRenderer::ScreenPosition(Coord buffer_pos) const
+{
+    Coord p;
+    p.x = buffer_pos.x * m_block_size.x;
+    p.y = buffer_pos.y * m_block_size.y;
+    return p;
+}
+
+SDL_Rect ScreenRenderer::ScreenRegion(Coord buffer_pos) const
+{
+    Coord p = ScreenPosition(buffer_pos);
+
+    // We always render using the tile size.  Text will be scaled if it doesn't match
+    SDL_Rect r;
+    r.x = p.x;
+    r.y = p.y;
+    r.w = m_block_size.x;
+    r.h = m_block_size.y;
+
+    return r;
+}
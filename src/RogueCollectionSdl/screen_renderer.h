@@ -0,0 +1,52 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <SDL.h>
+#include <display_interface.h>
+#include <render_model.h>
+#include "game_config.h"
+
+struct ITextProvider;
+struct TileProvider;
+
+//Draws the game's character buffer onto an SDL renderer using the text and
+//tile providers for one graphics mode.  Used for both the window and offscreen
+//export, so it doesn't know anything about windows or events.
+struct ScreenRenderer
+{
+    ScreenRenderer(SDL_Renderer* renderer, const GraphicsConfig& cfg, Coord dimensions);
+    ~ScreenRenderer();
+
+    Coord BlockSize() const;
+    Coord ScreenSize() const;
+
+    void SetFrameNumber(int n);
+
+    void RenderRegion(uint32_t* data, Region rect);
+    //The cells drawn by RenderRegion that change from frame to frame, for
+    //RenderStairs to redraw
+    void FindBlinkingCells(std::vector<int>* cells) const;
+    bool RenderStairs(const std::vector<int>& cells);
+    void RenderCursor(Coord pos);
+    void RenderCounterOverlay(const std::string& s, int n);
+
+    SDL_Rect ScreenRegion(Coord buffer_pos) const;
+
+private:
+    void DrawCell(const RenderCell& cell, SDL_Rect r);
+
+    Coord ScreenPosition(Coord buffer_pos) const;
+
+    SDL_Renderer* m_renderer = 0;
+    GraphicsConfig m_cfg;
+    Coord m_dimensions = { 0, 0 };
+    Coord m_block_size = { 0, 0 };
+    int m_frame_number = 0;
+
+    RenderModel m_model;
+    std::vector<RenderCell> m_grid;  //the screen as last resolved
+
+    std::unique_ptr<ITextProvider> m_text_provider;
+    std::unique_ptr<TileProvider> m_tile_provider;
+};
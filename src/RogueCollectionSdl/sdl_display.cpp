@@ -1,62 +1,25 @@
+#include <fstream>
 #include <sstream>
 #include <cassert>
 #include <SDL_image.h>
-#include <pc_gfx_charmap.h>
 #include "sdl_display.h"
 #include "sdl_input.h"
 #include "sdl_rogue.h"
-#include "text_provider.h"
-#include "tile_provider.h"
+#include "screen_renderer.h"
 #include "window_sizer.h"
 #include "environment.h"
 #include "sdl_utility.h"
+#include "asset_cache.h"
+#include "startup_timeline.h"
+#include "crt_filter.h"
 
 namespace
 {
-    std::map<int, int> unix_chars = {
-        { PASSAGE,   '#' },
-        { DOOR,      '+' },
-        { FLOOR,     '.' },
-        { PLAYER,    '@' },
-        { TRAP,      '^' },
-        { STAIRS,    '%' },
-        { GOLD,      '*' },
-        { POTION,    '!' },
-        { SCROLL,    '?' },
-        { FOOD,      ':' },
-        { STICK,     '/' },
-        { ARMOR,     ']' },
-        { AMULET,    ',' },
-        { RING,      '=' },
-        { WEAPON,    ')' },
-        { VWALL,     '|' },
-        { HWALL,     '-' },
-        { ULWALL,    '-' },
-        { URWALL,    '-' },
-        { LLWALL,    '-' },
-        { LRWALL,    '-' },
-        { 204,       '|' },
-        { 185,       '|' },
-    };
-
-    uint32_t CharText(uint32_t ch)
-    {
-        return ch & 0x0000ffff;
-    }
-
-    uint32_t CharColor(uint32_t ch)
-    {
-        return (ch >> 24) & 0xff;
-    }
-
-    bool IsText(uint32_t ch)
-    {
-        return (ch & 0x010000) == 0;
-    }
-
     uint32_t RENDER_EVENT = 0;
     uint32_t TIMER_EVENT = 0;
 
+    const Uint32 kBlinkInterval = 250;
+
     Uint32 PostTimerMsg(Uint32 interval, void *type)
     {
         static bool parity = true;
@@ -70,6 +33,24 @@ namespace
 
         return interval;
     }
+
+    Uint32 PostPacedRender(Uint32 interval, void *param)
+    {
+        SdlDisplay::PostRenderMsg(0);
+        return 0;
+    }
+
+    void Include(Region* r, Region rect)
+    {
+        if (r->Right < r->Left) {
+            *r = rect;
+            return;
+        }
+        r->Left = std::min(r->Left, rect.Left);
+        r->Top = std::min(r->Top, rect.Top);
+        r->Right = std::max(r->Right, rect.Right);
+        r->Bottom = std::max(r->Bottom, rect.Bottom);
+    }
 }
 
 SdlDisplay::SdlDisplay(SDL_Window* window, SDL_Renderer* renderer, Environment* current_env, Environment* game_env, const GameConfig& options, ReplayableInput* input) :
@@ -98,284 +79,269 @@ SdlDisplay::SdlDisplay(SDL_Window* window, SDL_Renderer* renderer, Environment*
     }
 
     m_dimensions = { game_env->Columns(), game_env->Lines() };
+    m_screens.resize(m_options.gfx_options.size());
+
+    //vsync already holds presents to one per refresh
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(m_renderer, &info) == 0 && !(info.flags & SDL_RENDERER_PRESENTVSYNC)) {
+        SDL_DisplayMode mode;
+        int rate = 60;
+        if (SDL_GetWindowDisplayMode(window, &mode) == 0 && mode.refresh_rate > 0)
+            rate = mode.refresh_rate;
+        m_frame_interval = 1000 / rate;
+    }
+
+    //the effects need the game drawn somewhere they can read it back from
+    std::string crt;
+    m_current_env->Get("crt", &crt);
+    CrtOptions crt_options = ParseCrtOptions(crt);
+    if (crt_options.Enabled() && SDL_GetRendererInfo(m_renderer, &info) == 0 && (info.flags & SDL_RENDERER_TARGETTEXTURE))
+        m_crt.reset(new CrtFilter(crt_options));
 
     SDL_ShowWindow(window);
     LoadAssets();
+    UpdateBlinkTimer();
 }
 
-void SdlDisplay::LoadAssets()
+SdlDisplay::~SdlDisplay()
 {
-    m_text_provider = CreateTextProvider(graphics_cfg().font, graphics_cfg().text, m_renderer);
-    m_block_size = m_text_provider->Dimensions();
+    if (m_blink_timer)
+        SDL_RemoveTimer(m_blink_timer);
+    WriteFrameStats();
+}
 
-    m_tile_provider.reset();
-    if (graphics_cfg().tiles)
-    {
-        m_tile_provider.reset(new TileProvider(*graphics_cfg().tiles, m_renderer));
-        m_block_size = m_tile_provider->Dimensions();
-    }
+void SdlDisplay::LoadAssets()
+{
+    std::unique_ptr<ScreenRenderer>& screen = m_screens[m_gfx_mode];
+    if (!screen)
+        screen.reset(new ScreenRenderer(m_renderer, graphics_cfg(), m_dimensions));
+    m_screen = screen.get();
+    m_block_size = m_screen->BlockSize();
 
     m_sizer.SetWindowSize(m_block_size.x * m_game_env->Columns(), m_block_size.y * m_game_env->Lines());
     SDL_RenderClear(m_renderer);
+    if (m_crt)
+        CreateCrtTarget();
+}
+
+void SdlDisplay::CreateCrtTarget()
+{
+    Coord size = { m_block_size.x * m_dimensions.x, m_block_size.y * m_dimensions.y };
+    int w = 0, h = 0;
+    if (m_crt_target && SDL_QueryTexture(m_crt_target.get(), 0, 0, &w, &h) == 0 && w == size.x && h == size.y)
+        return;
+
+    m_crt_target.reset(SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, size.x, size.y));
+    if (!m_crt_target)
+        throw_error("SDL_CreateTexture");
+    m_crt_frame.resize(size.x * size.y);
+}
+
+//Makes the textures for the next graphics mode whose assets have finished
+//decoding, one at a time so the window never stalls for long.  Returns false
+//once there's nothing left that could be made.
+bool SdlDisplay::PrepareGfxModes()
+{
+    bool waiting = false;
+    for (int i = 0; i < (int)m_screens.size(); ++i)
+    {
+        if (m_screens[i])
+            continue;
+        if (AssetCache::Instance().IsReady(m_options.gfx_options[i])) {
+            m_screens[i].reset(new ScreenRenderer(m_renderer, m_options.gfx_options[i], m_dimensions));
+            return true;
+        }
+        waiting |= AssetCache::Instance().IsDecoding(m_options.gfx_options[i]);
+    }
+    return waiting;
 }
 
 void SdlDisplay::RenderGame(bool force)
 {
-    std::vector<Region> regions;
-    std::unique_ptr<uint32_t[]> data;
-    Coord cursor_pos;
-    bool show_cursor;
+    force |= m_force_pending;
+    m_force_pending = false;
+
+    //hold the frame back if vsync isn't there to do it
+    Uint32 now = SDL_GetTicks();
+    if (m_frame_interval && now - m_last_present < m_frame_interval) {
+        m_force_pending = force;
+        SDL_AddTimer(m_frame_interval - (now - m_last_present), PostPacedRender, 0);
+        return;
+    }
+
+    //the glow of earlier frames still has to fade, even if nothing changed
+    bool fading = m_crt && m_crt->Fading();
+
+    Region dirty;
+    Coord old_cursor = m_cursor_pos;
+    bool old_show_cursor = m_show_cursor;
     {
         std::lock_guard<std::mutex> lock(m_mutex);
+        m_shared.render_posted = false;
 
         if (!m_shared.data)
             return;
-        if (m_shared.render_regions.empty() && !force)
+        dirty = m_shared.dirty;
+        m_shared.dirty = { 0, 0, -1, -1 };
+        bool cursor_moved = m_shared.show_cursor != m_show_cursor || !(m_shared.cursor_pos == m_cursor_pos);
+        if (dirty.Right < dirty.Left && !cursor_moved && !force && !fading)
             return;
 
-        uint32_t* temp = new uint32_t[TotalChars()];
-        memcpy(temp, m_shared.data.get(), TotalChars() * sizeof(uint32_t));
-        data.reset(temp);
-
-        regions = m_shared.render_regions;
-        m_shared.render_regions.clear();
-
-        show_cursor = m_shared.show_cursor;
-        cursor_pos = m_shared.cursor_pos;
+        if (!m_frame)
+            m_frame.reset(new uint32_t[TotalChars()]);
+        memcpy(m_frame.get(), m_shared.data.get(), TotalChars() * sizeof(uint32_t));
+        m_show_cursor = m_shared.show_cursor;
+        m_cursor_pos = m_shared.cursor_pos;
     }
 
+    BeginFrame();
     if (force) {
         SDL_RenderClear(m_renderer);
-        regions.push_back(FullRegion());
+        dirty = FullRegion();
     }
-
-    for (auto i = regions.begin(); i != regions.end(); ++i)
-    {
-        RenderRegion(data.get(), *i);
+    //the cell under a cursor that's gone
+    else if (old_show_cursor && (!m_show_cursor || !(old_cursor == m_cursor_pos))) {
+        Region r = { old_cursor.x, old_cursor.y, old_cursor.x, old_cursor.y };
+        Include(&dirty, r);
     }
 
-    if (show_cursor) {
-        RenderCursor(cursor_pos);
+    m_screen->RenderRegion(m_frame.get(), dirty);
+    m_screen->FindBlinkingCells(&m_blink_cells);
+
+    if (m_show_cursor) {
+        m_screen->RenderCursor(m_cursor_pos);
     }
 
     std::string counter;
     if (m_input && m_input->GetRenderText(&counter))
-        RenderCounterOverlay(counter, 0);
-
-    SDL_RenderPresent(m_renderer);
-}
-
-void SdlDisplay::Animate()
-{
-    bool update = false;
-    if (graphics_cfg().animate) {
-
-        std::unique_ptr<uint32_t[]> data;
-        {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            if (!m_shared.data)
-                return;
-
-            uint32_t* temp = new uint32_t[TotalChars()];
-            memcpy(temp, m_shared.data.get(), TotalChars() * sizeof(uint32_t));
-            data.reset(temp);
-        }
-
-        for (int i = 0; i < TotalChars(); ++i) {
-            auto c = CharText(data[i]);
-            if (c != STAIRS)
-                continue;
-
-            int x = i % m_dimensions.x;
-            int y = i / m_dimensions.x;
-            SDL_Rect r = ScreenRegion({ x, y });
-            RenderText(c, CharColor(data[i]), r, true);
-            update = true;
-        }
+        m_screen->RenderCounterOverlay(counter, 0);
+
+    Present();
+    FinishStartup(m_current_env);
+
+    ++m_stats.frames;
+    if (m_stats.input_time) {
+        Uint32 latency = m_last_present - m_stats.input_time;
+        m_stats.latency_total += latency;
+        m_stats.latency_max = std::max(m_stats.latency_max, latency);
+        ++m_stats.inputs;
+        m_stats.input_time = 0;
     }
 
-    bool show_cursor;
-    Coord cursor_pos;
-
-    {
+    UpdateBlinkTimer();
+    if (m_crt && m_crt->Fading()) {
         std::lock_guard<std::mutex> lock(m_mutex);
-        show_cursor = m_shared.show_cursor;
-        cursor_pos = m_shared.cursor_pos;
+        PostRender();
     }
-
-    if (show_cursor) {
-        RenderCursor(cursor_pos);
-        update = true;
-    }
-
-    if (update)
-        SDL_RenderPresent(m_renderer);
 }
 
-void SdlDisplay::RenderRegion(uint32_t* data, Region rect)
+//Redraws only the cells that blink, from the frame already on screen
+void SdlDisplay::Animate()
 {
-    for (int y = rect.Top; y <= rect.Bottom; ++y) {
-        for (int x = rect.Left; x <= rect.Right; ++x) {
-
-            SDL_Rect r = ScreenRegion({ x, y });
-
-            uint32_t info = data[y*m_dimensions.x + x];
-
-            if (!m_tile_provider || IsText(info))
-            {
-                int color = CharColor(info);
-                if (y == 0 && color == 0x70) {
-                    // Hack for consistent standout in msg lines.  Unix versions use '-'.
-                    // PC uses ' ' with background color.  We want consistent behavior.
-                    if (graphics_cfg().use_standout) {
-                        if (CharText(info) == '-')
-                            info = ' ';
-                    }
-                    else {
-                        if (CharText(info) == ' ')
-                            info = '-';
-                        color = 0x07;
-                    }
-                }
-                RenderText(info, color, r, !IsText(info));
-            }
-            else {
-                RenderTile(info, r);
-            }
-        }
+    if (!m_frame)
+        return;
+
+    BeginFrame();
+    bool update = m_screen->RenderStairs(m_blink_cells);
+    if (m_show_cursor) {
+        m_screen->RenderCursor(m_cursor_pos);
+        update = true;
     }
-}
 
-unsigned int GetColor(int chr, int attr)
-{
-    //if it is inside a room
-    if (attr == 0x07 || attr == 0) switch (chr)
-    {
-    case DOOR:
-    case VWALL: case HWALL:
-    case ULWALL: case URWALL: case LLWALL: case LRWALL:
-        return 0x06; //brown
-    case FLOOR:
-        return 0x0a; //light green
-    case STAIRS:
-        return 0x20; //black on light green
-    case TRAP:
-        return 0x05; //magenta
-    case GOLD:
-    case PLAYER:
-        return 0x0e; //yellow
-    case POTION:
-    case SCROLL:
-    case STICK:
-    case ARMOR:
-    case AMULET:
-    case RING:
-    case WEAPON:
-        return 0x09; //light blue
-    case FOOD:
-        return 0x04; //red
+    if (update) {
+        Present();
+        ++m_stats.blinks;
     }
-    //if inside a passage or a maze
-    else if (attr == 0x70) switch (chr)
-    {
-    case FOOD:
-        return 0x74; //red on grey
-    case GOLD: case PLAYER:
-        return 0x7e; //yellow on grey
-    case POTION: case SCROLL: case STICK: case ARMOR: case AMULET: case RING: case WEAPON:
-        return 0x71; //blue on grey
+    else if (m_crt_target) {
+        SDL_SetRenderTarget(m_renderer, 0);
     }
-
-    return attr;
 }
 
-unsigned char flip_color(unsigned char c)
+//Points drawing at the texture the screen effects read from, if there is one
+void SdlDisplay::BeginFrame()
 {
-    return ((c & 0x0f) << 4) | ((c & 0xf0) >> 4);
+    if (m_crt_target)
+        SDL_SetRenderTarget(m_renderer, m_crt_target.get());
 }
 
-void SdlDisplay::RenderText(uint32_t info, unsigned char color, SDL_Rect r, bool is_tile)
+void SdlDisplay::Present()
 {
-    unsigned char c = CharText(info);
-
-    // Tiles from Unix versions come in with either color=0x00 (for regular state)
-    // or color=0x70 (for standout).  We need to translate these into more diverse
-    // colors.  Tiles from PC versions already have the correct color, so we
-    // technically don't need to do anything here, but it doesn't hurt to call
-    // GetColor.
-    if (is_tile) {
-        color = GetColor(c, color);
-    }
-    if (!color || !graphics_cfg().use_colors) {
-        bool standout(color > 0x0f);
-        color = graphics_cfg().text->colors.front();
-        if (standout && graphics_cfg().use_standout)
-            color = flip_color(color);
-    }
-
-    if (graphics_cfg().animate && c == STAIRS && m_frame_number == 1)
-        c = ' ';
-
-    if (graphics_cfg().use_unix_gfx && is_tile)
-    {
-        auto i = unix_chars.find(c);
-        if (i != unix_chars.end())
-            c = i->second;
+    if (m_crt_target)
+        PresentCrt();
+    SDL_RenderPresent(m_renderer);
+    m_last_present = SDL_GetTicks();
+}
+
+//Reads the game back from its texture and draws it through the screen effects
+//at the size it fills in the window, so the scanlines are sharp
+void SdlDisplay::PresentCrt()
+{
+    int w = 0, h = 0;
+    SDL_QueryTexture(m_crt_target.get(), 0, 0, &w, &h);
+    if (SDL_RenderReadPixels(m_renderer, 0, SDL_PIXELFORMAT_ARGB8888, m_crt_frame.data(), w * sizeof(uint32_t)) != 0)
+        throw_error("SDL_RenderReadPixels");
+    SDL_SetRenderTarget(m_renderer, 0);
+
+    int out_w = 0, out_h = 0;
+    SDL_GetRendererOutputSize(m_renderer, &out_w, &out_h);
+    double scale = std::min((double)out_w / w, (double)out_h / h);
+    Coord size = { std::max(1, (int)(w * scale)), std::max(1, (int)(h * scale)) };
+    if (!m_crt_output || !(size == m_crt_output_size)) {
+        m_crt_output.reset(SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, size.x, size.y));
+        if (!m_crt_output)
+            throw_error("SDL_CreateTexture");
+        SDL_SetTextureBlendMode(m_crt_output.get(), SDL_BLENDMODE_NONE);
+        m_crt_output_size = size;
     }
 
-    SDL_Rect clip;
-    SDL_Texture* text;
-    m_text_provider->GetTexture(c, color, &text, &clip);
+    void* pixels = 0;
+    int pitch = 0;
+    if (SDL_LockTexture(m_crt_output.get(), 0, &pixels, &pitch) != 0)
+        throw_error("SDL_LockTexture");
+    m_crt->Process(m_crt_frame.data(), w, h, static_cast<uint32_t*>(pixels), size.x, size.y, pitch);
+    SDL_UnlockTexture(m_crt_output.get());
 
-    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
-    SDL_RenderFillRect(m_renderer, &r);
-    SDL_RenderCopy(m_renderer, text, &clip, &r);
+    SDL_RenderClear(m_renderer);
+    SDL_RenderCopy(m_renderer, m_crt_output.get(), 0, 0);
 }
 
-void SdlDisplay::RenderTile(uint32_t info, SDL_Rect r)
+//Keeps the timer going only while there's something for it to do, so an idle
+//window doesn't wake up at all
+void SdlDisplay::UpdateBlinkTimer()
 {
-    SDL_Texture* tiles;
-    SDL_Rect clip;
-    if (m_tile_provider->GetTexture(CharText(info), CharColor(info), &tiles, &clip)) {
-        SDL_RenderCopy(m_renderer, tiles, &clip, &r);
+    bool needed = !m_blink_cells.empty() || m_show_cursor || m_preparing;
+    if (needed && !m_blink_timer) {
+        m_blink_timer = SDL_AddTimer(kBlinkInterval, PostTimerMsg, &TIMER_EVENT);
     }
-    else {
-        //draw a black tile if we don't have a tile for this character
-        SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
-        SDL_RenderFillRect(m_renderer, &r);
+    else if (!needed && m_blink_timer) {
+        SDL_RemoveTimer(m_blink_timer);
+        m_blink_timer = 0;
     }
 }
 
-void SdlDisplay::RenderCursor(Coord pos)
+//Asks for a frame, unless one is already on its way.  Called with m_mutex held.
+void SdlDisplay::PostRender()
 {
-    pos = ScreenPosition(pos);
-
-    SDL_Rect r;
-    r.x = pos.x;
-    r.y = pos.y + (m_block_size.y * 3 / 4);
-    r.w = m_block_size.x;
-    r.h = m_block_size.y / 8;
-
-    int color = m_frame_number ? 0x00 : 0x07;
-
-    SDL_Rect clip;
-    SDL_Texture* text;
-    m_text_provider->GetTexture(0xdb, color, &text, &clip);
-
-    SDL_RenderCopy(m_renderer, text, &clip, &r);
+    if (m_shared.render_posted)
+        return;
+    m_shared.render_posted = true;
+    PostRenderMsg(0);
 }
 
-void SdlDisplay::RenderCounterOverlay(const std::string& label, int n)
+void SdlDisplay::WriteFrameStats()
 {
-    std::ostringstream ss;
-    ss << label;
-    if (n > 0)
-        ss << n;
-    std::string s(ss.str());
-    int len = (int)s.size();
-    for (int i = 0; i < len; ++i) {
-        SDL_Rect r = ScreenRegion({ m_dimensions.x - (len - i) - 1, m_dimensions.y - 1 });
-        RenderText(s[i], 0x70, r, false);
+    std::string path;
+    if (!m_current_env->Get("frame_stats", &path) || path.empty())
+        return;
+
+    std::ofstream file(path);
+    file << "frames\t" << m_stats.frames << std::endl;
+    file << "blink_frames\t" << m_stats.blinks << std::endl;
+    file << "timer_wakeups\t" << m_stats.ticks << std::endl;
+    file << "keys\t" << m_stats.inputs << std::endl;
+    if (m_stats.inputs) {
+        file << "mean_key_to_present_ms\t" << (double)m_stats.latency_total / m_stats.inputs << std::endl;
+        file << "max_key_to_present_ms\t" << m_stats.latency_max << std::endl;
     }
 }
 
@@ -384,28 +350,6 @@ const GraphicsConfig & SdlDisplay::graphics_cfg() const
     return m_options.gfx_options[m_gfx_mode];
 }
 
-Coord SdlDisplay::ScreenPosition(Coord buffer_pos)
-{
-    Coord p;
-    p.x = buffer_pos.x * m_block_size.x;
-    p.y = buffer_pos.y * m_block_size.y;
-    return p;
-}
-
-SDL_Rect SdlDisplay::ScreenRegion(Coord buffer_pos)
-{
-    Coord p = ScreenPosition(buffer_pos);
-
-    // We always render using the tile size.  Text will be scaled if it doesn't match
-    SDL_Rect r;
-    r.x = p.x;
-    r.y = p.y;
-    r.w = m_block_size.x;
-    r.h = m_block_size.y;
-
-    return r;
-}
-
 void SdlDisplay::SetDimensions(Coord dimensions)
 {
     assert(m_dimensions.x == dimensions.x);
@@ -417,38 +361,42 @@ void SdlDisplay::UpdateRegion(uint32_t * info)
     UpdateRegion(info, FullRegion());
 }
 
+//However many updates come in before the render thread gets to them, they
+//make one frame of everything they changed
 void SdlDisplay::UpdateRegion(uint32_t* info, Region rect)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
 
-    //todo: If we're adding a full render to the queue, we can ignore any previous regions.
-
-    //If we're behind on rendering, clear the queue and do a single full render.
-    if (m_shared.render_regions.size() > kMaxQueueSize)
-    {
-        m_shared.render_regions.clear();
-        m_shared.render_regions.push_back(FullRegion());
+    if (!m_shared.data) {
+        m_shared.data.reset(new uint32_t[TotalChars()]);
+        rect = FullRegion();
     }
-    else {
-        m_shared.render_regions.push_back(rect);
-        PostRenderMsg(0);
+    for (int y = rect.Top; y <= rect.Bottom; ++y) {
+        int i = y * m_dimensions.x + rect.Left;
+        memcpy(m_shared.data.get() + i, info + i, rect.Width() * sizeof(uint32_t));
     }
 
-    if(!m_shared.data)
-        m_shared.data.reset(new uint32_t[TotalChars()]);
-    memcpy(m_shared.data.get(), info, TotalChars() * sizeof(int32_t));
+    Include(&m_shared.dirty, rect);
+    PostRender();
 }
 
 void SdlDisplay::MoveCursor(Coord pos)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_shared.cursor_pos == pos)
+        return;
     m_shared.cursor_pos = pos;
+    if (m_shared.show_cursor)
+        PostRender();
 }
 
 void SdlDisplay::SetCursor(bool enable)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_shared.show_cursor == enable)
+        return;
     m_shared.show_cursor = enable;
+    PostRender();
 }
 
 void SdlDisplay::PlaySound(const std::string & id)
@@ -476,8 +424,6 @@ void SdlDisplay::RegisterEvents()
 {
     RENDER_EVENT = SDL_RegisterEvents(2);
     TIMER_EVENT = RENDER_EVENT + 1;
-
-    SDL_AddTimer(250, PostTimerMsg, &TIMER_EVENT);
 }
 
 void SdlDisplay::PostRenderMsg(int force)
@@ -491,6 +437,10 @@ void SdlDisplay::PostRenderMsg(int force)
 
 bool SdlDisplay::HandleEvent(const SDL_Event & e)
 {
+    //timed from when SDL saw the key to the next frame the game draws
+    if ((e.type == SDL_KEYDOWN || e.type == SDL_TEXTINPUT) && !m_stats.input_time)
+        m_stats.input_time = e.common.timestamp;
+
     if (e.type == SDL_TEXTINPUT) {
         return HandleEventText(e);
     }
@@ -522,15 +472,24 @@ bool SdlDisplay::HandleWindowEvent(const SDL_Event & e)
 
 bool SdlDisplay::HandleRenderEvent(const SDL_Event & e)
 {
-    SDL_FlushEvent(RENDER_EVENT);
-    RenderGame(e.user.code != 0);
+    //every render waiting is drawn by this one frame
+    bool force = e.user.code != 0;
+    SDL_Event pending;
+    while (SDL_PeepEvents(&pending, 1, SDL_GETEVENT, RENDER_EVENT, RENDER_EVENT) > 0)
+        force |= pending.user.code != 0;
+
+    RenderGame(force);
     return true;
 }
 
 bool SdlDisplay::HandleTimerEvent(const SDL_Event & e)
 {
-    m_frame_number = e.user.code;
+    ++m_stats.ticks;
+    m_screen->SetFrameNumber(e.user.code);
     Animate();
+    if (m_preparing)
+        m_preparing = PrepareGfxModes();
+    UpdateBlinkTimer();
     return true;
 }
 
@@ -4,17 +4,17 @@
 #include <display_interface.h>
 #include "sdl_rogue.h"
 #include "window_sizer.h"
+#include "sdl_utility.h"
 
 struct Environment;
-struct ITextProvider;
-struct TileProvider;
+struct ScreenRenderer;
 struct ReplayableInput;
+struct CrtFilter;
 
 struct SdlDisplay : public DisplayInterface
 {
-    const unsigned int kMaxQueueSize = 1;
-
     SdlDisplay(SDL_Window* window, SDL_Renderer* renderer, Environment* current_env, Environment* game_env, const GameConfig& options, ReplayableInput* input);
+    ~SdlDisplay();
 
     //display interface
     virtual void SetDimensions(Coord dimensions) override;
@@ -41,19 +41,19 @@ private:
     bool HandleEventText(const SDL_Event& e);
 
     void LoadAssets();
+    void CreateCrtTarget();
+    bool PrepareGfxModes();
     void RenderGame(bool force);
     void Animate();
-    void RenderRegion(uint32_t* info, Region rect);
-    void RenderText(uint32_t info, unsigned char color, SDL_Rect r, bool is_tile);
-    void RenderTile(uint32_t info, SDL_Rect r);
-    void RenderCursor(Coord pos);
-    void RenderCounterOverlay(const std::string& s, int n);
+    void UpdateBlinkTimer();
+    void PostRender();
+    void BeginFrame();
+    void Present();
+    void PresentCrt();
+    void WriteFrameStats();
 
     const GraphicsConfig& graphics_cfg() const;
 
-    Coord ScreenPosition(Coord buffer_pos);
-    SDL_Rect ScreenRegion(Coord buffer_pos);
-
     Region FullRegion() const;
     int TotalChars() const;
 
@@ -70,17 +70,48 @@ private:
     Coord m_block_size = { 0, 0 };
     int m_gfx_mode = 0;
     WindowSizer m_sizer;
-    std::unique_ptr<ITextProvider> m_text_provider;
-    std::unique_ptr<TileProvider> m_tile_provider;
-    int m_frame_number = 0;
+    //one for each graphics mode, kept so switching back is instant
+    std::vector<std::unique_ptr<ScreenRenderer>> m_screens;
+    ScreenRenderer* m_screen = 0;
 
     struct ThreadData
     {
         std::unique_ptr<uint32_t[]> data = 0;
         bool show_cursor = false;
         Coord cursor_pos = { 0, 0 };
-        std::vector<Region> render_regions;
+        Region dirty = { 0, 0, -1, -1 };  //bounding box of the cells changed since the last frame
+        bool render_posted = false;       //a RENDER_EVENT is on its way, so another isn't needed
     };
     ThreadData m_shared;
     std::mutex m_mutex;
+
+    //owned by the render thread
+    std::unique_ptr<uint32_t[]> m_frame;  //the screen as last drawn
+    bool m_show_cursor = false;
+    Coord m_cursor_pos = { 0, 0 };
+    std::vector<int> m_blink_cells;       //cells of m_frame the timer redraws
+    SDL_TimerID m_blink_timer = 0;        //only runs while something blinks
+    bool m_preparing = true;              //graphics modes are still being made
+    bool m_force_pending = false;         //a full redraw is waiting on the frame pacing
+    Uint32 m_frame_interval = 0;          //least ms between presents, if vsync doesn't pace them
+    Uint32 m_last_present = 0;
+
+    struct FrameStats
+    {
+        int frames = 0;
+        int blinks = 0;
+        int ticks = 0;
+        int inputs = 0;
+        Uint32 input_time = 0;  //when the key waiting for a frame was pressed
+        Uint32 latency_total = 0;
+        Uint32 latency_max = 0;
+    };
+    FrameStats m_stats;
+
+    //set if the crt option asks for screen effects
+    std::unique_ptr<CrtFilter> m_crt;
+    SDL::Scoped::Texture m_crt_target = SDL::Scoped::Texture(nullptr, SDL_DestroyTexture);  //the game at its own resolution
+    SDL::Scoped::Texture m_crt_output = SDL::Scoped::Texture(nullptr, SDL_DestroyTexture);  //the filtered frame at the window's
+    Coord m_crt_output_size = { 0, 0 };
+    std::vector<uint32_t> m_crt_frame;
 };
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <thread>
+#include <SDL.h>
+#include "sdl_player.h"
+#include "sdl_display.h"
+#include "text_provider.h"
+#include "tile_provider.h"
+#include "sdl_rogue.h"
+#include "recording_player.h"
+#include "environment.h"
+#include "utility.h"
+
+SdlPlayer::SdlPlayer(SDL_Window* window, SDL_Renderer* renderer, std::shared_ptr<Environment> current_env, const std::string& filename) :
+    m_current_env(current_env),
+    m_game_env(new Environment()),
+    m_reader(new RecordingReader(filename))
+{
+    auto i = std::find_if(s_options.begin(), s_options.end(), [this](const GameConfig& cfg) {
+        return cfg.name == m_reader->GameName();
+    });
+    if (i == s_options.end())
+        throw_error("Recording specified unknown game: " + m_reader->GameName());
+    m_options = *i;
+
+    m_game_env->Columns(m_reader->Dimensions().x);
+    m_game_env->Lines(m_reader->Dimensions().y);
+
+    m_display.reset(new SdlDisplay(window, renderer, m_current_env.get(), m_game_env.get(), m_options, 0));
+    m_player.reset(new RecordingPlayer(m_reader.get(), m_display.get()));
+    UpdateTitle();
+}
+
+SdlPlayer::~SdlPlayer()
+{
+}
+
+void SdlPlayer::Run()
+{
+    SdlDisplay::RegisterEvents();
+
+    std::thread playback(&RecordingPlayer::Run, m_player.get());
+
+    SDL_Event e;
+    while (SDL_WaitEvent(&e)) {
+        if (m_display->HandleEvent(e))
+            continue;
+
+        if (e.type == SDL_QUIT)
+            break;
+
+        if (HandleEvent(e))
+            UpdateTitle();
+    }
+
+    m_player->Stop();
+    playback.join();
+}
+
+bool SdlPlayer::HandleEvent(const SDL_Event& e)
+{
+    if (e.type == SDL_KEYDOWN) {
+        switch (e.key.keysym.sym) {
+        case SDLK_LEFT:
+            m_player->SeekRelative(-kSeekStep);
+            return true;
+        case SDLK_RIGHT:
+            m_player->SeekRelative(kSeekStep);
+            return true;
+        case SDLK_HOME:
+            m_player->SeekTo(0);
+            return true;
+        case SDLK_END:
+            m_player->SeekTo(m_reader->Duration());
+            return true;
+        }
+    }
+    else if (e.type == SDL_TEXTINPUT) {
+        switch (e.text.text[0]) {
+        case ' ':
+            m_player->TogglePause();
+            return true;
+        case '+':
+            m_player->IncreaseSpeed();
+            return true;
+        case '-':
+            m_player->DecreaseSpeed();
+            return true;
+        }
+    }
+    return false;
+}
+
+void SdlPlayer::UpdateTitle()
+{
+    std::string status;
+    m_player->GetStatusText(&status);
+
+    std::string title(SdlRogue::kWindowTitle);
+    title += " - ";
+    title += m_options.name;
+    title += " - ";
+    title += status;
+    m_display->SetTitle(title);
+}
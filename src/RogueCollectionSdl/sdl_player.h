@@ -0,0 +1,32 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <SDL.h>
+#include "game_config.h"
+
+struct Environment;
+struct SdlDisplay;
+struct RecordingReader;
+struct RecordingPlayer;
+
+//Plays back a screen recording without loading any game engine
+struct SdlPlayer
+{
+    SdlPlayer(SDL_Window* window, SDL_Renderer* renderer, std::shared_ptr<Environment> current_env, const std::string& filename);
+    ~SdlPlayer();
+
+    void Run();
+
+    static const int kSeekStep = 10000;
+
+private:
+    bool HandleEvent(const SDL_Event& e);
+    void UpdateTitle();
+
+    std::shared_ptr<Environment> m_current_env;
+    std::unique_ptr<Environment> m_game_env;
+    std::unique_ptr<RecordingReader> m_reader;
+    std::unique_ptr<SdlDisplay> m_display;
+    std::unique_ptr<RecordingPlayer> m_player;
+    GameConfig m_options;
+};
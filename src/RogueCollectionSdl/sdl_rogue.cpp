@@ -6,6 +6,7 @@
 #include "environment.h"
 #include "sdl_display.h"
 #include "sdl_input.h"
+#include "screen_recorder.h"
 #include "utility.h"
 
 const char* SdlRogue::kWindowTitle = "Rogue Collection 1.0";
@@ -16,6 +17,7 @@ SdlRogue::SdlRogue(SDL_Window* window, SDL_Renderer* renderer, std::shared_ptr<E
 {
     RestoreGame(file);
     m_display.reset(new SdlDisplay(window, renderer, m_current_env.get(), m_game_env.get(), m_options, m_input.get()));
+    StartRecording();
 }
 
 SdlRogue::SdlRogue(SDL_Window* window, SDL_Renderer* renderer, std::shared_ptr<Environment> env, int i) :
@@ -31,14 +33,26 @@ SdlRogue::SdlRogue(SDL_Window* window, SDL_Renderer* renderer, std::shared_ptr<E
 
     m_input.reset(new SdlInput(m_current_env.get(), m_game_env.get(), m_options));
     m_display.reset(new SdlDisplay(window, renderer, m_current_env.get(), m_game_env.get(), m_options, 0));
+    StartRecording();
 }
 
 SdlRogue::~SdlRogue()
 {
 }
 
+void SdlRogue::StartRecording()
+{
+    std::string path;
+    if (m_current_env->Get("record", &path) && !path.empty()) {
+        Coord dimensions = { m_game_env->Columns(), m_game_env->Lines() };
+        m_recorder.reset(new ScreenRecorder(m_display.get(), path, m_options.name, dimensions));
+    }
+}
+
 DisplayInterface * SdlRogue::Display() const
 {
+    if (m_recorder)
+        return m_recorder.get();
     return m_display.get();
 }
 
@@ -70,6 +84,8 @@ void SdlRogue::Run()
             std::string path;
             if (m_current_env->Get("autosave", &path))
                 SaveGame(path, false);
+            if (m_recorder)
+                m_recorder->Finish();
             return;
         }
         else if (e.type == SDL_KEYDOWN) {
@@ -92,36 +108,44 @@ void SdlRogue::PostQuit()
 }
 
 void SdlRogue::SetGame(const std::string & name)
+{
+    SetGame(FindGame(name));
+}
+
+void SdlRogue::SetGame(int i)
+{
+    m_options = s_options[i];
+    SetupGameEnv(m_options, m_game_env.get());
+}
+
+int SdlRogue::FindGame(const std::string & name)
 {
     for (int i = 0; i < (int)s_options.size(); ++i)
     {
-        if (s_options[i].name == name) {
-            SetGame(i);
-            return;
-        }
+        if (s_options[i].name == name)
+            return i;
     }
     throw_error("Save file specified unknown game: " + name);
+    return -1;
 }
 
-void SdlRogue::SetGame(int i)
+void SdlRogue::SetupGameEnv(const GameConfig& options, Environment* game_env)
 {
-    m_options = s_options[i];
-
-    if (m_options.name == "PC Rogue 1.1") {
-        m_game_env->Set("emulate_version", "1.1");
+    if (options.name == "PC Rogue 1.1") {
+        game_env->Set("emulate_version", "1.1");
     }
 
-    if (!m_game_env->WriteToOs(m_options.is_unix))
+    if (!game_env->WriteToOs(options.is_unix))
         throw_error("Couldn't write environment");
 
     std::string screen;
-    Coord dims = m_options.screen;
-    if (m_game_env->Get("small_screen", &screen) && screen == "true")
+    Coord dims = options.screen;
+    if (game_env->Get("small_screen", &screen) && screen == "true")
     {
-        dims = m_options.small_screen;
+        dims = options.small_screen;
     }
-    m_game_env->Columns(dims.x);
-    m_game_env->Lines(dims.y);
+    game_env->Columns(dims.x);
+    game_env->Lines(dims.y);
 }
 
 void SdlRogue::SaveGame(std::string path, bool notify)
@@ -166,38 +190,43 @@ void SdlRogue::RestoreGame(const std::string& path)
         throw_error("Couldn't open save file: " + path);
     }
 
-    unsigned char version;
-    Read(file, &version);
-    if (version > SdlRogue::kSaveVersion)
-        throw_error("This file is not recognized.  It may have been saved with a newer version of Rogue Collection.  Please download the latest version and try again.");
-
-    Read(file, &m_restore_count);
-    ++m_restore_count;
-
     std::string name;
-    ReadShortString(file, &name);
-
-    // set up game environment
     m_game_env.reset(new Environment());
-    m_game_env->Deserialize(file);
-    m_game_env->Set("in_replay", "true");
-    std::string value;
-    if (m_current_env->Get("logfile", &value)) {
-        m_game_env->Set("logfile", value);
-    }
-    if (version == 1) {
-        m_game_env->Set("trap_bugfix", "false");
-        m_game_env->Set("room_bugfix", "false");
-        m_game_env->Set("confused_bugfix", "false");
-    }
+    ReadSaveHeader(file, m_current_env.get(), m_game_env.get(), &name, &m_restore_count);
+    ++m_restore_count;
 
     SetGame(name);
 
     m_input.reset(new SdlInput(m_current_env.get(), m_game_env.get(), m_options));
     m_input->RestoreGame(file);
 
+    std::string value;
     if (m_current_env->Get("delete_on_restore", &value) && value == "true") {
         file.close();
         std::remove(path.c_str());
     }
 }
+
+void SdlRogue::ReadSaveHeader(std::istream& file, Environment* current_env, Environment* game_env, std::string* name, uint16_t* restore_count)
+{
+    unsigned char version;
+    Read(file, &version);
+    if (version > SdlRogue::kSaveVersion)
+        throw_error("This file is not recognized.  It may have been saved with a newer version of Rogue Collection.  Please download the latest version and try again.");
+
+    Read(file, restore_count);
+    ReadShortString(file, name);
+
+    // set up game environment
+    game_env->Deserialize(file);
+    game_env->Set("in_replay", "true");
+    std::string value;
+    if (current_env->Get("logfile", &value)) {
+        game_env->Set("logfile", value);
+    }
+    if (version == 1) {
+        game_env->Set("trap_bugfix", "false");
+        game_env->Set("room_bugfix", "false");
+        game_env->Set("confused_bugfix", "false");
+    }
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <istream>
 #include <memory>
 #include <vector>
 #include <SDL.h>
@@ -10,6 +11,7 @@ struct InputInterface;
 struct SdlDisplay;
 struct SdlInput;
 struct Environment;
+struct ScreenRecorder;
 
 struct SdlRogue
 {
@@ -28,14 +30,21 @@ struct SdlRogue
     Environment* GameEnv() const;
     GameConfig Options() const;
 
+    //Reads everything in a save file up to the keylog
+    static void ReadSaveHeader(std::istream& file, Environment* current_env, Environment* game_env, std::string* name, uint16_t* restore_count);
+    static int FindGame(const std::string& name);
+    static void SetupGameEnv(const GameConfig& options, Environment* game_env);
+
     static const char* kWindowTitle;
     static const unsigned char kSaveVersion;
 
 private:
     void SetGame(const std::string& name);
     void SetGame(int i);
+    void StartRecording();
 
     std::unique_ptr<SdlDisplay> m_display;
+    std::unique_ptr<ScreenRecorder> m_recorder;
     std::unique_ptr<SdlInput> m_input;
     std::shared_ptr<Environment> m_current_env;
     std::shared_ptr<Environment> m_game_env;
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <mutex>
 #include <nfd.h>
 #include <SDL.h>
 #include <SDL_image.h>
@@ -113,9 +114,22 @@ std::string GetResourcePath(const std::string &subDir) {
     return subDir.empty() ? baseRes : baseRes + subDir + PATH_SEP;
 }
 
+namespace
+{
+    //FreeType lets fonts draw on any thread, but opening and closing them have to take turns
+    std::mutex s_font_mutex;
+
+    void CloseFont(TTF_Font* font)
+    {
+        std::lock_guard<std::mutex> lock(s_font_mutex);
+        TTF_CloseFont(font);
+    }
+}
+
 SDL::Scoped::Font LoadFont(const std::string& filename, int size)
 {
-    SDL::Scoped::Font font(TTF_OpenFont(filename.c_str(), size), TTF_CloseFont);
+    std::lock_guard<std::mutex> lock(s_font_mutex);
+    SDL::Scoped::Font font(TTF_OpenFont(filename.c_str(), size), CloseFont);
     if (font == nullptr)
         throw_error("TTF_OpenFont");
 
@@ -269,6 +283,14 @@ SDL::Scoped::Texture LoadImage(const std::string &file, SDL_Renderer *ren) {
     return texture;
 }
 
+SDL::Scoped::Surface LoadImage(const std::string &file)
+{
+    SDL::Scoped::Surface surface(IMG_Load(file.c_str()), SDL_FreeSurface);
+    if (surface == nullptr)
+        throw_error("Couldn't open file " + file);
+    return surface;
+}
+
 SDL::Scoped::Surface LoadBmp(const std::string& filename)
 {
     SDL::Scoped::Surface bmp(SDL_LoadBMP(filename.c_str()), SDL_FreeSurface);
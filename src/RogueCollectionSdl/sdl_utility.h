@@ -62,6 +62,7 @@ SDL::Scoped::Surface BlitSurface(SDL_Surface* surface, SDL_Rect* r = 0);
 SDL::Scoped::Texture PaintedTexture(SDL_Surface* surface, SDL_Rect* r, SDL_Color fg, SDL_Color bg, SDL_Renderer* renderer);
 
 SDL::Scoped::Texture LoadImage(const std::string &file, SDL_Renderer *ren);
+SDL::Scoped::Surface LoadImage(const std::string &file);
 SDL::Scoped::Font LoadFont(const std::string& filename, int size);
 SDL::Scoped::Surface LoadBmp(const std::string& filename);
 SDL::Scoped::Texture CreateTexture(SDL_Surface* surface, SDL_Renderer* renderer);
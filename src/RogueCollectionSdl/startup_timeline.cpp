@@ -0,0 +1,59 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <vector>
+#include "startup_timeline.h"
+#include "environment.h"
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    struct Timeline
+    {
+        Clock::time_point start = Clock::now();
+        std::vector<std::pair<double, std::string>> events;
+        bool finished = false;
+        std::mutex mutex;
+    };
+
+    //started by the first step marked, which main() makes right away
+    Timeline& GetTimeline()
+    {
+        static Timeline timeline;
+        return timeline;
+    }
+}
+
+void MarkStartup(const std::string& event)
+{
+    Timeline& t = GetTimeline();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    if (t.finished)
+        return;
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - t.start).count();
+    t.events.push_back(std::make_pair(ms, event));
+}
+
+void FinishStartup(Environment* env)
+{
+    MarkStartup("first frame");
+
+    Timeline& t = GetTimeline();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    if (t.finished)
+        return;
+    t.finished = true;
+
+    std::string path;
+    if (!env->Get("startup_log", &path) || path.empty())
+        return;
+
+    std::ofstream file(path);
+    for (auto& e : t.events) {
+        char line[32];
+        snprintf(line, sizeof(line), "%9.1fms  ", e.first);
+        file << line << e.second << std::endl;
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include <string>
+
+struct Environment;
+
+//Notes how long after startup the given step happened
+void MarkStartup(const std::string& event);
+
+//Marks the first frame of the game.  The first time, the steps so far are
+//written to the file named by startup_log, if there is one.
+void FinishStartup(Environment* env);
@@ -5,11 +5,12 @@
 #include "sdl_rogue.h"
 #include "sdl_utility.h"
 #include "dos_to_unicode.h"
+#include "asset_cache.h"
 
 TextProvider::TextProvider(const TextConfig & config, SDL_Renderer * renderer)
     : m_cfg(config)
 {
-    SDL::Scoped::Texture text(LoadImage(GetResourcePath("") + config.imagefile, renderer));
+    SDL::Scoped::Texture text(CreateTexture(AssetCache::Instance().Image(GetResourcePath("") + config.imagefile).get(), renderer));
     m_text = text.release();
     int textw, texth;
     SDL_QueryTexture(m_text, NULL, NULL, &textw, &texth);
@@ -59,7 +60,7 @@ void TextProvider::GetTexture(int ch, int color, SDL_Texture ** texture, SDL_Rec
 TextGenerator::TextGenerator(const TextConfig & config, SDL_Renderer * renderer) : 
     m_cfg(config),
     m_renderer(renderer),
-    m_text(LoadBmp(GetResourcePath("") + config.imagefile))
+    m_text(AssetCache::Instance().Bmp(GetResourcePath("") + config.imagefile))
 {
     assert(config.colors.size() == 1);
     Init();
@@ -74,10 +75,7 @@ std::string all_chars()
     return s;
 }
 
-TextGenerator::TextGenerator(const FontConfig & config, SDL_Renderer * renderer) :
-    m_cfg(),
-    m_renderer(renderer),
-    m_text(0, SDL_FreeSurface)
+SDL::Scoped::Surface RenderGlyphs(const FontConfig& config)
 {
     SDL::Scoped::Font font(LoadFont(config.fontfile, config.size));
     TTF_SetFontKerning(font.get(), 0);
@@ -85,10 +83,18 @@ TextGenerator::TextGenerator(const FontConfig & config, SDL_Renderer * renderer)
     std::string s(all_chars());
     uint16_string u16s(DosToUnicode(s));
 
-    auto text = TTF_RenderUNICODE_Solid(font.get(), u16s.c_str(), SDL::Colors::grey());
-    m_text = SDL::Scoped::Surface(text, SDL_FreeSurface);
+    SDL::Scoped::Surface text(TTF_RenderUNICODE_Solid(font.get(), u16s.c_str(), SDL::Colors::grey()), SDL_FreeSurface);
+    if (text == nullptr)
+        throw_error("TTF_RenderUNICODE");
+    return text;
+}
 
-    m_cfg.layout.x = (int)s.size();
+TextGenerator::TextGenerator(const FontConfig & config, SDL_Renderer * renderer) :
+    m_cfg(),
+    m_renderer(renderer),
+    m_text(AssetCache::Instance().Glyphs(config))
+{
+    m_cfg.layout.x = (int)all_chars().size();
     m_cfg.layout.y = 1;
     
     Init();
@@ -50,4 +50,7 @@ private:
     std::vector<SDL_Color> m_colors;
 };
 
+//The 256 characters of a font drawn in a row, for TextGenerator to cut up and paint
+SDL::Scoped::Surface RenderGlyphs(const FontConfig& config);
+
 std::unique_ptr<ITextProvider> CreateTextProvider(FontConfig* font_cfg, TextConfig* text_cfg, SDL_Renderer* renderer);
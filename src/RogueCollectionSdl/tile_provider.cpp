@@ -2,6 +2,7 @@
 #include <pc_gfx_charmap.h>
 #include "tile_provider.h"
 #include "sdl_utility.h"
+#include "asset_cache.h"
 
 TileProvider::TileProvider(const TileConfig & config, SDL_Renderer * renderer)
     : m_cfg(config)
@@ -38,7 +39,7 @@ TileProvider::TileProvider(const TileConfig & config, SDL_Renderer * renderer)
         { '*',    77 },
     };
 
-    SDL::Scoped::Surface tiles(LoadBmp(GetResourcePath("") + config.filename));
+    SDL::Scoped::Surface tiles(AssetCache::Instance().Bmp(GetResourcePath("") + config.filename));
     m_tile_dimensions.x = tiles->w / config.count;
     m_tile_dimensions.y = tiles->h / config.states;
     m_tiles = CreateTexture(tiles.get(), renderer).release();
@@ -0,0 +1,524 @@
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <SDL.h>
+#include <display_interface.h>
+#include "tiled_viewer.h"
+#include "screen_renderer.h"
+#include "recording_player.h"
+#include "sdl_rogue.h"
+#include "environment.h"
+#include "game_config.h"
+
+namespace
+{
+    uint32_t RENDER_EVENT = 0;
+
+    //Where a texture of the given size fits in bounds without being stretched
+    SDL_Rect Fit(SDL_Rect bounds, Coord size)
+    {
+        double scale = std::min((double)bounds.w / size.x, (double)bounds.h / size.y);
+        SDL_Rect r;
+        r.w = std::max(1, (int)(size.x * scale));
+        r.h = std::max(1, (int)(size.y * scale));
+        r.x = bounds.x + (bounds.w - r.w) / 2;
+        r.y = bounds.y + (bounds.h - r.h) / 2;
+        return r;
+    }
+
+    std::vector<std::string> ReadList(const std::string& path)
+    {
+        std::ifstream file(path);
+        if (!file)
+            throw_error("Couldn't open the list of games to watch: " + path);
+
+        std::vector<std::string> paths;
+        std::string line;
+        while (std::getline(file, line)) {
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (!line.empty())
+                paths.push_back(line);
+        }
+        return paths;
+    }
+}
+
+//A game's place in the window.  Its recording is played to it on the polling
+//thread, and the render thread draws what changed.
+struct TiledViewer::Tile : public DisplayInterface
+{
+    Tile(TiledViewer* viewer, int index, const std::string& path) :
+        follower(path, this),
+        m_viewer(viewer),
+        m_index(index)
+    {
+    }
+
+    //display interface
+    virtual void SetDimensions(Coord dimensions) override
+    {
+        //a new recording, so everything is drawn again
+        std::lock_guard<std::mutex> lock(mutex);
+        shared.game = follower.GameName();
+        shared.dimensions = dimensions;
+        shared.data.assign(dimensions.x * dimensions.y, ' ');
+        shared.lines.assign(dimensions.y, Span());
+        shared.reopened = true;
+        Changed();
+    }
+
+    virtual void UpdateRegion(uint32_t* buf) override
+    {
+        Coord dimensions;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            dimensions = shared.dimensions;
+        }
+        UpdateRegion(buf, { 0, 0, short(dimensions.x - 1), short(dimensions.y - 1) });
+    }
+
+    //Keeps the cells that really changed, as a span on each line, so a whole
+    //screen that's mostly the same costs next to nothing to draw
+    virtual void UpdateRegion(uint32_t* buf, Region rect) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        int width = shared.dimensions.x;
+        bool changed = false;
+        for (int y = rect.Top; y <= rect.Bottom; ++y) {
+            const uint32_t* in = buf + y * width;
+            uint32_t* out = shared.data.data() + y * width;
+            int left = rect.Left, right = rect.Right;
+            while (left <= right && in[left] == out[left])
+                ++left;
+            while (right >= left && in[right] == out[right])
+                --right;
+            if (left > right)
+                continue;
+
+            memcpy(out + left, in + left, (right - left + 1) * sizeof(uint32_t));
+            Span& span = shared.lines[y];
+            span.left = std::min(span.left, left);
+            span.right = std::max(span.right, right);
+            changed = true;
+        }
+        if (changed)
+            Changed();
+    }
+
+    //the cursor isn't shown in a tile
+    virtual void MoveCursor(Coord pos) override {}
+    virtual void SetCursor(bool enable) override {}
+    virtual void PlaySound(const std::string& id) override {}
+
+    struct Span
+    {
+        int left = INT_MAX;
+        int right = -1;
+    };
+
+    RecordingFollower follower;
+
+    struct SharedData
+    {
+        std::string game;
+        Coord dimensions = { 0, 0 };
+        std::vector<uint32_t> data;
+        std::vector<Span> lines;  //cells changed since the render thread last drew
+        bool reopened = false;
+        bool queued = false;      //in the viewer's list of changed tiles
+    };
+    SharedData shared;
+    std::mutex mutex;
+
+    //owned by the render thread
+    std::string game;
+    Coord dimensions = { 0, 0 };
+    std::vector<uint32_t> frame;
+    std::vector<Span> lines;
+    ScreenRenderer* screen = 0;
+    SDL::Scoped::Texture texture = SDL::Scoped::Texture(nullptr, SDL_DestroyTexture);
+    Coord texture_size = { 0, 0 };
+    Uint32 last_drawn = 0;
+
+private:
+    //Called with the lock held
+    void Changed()
+    {
+        if (shared.queued)
+            return;
+        shared.queued = true;
+        m_viewer->TileChanged(m_index);
+    }
+
+    TiledViewer* m_viewer;
+    int m_index;
+};
+
+TiledViewer::TiledViewer(SDL_Window* window, SDL_Renderer* renderer, std::shared_ptr<Environment> current_env, const std::string& list_path) :
+    m_window(window),
+    m_renderer(renderer),
+    m_current_env(current_env),
+    m_sizer(window, renderer, current_env.get()),
+    m_timer_pending(false)
+{
+    std::vector<std::string> paths(ReadList(list_path));
+    if (paths.empty())
+        throw_error("There are no games to watch in " + list_path);
+    if ((int)paths.size() > kMaxTiles) {
+        std::ostringstream ss;
+        ss << "At most " << kMaxTiles << " games can be watched at once";
+        throw_error(ss.str());
+    }
+
+    std::string value;
+    if (m_current_env->Get("watch_interval", &value) && atoi(value.c_str()) >= 0)
+        m_interval = atoi(value.c_str());
+
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(m_renderer, &info) != 0 || !(info.flags & SDL_RENDERER_TARGETTEXTURE))
+        throw_error("Watching games needs a renderer that can draw to textures");
+
+    //as many game windows as fit on the screen, but never bigger than one
+    int n = (int)paths.size();
+    m_grid.x = (int)std::ceil(std::sqrt((double)n));
+    m_grid.y = (n + m_grid.x - 1) / m_grid.x;
+    double scale = 1.0;
+    SDL_DisplayMode mode;
+    if (SDL_GetCurrentDisplayMode(0, &mode) == 0) {
+        scale = std::min(scale, mode.w * 0.9 / (m_grid.x * kWindowWidth));
+        scale = std::min(scale, mode.h * 0.9 / (m_grid.y * kWindowHeight));
+    }
+    m_tile_size = { std::max(1, (int)(kWindowWidth * scale)), std::max(1, (int)(kWindowHeight * scale)) };
+
+    Coord wall_size = { m_grid.x * m_tile_size.x, m_grid.y * m_tile_size.y };
+    m_wall.reset(SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, wall_size.x, wall_size.y));
+    if (!m_wall)
+        throw_error("SDL_CreateTexture");
+    SDL_SetRenderTarget(m_renderer, m_wall.get());
+    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
+    SDL_RenderClear(m_renderer);
+    SDL_SetRenderTarget(m_renderer, 0);
+
+    for (int i = 0; i < n; ++i)
+        m_tiles.emplace_back(new Tile(this, i, paths[i]));
+
+    m_sizer.SetWindowSize(wall_size.x, wall_size.y);
+    UpdateTitle();
+    SDL_ShowWindow(m_window);
+}
+
+TiledViewer::~TiledViewer()
+{
+}
+
+void TiledViewer::Run()
+{
+    RENDER_EVENT = SDL_RegisterEvents(1);
+    std::thread polling(&TiledViewer::Poll, this);
+    Present();
+
+    SDL_Event e;
+    while (SDL_WaitEvent(&e)) {
+        if (e.type == SDL_QUIT)
+            break;
+        HandleEvent(e);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_cv.notify_all();
+    }
+    polling.join();
+}
+
+//Runs on its own thread, playing what's new in each recording to its tile
+void TiledViewer::Poll()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop) {
+        lock.unlock();
+        for (auto& tile : m_tiles)
+            tile->follower.Poll();
+        lock.lock();
+        m_cv.wait_for(lock, std::chrono::milliseconds(kPollInterval), [this] { return m_stop; });
+    }
+}
+
+//Called with the tile's lock held
+void TiledViewer::TileChanged(int i)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_changed.push_back(i);
+    PostRender();
+}
+
+//Asks for a render, unless one is already on its way.  Called with m_mutex held.
+void TiledViewer::PostRender()
+{
+    if (m_render_posted)
+        return;
+    m_render_posted = true;
+
+    SDL_Event e;
+    SDL_zero(e);
+    e.type = RENDER_EVENT;
+    SDL_PushEvent(&e);
+}
+
+Uint32 TiledViewer::OnTimer(Uint32 interval, void* param)
+{
+    TiledViewer* viewer = static_cast<TiledViewer*>(param);
+    viewer->m_timer_pending = false;
+    std::lock_guard<std::mutex> lock(viewer->m_mutex);
+    viewer->PostRender();
+    return 0;
+}
+
+bool TiledViewer::HandleEvent(const SDL_Event& e)
+{
+    if (e.type == RENDER_EVENT) {
+        Render();
+        return true;
+    }
+
+    switch (e.type) {
+    case SDL_WINDOWEVENT:
+        if (e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED || e.window.event == SDL_WINDOWEVENT_EXPOSED) {
+            Present();
+            return true;
+        }
+        break;
+
+    //textures that were drawn to are lost along with the device
+    case SDL_RENDER_TARGETS_RESET:
+    case SDL_RENDER_DEVICE_RESET:
+        RedrawAll();
+        return true;
+
+    case SDL_MOUSEBUTTONDOWN:
+        if (e.button.button == SDL_BUTTON_LEFT) {
+            Focus(m_focus >= 0 ? -1 : TileAt(e.button.x, e.button.y));
+            return true;
+        }
+        break;
+
+    case SDL_KEYDOWN:
+        if (m_sizer.ConsumeEvent(e))
+            return true;
+        if (e.key.keysym.sym == SDLK_ESCAPE && m_focus >= 0) {
+            Focus(-1);
+            return true;
+        }
+        break;
+    }
+    return false;
+}
+
+//Draws the tiles that changed, except those drawn too recently, which are
+//left for a timer to come back to
+void TiledViewer::Render()
+{
+    std::vector<int> changed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_render_posted = false;
+        changed.swap(m_changed);
+    }
+    changed.insert(changed.end(), m_waiting.begin(), m_waiting.end());
+    m_waiting.clear();
+
+    Uint32 now = SDL_GetTicks();
+    Uint32 wait = UINT_MAX;
+    bool drawn = false;
+    for (int i : changed) {
+        Uint32 interval = i == m_focus ? 0 : m_interval;
+        Uint32 since = now - m_tiles[i]->last_drawn;
+        if (since < interval) {
+            m_waiting.push_back(i);
+            wait = std::min(wait, interval - since);
+            continue;
+        }
+        drawn |= DrawTile(i, false);
+    }
+
+    if (!m_waiting.empty() && !m_timer_pending.exchange(true))
+        SDL_AddTimer(wait, OnTimer, this);
+    if (drawn)
+        Present();
+}
+
+//Draws what changed in a tile into its texture, and the texture into its place
+//on the wall.  Returns false if there's nothing to show yet.
+bool TiledViewer::DrawTile(int i, bool force)
+{
+    Tile& tile = *m_tiles[i];
+    bool reopened;
+    {
+        std::lock_guard<std::mutex> lock(tile.mutex);
+        tile.shared.queued = false;
+        reopened = tile.shared.reopened;
+        tile.shared.reopened = false;
+        if (reopened) {
+            tile.game = tile.shared.game;
+            tile.dimensions = tile.shared.dimensions;
+            tile.frame = tile.shared.data;
+            tile.lines.assign(tile.dimensions.y, Tile::Span());
+        }
+        else {
+            for (int y = 0; y < (int)tile.lines.size(); ++y) {
+                Tile::Span& span = tile.shared.lines[y];
+                if (span.left > span.right)
+                    continue;
+                int start = y * tile.dimensions.x + span.left;
+                memcpy(&tile.frame[start], &tile.shared.data[start], (span.right - span.left + 1) * sizeof(uint32_t));
+                tile.lines[y] = span;
+            }
+        }
+        std::fill(tile.shared.lines.begin(), tile.shared.lines.end(), Tile::Span());
+    }
+
+    if (reopened) {
+        tile.screen = GetScreen(tile.game, tile.dimensions);
+        Coord size = tile.screen->ScreenSize();
+        if (!tile.texture || !(size == tile.texture_size)) {
+            tile.texture.reset(SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, size.x, size.y));
+            if (!tile.texture)
+                throw_error("SDL_CreateTexture");
+            tile.texture_size = size;
+        }
+    }
+    if (!tile.screen)
+        return false;
+
+    SDL_SetRenderTarget(m_renderer, tile.texture.get());
+    if (reopened || force) {
+        Region all = { 0, 0, short(tile.dimensions.x - 1), short(tile.dimensions.y - 1) };
+        tile.screen->RenderRegion(tile.frame.data(), all);
+    }
+    else {
+        for (int y = 0; y < (int)tile.lines.size(); ++y) {
+            Tile::Span& span = tile.lines[y];
+            if (span.left > span.right)
+                continue;
+            tile.screen->RenderRegion(tile.frame.data(), { short(span.left), short(y), short(span.right), short(y) });
+        }
+    }
+    std::fill(tile.lines.begin(), tile.lines.end(), Tile::Span());
+
+    SDL_SetRenderTarget(m_renderer, m_wall.get());
+    SDL_Rect r = Fit(TileRect(i), tile.texture_size);
+    SDL_RenderCopy(m_renderer, tile.texture.get(), 0, &r);
+    SDL_SetRenderTarget(m_renderer, 0);
+
+    tile.last_drawn = SDL_GetTicks();
+    return true;
+}
+
+void TiledViewer::RedrawAll()
+{
+    SDL_SetRenderTarget(m_renderer, m_wall.get());
+    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
+    SDL_RenderClear(m_renderer);
+    SDL_SetRenderTarget(m_renderer, 0);
+    for (int i = 0; i < (int)m_tiles.size(); ++i)
+        DrawTile(i, true);
+    Present();
+}
+
+void TiledViewer::Present()
+{
+    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
+    SDL_RenderClear(m_renderer);
+
+    int w = 0, h = 0;
+    SDL_QueryTexture(m_wall.get(), 0, 0, &w, &h);
+    if (m_focus >= 0) {
+        Tile& tile = *m_tiles[m_focus];
+        if (tile.texture) {
+            SDL_Rect r = Fit({ 0, 0, w, h }, tile.texture_size);
+            SDL_RenderCopy(m_renderer, tile.texture.get(), 0, &r);
+        }
+    }
+    else {
+        SDL_RenderCopy(m_renderer, m_wall.get(), 0, 0);
+    }
+    SDL_RenderPresent(m_renderer);
+}
+
+void TiledViewer::Focus(int i)
+{
+    m_focus = i;
+    UpdateTitle();
+
+    //anything held back is drawn now the focused game isn't waiting
+    if (std::find(m_waiting.begin(), m_waiting.end(), i) != m_waiting.end()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        PostRender();
+    }
+    Present();
+}
+
+void TiledViewer::UpdateTitle()
+{
+    std::ostringstream ss;
+    ss << SdlRogue::kWindowTitle << " - ";
+    if (m_focus >= 0)
+        ss << m_tiles[m_focus]->follower.Path();
+    else
+        ss << "Watching " << m_tiles.size() << " games";
+    SDL_SetWindowTitle(m_window, ss.str().c_str());
+}
+
+//Versions this build doesn't know are drawn like the first one
+ScreenRenderer* TiledViewer::GetScreen(const std::string& game, Coord dimensions)
+{
+    std::ostringstream key;
+    key << game << " " << dimensions.x << "x" << dimensions.y;
+    std::unique_ptr<ScreenRenderer>& screen = m_screens[key.str()];
+    if (screen)
+        return screen.get();
+
+    auto options = std::find_if(s_options.begin(), s_options.end(), [&](const GameConfig& cfg) {
+        return cfg.name == game;
+    });
+    if (options == s_options.end())
+        options = s_options.begin();
+
+    int gfx_mode = 0;
+    std::string gfx_pref;
+    if (m_current_env->Get("gfx", &gfx_pref)) {
+        for (int i = 0; i < (int)options->gfx_options.size(); ++i) {
+            if (options->gfx_options[i].name == gfx_pref) {
+                gfx_mode = i;
+                break;
+            }
+        }
+    }
+    screen.reset(new ScreenRenderer(m_renderer, options->gfx_options[gfx_mode], dimensions));
+    return screen.get();
+}
+
+SDL_Rect TiledViewer::TileRect(int i) const
+{
+    SDL_Rect r;
+    r.x = (i % m_grid.x) * m_tile_size.x;
+    r.y = (i / m_grid.x) * m_tile_size.y;
+    r.w = m_tile_size.x;
+    r.h = m_tile_size.y;
+    return r;
+}
+
+int TiledViewer::TileAt(int x, int y) const
+{
+    if (x < 0 || y < 0)
+        return -1;
+    int i = (y / m_tile_size.y) * m_grid.x + x / m_tile_size.x;
+    if (x / m_tile_size.x >= m_grid.x || i >= (int)m_tiles.size())
+        return -1;
+    return i;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <SDL.h>
+#include <coord.h>
+#include "sdl_utility.h"
+#include "window_sizer.h"
+
+struct Environment;
+struct ScreenRenderer;
+
+//Watches many games at once in one window, by following the screen
+//recordings they're making.  Each game has a tile, which is the display its
+//recording is played to and a texture it's drawn into.  Tiles share one
+//renderer, and so one set of glyph textures, for each version and screen
+//size.  Only the cells that changed are drawn, and a tile is drawn at most
+//once every watch_interval ms, so the work follows how much the games change
+//rather than how many there are.  Clicking a tile shows that game at full
+//size until the next click.
+struct TiledViewer
+{
+    TiledViewer(SDL_Window* window, SDL_Renderer* renderer, std::shared_ptr<Environment> current_env, const std::string& list_path);
+    ~TiledViewer();
+
+    void Run();
+
+    static const int kMaxTiles = 64;
+    static const int kPollInterval = 100;
+    static const int kDefaultInterval = 250;
+
+private:
+    struct Tile;
+
+    void Poll();
+    void TileChanged(int i);
+    void PostRender();
+    static Uint32 OnTimer(Uint32 interval, void* param);
+
+    bool HandleEvent(const SDL_Event& e);
+    void Render();
+    bool DrawTile(int i, bool force);
+    void RedrawAll();
+    void Present();
+    void Focus(int i);
+    void UpdateTitle();
+
+    ScreenRenderer* GetScreen(const std::string& game, Coord dimensions);
+    SDL_Rect TileRect(int i) const;
+    int TileAt(int x, int y) const;
+
+private:
+    SDL_Window* m_window = 0;
+    SDL_Renderer* m_renderer = 0;
+    std::shared_ptr<Environment> m_current_env;
+    WindowSizer m_sizer;
+
+    std::vector<std::unique_ptr<Tile>> m_tiles;
+    Coord m_grid = { 0, 0 };       //tiles across and down
+    Coord m_tile_size = { 0, 0 };  //the space each tile has in the window
+    Uint32 m_interval = kDefaultInterval;
+    SDL::Scoped::Texture m_wall = SDL::Scoped::Texture(nullptr, SDL_DestroyTexture);  //every tile at its size in the window
+
+    //one for each version and screen size, shared by its tiles
+    std::map<std::string, std::unique_ptr<ScreenRenderer>> m_screens;
+
+    //tiles changed since the render thread last looked
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<int> m_changed;
+    bool m_render_posted = false;
+    bool m_stop = false;
+
+    //owned by the render thread
+    std::vector<int> m_waiting;         //changed tiles drawn too recently to draw again yet
+    std::atomic<bool> m_timer_pending;  //a render is coming for them
+    int m_focus = -1;
+};
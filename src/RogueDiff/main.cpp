@@ -0,0 +1,432 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <vec_gym_env.h>
+
+//Plays the same seeds and keys through an old and a new build of an engine
+//and checks that they stay identical, key by key: the screen, whether the
+//game has ended, and how many random numbers it has drawn.  Any seed that
+//goes wrong has its keys cut down to a short input that still shows it.
+//
+//Each build plays a batch of seeds side by side in a gym, and the two builds
+//play each key at the same time.
+
+namespace
+{
+    const int kLines = VecGymEnv::kLines;
+    const int kColumns = VecGymEnv::kColumns;
+    const char kFiller = '\x1b';
+
+    //Keys that play without saving, quitting, or leaving the game
+    const char* const kDefaultKeys =
+        "hjklyubnhjklyubnHJKLYUBNs.s. \n\x1b"
+        "ieqrwWtTPRdzf<>abcdefgh";
+
+    struct Options
+    {
+        std::vector<std::string> libraries;  //old and new, in pairs
+        int first = 1;
+        int count = 100;
+        int steps = 2000;
+        std::string keys = kDefaultKeys;
+        std::string script;
+        bool has_script = false;
+        int threads = 0;
+        bool minimize = true;
+    };
+
+    void throw_error(const std::string& msg)
+    {
+        throw std::runtime_error(msg);
+    }
+
+    void Usage()
+    {
+        fprintf(stderr,
+            "usage: RogueDiff <old library> <new library> [<old library> <new library> ...]\n"
+            "                 [--first n] [--count n] [--steps n] [--keys s] [--script file] [--threads n] [--no-minimize]\n"
+            "  --first        first seed (default 1)\n"
+            "  --count        number of seeds (default 100)\n"
+            "  --steps        keys per game (default 2000)\n"
+            "  --keys         keys to pick each game's input from, with C escapes\n"
+            "  --script       play the keys in a file, with C escapes, for every seed\n"
+            "  --threads      games each build plays side by side (default: one per core)\n"
+            "  --no-minimize  report differences without cutting down their input\n");
+        exit(1);
+    }
+
+    //Reads \n, \t, \e, \\ and \xhh, and leaves every other character as it is
+    std::string Unescape(const std::string& s)
+    {
+        std::string keys;
+        for (size_t i = 0; i < s.size(); ++i) {
+            char c = s[i];
+            if (c == '\r' || c == '\n')
+                continue;
+            if (c == '\\' && i + 1 < s.size()) {
+                c = s[++i];
+                if (c == 'n')
+                    c = '\n';
+                else if (c == 't')
+                    c = '\t';
+                else if (c == 'e')
+                    c = '\x1b';
+                else if (c == 'x' && i + 2 < s.size()) {
+                    c = (char)strtol(s.substr(i + 1, 2).c_str(), nullptr, 16);
+                    i += 2;
+                }
+            }
+            keys += c;
+        }
+        return keys;
+    }
+
+    std::string Escape(const std::string& keys)
+    {
+        std::string s;
+        char buf[8];
+        for (char c : keys) {
+            if (c == '\n')
+                s += "\\n";
+            else if (c == '\t')
+                s += "\\t";
+            else if (c == '\x1b')
+                s += "\\e";
+            else if (c == '\\')
+                s += "\\\\";
+            else if (c < ' ' || c > '~') {
+                sprintf(buf, "\\x%02x", (unsigned char)c);
+                s += buf;
+            }
+            else
+                s += c;
+        }
+        return s;
+    }
+
+    Options ParseArgs(int argc, char** argv)
+    {
+        Options o;
+        for (int i = 1; i < argc; ++i) {
+            std::string s(argv[i]);
+            bool has_value = i + 1 < argc;
+            if (s == "--first" && has_value)
+                o.first = atoi(argv[++i]);
+            else if (s == "--count" && has_value)
+                o.count = atoi(argv[++i]);
+            else if (s == "--steps" && has_value)
+                o.steps = atoi(argv[++i]);
+            else if (s == "--keys" && has_value)
+                o.keys = Unescape(argv[++i]);
+            else if (s == "--script" && has_value) {
+                std::ifstream in(argv[++i], std::ios::binary);
+                if (!in)
+                    Usage();
+                std::stringstream text;
+                text << in.rdbuf();
+                o.script = Unescape(text.str());
+                o.has_script = true;
+            }
+            else if (s == "--threads" && has_value)
+                o.threads = atoi(argv[++i]);
+            else if (s == "--no-minimize")
+                o.minimize = false;
+            else if (s[0] != '-')
+                o.libraries.push_back(s);
+            else
+                Usage();
+        }
+        if (o.libraries.empty() || o.libraries.size() % 2 != 0 || o.count <= 0 || o.steps <= 0 || o.keys.empty())
+            Usage();
+        if (o.has_script && o.script.empty())
+            Usage();
+        if (o.threads <= 0)
+            o.threads = std::max(1u, std::thread::hardware_concurrency());
+        o.threads = std::min(o.threads, o.count);
+        return o;
+    }
+
+    //The same keys for a seed on every run and every platform
+    std::string MakeScript(const Options& o, int seed)
+    {
+        if (o.has_script)
+            return o.script;
+        std::mt19937 gen((unsigned int)seed);
+        std::string keys(o.steps, 0);
+        for (auto& c : keys)
+            c = o.keys[gen() % o.keys.size()];
+        return keys;
+    }
+
+    //How a game played in both builds
+    struct Divergence
+    {
+        int step = -1;       //the key after which they first differed, or -1
+        int row = -1;        //the first screen row that differed, or -1
+        std::string old_row;
+        std::string new_row;
+        bool old_done = false;
+        bool new_done = false;
+        unsigned int old_draws = 0;
+        unsigned int new_draws = 0;
+    };
+
+    std::string RowText(const uint32_t* screen, int row)
+    {
+        std::string s;
+        for (int x = 0; x < kColumns; ++x) {
+            uint32_t c = screen[row * kColumns + x] & 0xff;
+            s += (c >= ' ' && c <= '~') ? (char)c : '?';
+        }
+        while (!s.empty() && s.back() == ' ')
+            s.pop_back();
+        return s;
+    }
+
+    //An old and a new build, each with a batch of games played key for key
+    //in lockstep
+    class Pair
+    {
+    public:
+        Pair(const std::string& old_library, const std::string& new_library, int count) :
+            m_old(old_library, count, ""),
+            m_new(new_library, count, ""),
+            m_draws(true)
+        {
+        }
+
+        int Count() const { return m_old.Count(); }
+        bool ComparesDraws() const { return m_draws; }
+
+        //Play script i from seed i in game i of both builds, and find where
+        //each first differs.  There can be fewer scripts than games.
+        std::vector<Divergence> Play(const std::vector<int>& seeds, const std::vector<std::string>& scripts)
+        {
+            int n = (int)scripts.size();
+            std::vector<Divergence> results(n);
+            std::vector<bool> decided(Count(), true);
+            size_t longest = 0;
+            for (int i = 0; i < n; ++i) {
+                decided[i] = false;
+                longest = std::max(longest, scripts[i].size());
+            }
+
+            //games without a script just get filler keys
+            Both([&](VecGymEnv& env) {
+                for (int i = 0; i < n; ++i)
+                    env.Reset(i, seeds[i]);
+            });
+
+            std::vector<char> keys(Count());
+            for (size_t step = 0; step < longest; ++step) {
+                int playing = 0;
+                for (int i = 0; i < Count(); ++i) {
+                    if (!decided[i] && step >= scripts[i].size())
+                        decided[i] = true;
+                    keys[i] = decided[i] ? kFiller : scripts[i][step];
+                    playing += !decided[i];
+                }
+                if (playing == 0)
+                    break;
+
+                Both([&](VecGymEnv& env) { env.Step(keys.data()); });
+                for (int i = 0; i < n; ++i) {
+                    if (!decided[i] && Compare(i, results[i])) {
+                        results[i].step = (int)step;
+                        decided[i] = true;
+                    }
+                    else if (!decided[i] && m_old.Done()[i])
+                        decided[i] = true;
+                }
+            }
+            return results;
+        }
+
+    private:
+        //Runs f on both builds at once
+        template <typename F>
+        void Both(F f)
+        {
+            std::string error;
+            std::thread old_thread([&] {
+                try {
+                    f(m_old);
+                }
+                catch (const std::exception& e) {
+                    error = e.what();
+                }
+            });
+            f(m_new);
+            old_thread.join();
+            if (!error.empty())
+                throw_error(error);
+        }
+
+        //Returns true if game i differs between the builds, and says how
+        bool Compare(int i, Divergence& d)
+        {
+            const uint32_t* old_screen = m_old.Screen(i);
+            const uint32_t* new_screen = m_new.Screen(i);
+            d.old_done = m_old.Done()[i] != 0;
+            d.new_done = m_new.Done()[i] != 0;
+            bool differs = d.old_done != d.new_done;
+
+            if (memcmp(old_screen, new_screen, kLines * kColumns * sizeof(uint32_t)) != 0) {
+                differs = true;
+                for (int y = 0; y < kLines && d.row < 0; ++y) {
+                    if (memcmp(old_screen + y * kColumns, new_screen + y * kColumns, kColumns * sizeof(uint32_t)) != 0) {
+                        d.row = y;
+                        d.old_row = RowText(old_screen, y);
+                        d.new_row = RowText(new_screen, y);
+                    }
+                }
+            }
+
+            //a build from before the engines counted their draws can still
+            //be compared on everything else
+            if (m_draws && !d.old_done && !d.new_done) {
+                try {
+                    d.old_draws = m_old.RandomDraws(i);
+                    d.new_draws = m_new.RandomDraws(i);
+                    differs = differs || d.old_draws != d.new_draws;
+                }
+                catch (const std::exception& e) {
+                    fprintf(stderr, "%s, so random numbers won't be compared\n", e.what());
+                    m_draws = false;
+                }
+            }
+            return differs;
+        }
+
+        VecGymEnv m_old;
+        VecGymEnv m_new;
+        bool m_draws;
+    };
+
+    //Cuts keys down to a shorter input that still makes the builds differ,
+    //trying the pieces of each cut side by side in the pair's games
+    std::string Minimize(Pair& pair, int seed, std::string keys)
+    {
+        int chunks = 2;
+        while (keys.size() >= 2) {
+            //every piece on its own, then everything but each piece
+            std::vector<std::string> candidates;
+            size_t size = keys.size();
+            for (int i = 0; i < chunks; ++i) {
+                size_t start = size * i / chunks, end = size * (i + 1) / chunks;
+                candidates.push_back(keys.substr(start, end - start));
+            }
+            for (int i = 0; i < chunks; ++i) {
+                size_t start = size * i / chunks, end = size * (i + 1) / chunks;
+                candidates.push_back(keys.substr(0, start) + keys.substr(end));
+            }
+
+            int found = -1;
+            Divergence found_result;
+            for (size_t batch = 0; batch < candidates.size() && found < 0; batch += pair.Count()) {
+                size_t batch_end = std::min(candidates.size(), batch + pair.Count());
+                std::vector<std::string> scripts(candidates.begin() + batch, candidates.begin() + batch_end);
+                std::vector<int> seeds(scripts.size(), seed);
+                std::vector<Divergence> results = pair.Play(seeds, scripts);
+                for (size_t i = 0; i < results.size() && found < 0; ++i) {
+                    if (results[i].step >= 0) {
+                        found = int(batch + i);
+                        found_result = results[i];
+                    }
+                }
+            }
+
+            if (found >= 0) {
+                //nothing after the first difference is needed
+                keys = candidates[found].substr(0, found_result.step + 1);
+                chunks = found < chunks ? 2 : std::max(chunks - 1, 2);
+            }
+            else if (chunks >= (int)keys.size())
+                break;
+            else
+                chunks = std::min(chunks * 2, (int)keys.size());
+        }
+        return keys;
+    }
+
+    void Report(const std::string& library, int seed, const Divergence& d, const std::string& keys, bool draws)
+    {
+        if (d.step < 0) {
+            printf("%s: seed %d differs, but not every time\n  keys (%d): %s\n",
+                library.c_str(), seed, (int)keys.size(), Escape(keys).c_str());
+            return;
+        }
+        printf("%s: seed %d differs after key %d\n", library.c_str(), seed, d.step + 1);
+        if (d.row >= 0)
+            printf("  line %d\n    old: %s\n    new: %s\n", d.row, d.old_row.c_str(), d.new_row.c_str());
+        if (d.old_done != d.new_done)
+            printf("  the game ended in the %s build only\n", d.old_done ? "old" : "new");
+        if (draws && d.old_draws != d.new_draws)
+            printf("  random numbers drawn: old %u, new %u\n", d.old_draws, d.new_draws);
+        printf("  keys (%d): %s\n", (int)keys.size(), Escape(keys).c_str());
+        fflush(stdout);
+    }
+
+    //Returns how many seeds the builds differed on
+    int Check(const Options& o, const std::string& old_library, const std::string& new_library)
+    {
+        Pair pair(old_library, new_library, o.threads);
+        int failures = 0;
+        for (int n = 0; n < o.count; n += pair.Count()) {
+            int batch = std::min(pair.Count(), o.count - n);
+            std::vector<int> seeds(batch);
+            std::vector<std::string> scripts(batch);
+            for (int i = 0; i < batch; ++i) {
+                seeds[i] = o.first + n + i;
+                scripts[i] = MakeScript(o, seeds[i]);
+            }
+
+            std::vector<Divergence> results = pair.Play(seeds, scripts);
+            for (int i = 0; i < batch; ++i) {
+                if (results[i].step < 0)
+                    continue;
+                ++failures;
+                std::string keys = scripts[i].substr(0, results[i].step + 1);
+                Divergence d = results[i];
+                if (o.minimize) {
+                    keys = Minimize(pair, seeds[i], keys);
+                    d = pair.Play({ seeds[i] }, { keys })[0];
+                }
+                Report(new_library, seeds[i], d, keys, pair.ComparesDraws());
+            }
+        }
+        return failures;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options o = ParseArgs(argc, argv);
+
+    int failures = 0;
+    try {
+        for (size_t i = 0; i < o.libraries.size(); i += 2) {
+            const std::string& old_library = o.libraries[i];
+            const std::string& new_library = o.libraries[i + 1];
+            int differ = Check(o, old_library, new_library);
+            fprintf(stderr, "%s against %s: %d of %d seeds differ\n",
+                new_library.c_str(), old_library.c_str(), differ, o.count);
+            failures += differ;
+        }
+    }
+    catch (const std::runtime_error& e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return failures ? 1 : 0;
+}
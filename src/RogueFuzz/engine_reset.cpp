@@ -0,0 +1,291 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <link.h>
+#include <malloc.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "engine_reset.h"
+
+static_assert(sizeof(void*) == 8, "EngineReset reads 64-bit ELF relocations");
+
+void throw_error(const std::string& msg);
+
+namespace
+{
+    //Everything the engine allocates during a game, handed out in order and
+    //thrown away all at once
+    struct Arena
+    {
+        char* base = nullptr;
+        size_t size = 0;
+        size_t used = 0;
+    };
+    Arena s_arena;
+
+    //Kept in front of each block, so realloc knows how much to copy
+    struct alignas(16) BlockHeader
+    {
+        size_t size;
+    };
+
+    bool InArena(const void* p)
+    {
+        return p >= s_arena.base && p < s_arena.base + s_arena.size;
+    }
+
+    void* ArenaAlloc(size_t n)
+    {
+        size_t total = (sizeof(BlockHeader) + n + 15) & ~size_t(15);
+        if (n > s_arena.size || total > s_arena.size - s_arena.used) {
+            fprintf(stderr, "==RogueFuzz: the engine allocated more than %zu MB in one game\n", s_arena.size >> 20);
+            abort();
+        }
+        BlockHeader* h = (BlockHeader*)(s_arena.base + s_arena.used);
+        h->size = n;
+        s_arena.used += total;
+        return h + 1;
+    }
+
+    void* Malloc(size_t n)
+    {
+        return ArenaAlloc(n);
+    }
+
+    void* Calloc(size_t count, size_t n)
+    {
+        if (n && count > s_arena.size / n)
+            return nullptr;
+        //the arena is used again for every game, so it isn't zero to begin with
+        void* p = ArenaAlloc(count * n);
+        memset(p, 0, count * n);
+        return p;
+    }
+
+    void* Realloc(void* p, size_t n)
+    {
+        if (!p)
+            return ArenaAlloc(n);
+        //a block from before the arena was set up is left where it is, since
+        //the saved globals can still point at it
+        size_t old = InArena(p) ? ((BlockHeader*)p - 1)->size : malloc_usable_size(p);
+        void* q = ArenaAlloc(n);
+        memcpy(q, p, std::min(old, n));
+        return q;
+    }
+
+    //Nothing goes back until the game is over
+    void Free(void*)
+    {
+    }
+
+    char* Strdup(const char* s)
+    {
+        size_t n = strlen(s) + 1;
+        return (char*)memcpy(ArenaAlloc(n), s, n);
+    }
+
+    void* NewNothrow(size_t n, const std::nothrow_t&)
+    {
+        return ArenaAlloc(n);
+    }
+
+    void SizedFree(void*, size_t)
+    {
+    }
+
+    //The engines set signal handlers at the start of a game, which would
+    //outlast it and take over from the fuzzer's own, so they're ignored
+    sighandler_t Signal(int, sighandler_t)
+    {
+        return SIG_DFL;
+    }
+
+    int Sigaction(int, const struct sigaction*, struct sigaction* old)
+    {
+        if (old) {
+            memset(old, 0, sizeof(*old));
+            old->sa_handler = SIG_DFL;
+        }
+        return 0;
+    }
+
+    struct Hook
+    {
+        const char* name;
+        void* function;
+    };
+
+    const Hook kHooks[] = {
+        { "malloc", (void*)&Malloc },
+        { "calloc", (void*)&Calloc },
+        { "realloc", (void*)&Realloc },
+        { "free", (void*)&Free },
+        { "strdup", (void*)&Strdup },
+        { "_Znwm", (void*)&Malloc },                  //operator new
+        { "_Znam", (void*)&Malloc },                  //operator new[]
+        { "_ZnwmRKSt9nothrow_t", (void*)&NewNothrow },
+        { "_ZnamRKSt9nothrow_t", (void*)&NewNothrow },
+        { "_ZdlPv", (void*)&Free },                   //operator delete
+        { "_ZdaPv", (void*)&Free },                   //operator delete[]
+        { "_ZdlPvm", (void*)&SizedFree },
+        { "_ZdaPvm", (void*)&SizedFree },
+        { "signal", (void*)&Signal },
+        { "sigaction", (void*)&Sigaction },
+    };
+
+    //Where a library is loaded
+    struct Module
+    {
+        void* entry = nullptr;
+        ElfW(Addr) bias = 0;
+        const ElfW(Phdr)* phdr = nullptr;
+        int phnum = 0;
+    };
+
+    int FindModule(dl_phdr_info* info, size_t, void* data)
+    {
+        Module* m = (Module*)data;
+        ElfW(Addr) entry = (ElfW(Addr))m->entry;
+        for (int i = 0; i < info->dlpi_phnum; ++i) {
+            const ElfW(Phdr)& ph = info->dlpi_phdr[i];
+            ElfW(Addr) start = info->dlpi_addr + ph.p_vaddr;
+            if (ph.p_type == PT_LOAD && entry >= start && entry < start + ph.p_memsz) {
+                m->bias = info->dlpi_addr;
+                m->phdr = info->dlpi_phdr;
+                m->phnum = info->dlpi_phnum;
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    void MakeWritable(void* p)
+    {
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        char* start = (char*)((ElfW(Addr))p & ~(page - 1));
+        if (mprotect(start, page, PROT_READ | PROT_WRITE) != 0)
+            throw_error("Couldn't make the engine's imports writable");
+    }
+
+    //Points the library's imports of the allocator at the arena, and of signal at nothing
+    void HookAllocator(const Module& m)
+    {
+        const ElfW(Dyn)* dyn = nullptr;
+        for (int i = 0; i < m.phnum; ++i) {
+            if (m.phdr[i].p_type == PT_DYNAMIC)
+                dyn = (const ElfW(Dyn)*)(m.bias + m.phdr[i].p_vaddr);
+        }
+        if (!dyn)
+            throw_error("The engine library has no dynamic section");
+
+        //glibc rewrites these as addresses, other loaders leave them relative to the library
+        auto address = [&](ElfW(Addr) a) { return a < m.bias ? a + m.bias : a; };
+        const ElfW(Sym)* symtab = nullptr;
+        const char* strtab = nullptr;
+        const ElfW(Rela)* tables[2] = {};
+        size_t sizes[2] = {};
+        for (const ElfW(Dyn)* d = dyn; d->d_tag != DT_NULL; ++d) {
+            switch (d->d_tag) {
+            case DT_SYMTAB: symtab = (const ElfW(Sym)*)address(d->d_un.d_ptr); break;
+            case DT_STRTAB: strtab = (const char*)address(d->d_un.d_ptr); break;
+            case DT_RELA: tables[0] = (const ElfW(Rela)*)address(d->d_un.d_ptr); break;
+            case DT_RELASZ: sizes[0] = d->d_un.d_val; break;
+            case DT_JMPREL: tables[1] = (const ElfW(Rela)*)address(d->d_un.d_ptr); break;
+            case DT_PLTRELSZ: sizes[1] = d->d_un.d_val; break;
+            }
+        }
+        if (!symtab || !strtab)
+            throw_error("The engine library has no symbol table");
+
+        for (int t = 0; t < 2; ++t) {
+            for (size_t i = 0; tables[t] && i < sizes[t] / sizeof(ElfW(Rela)); ++i) {
+                const ElfW(Rela)& r = tables[t][i];
+                size_t sym = ELF64_R_SYM(r.r_info);
+                if (sym == 0 || r.r_addend != 0)
+                    continue;
+                const char* name = strtab + symtab[sym].st_name;
+                for (const Hook& hook : kHooks) {
+                    if (strcmp(name, hook.name) == 0) {
+                        void** slot = (void**)(m.bias + r.r_offset);
+                        MakeWritable(slot);
+                        *slot = hook.function;
+                    }
+                }
+            }
+        }
+    }
+}
+
+EngineReset::EngineReset(void* entry, size_t arena_size)
+{
+    if (s_arena.base)
+        throw_error("Only one engine can be reset in a process");
+
+    Module m;
+    m.entry = entry;
+    if (!dl_iterate_phdr(&FindModule, &m))
+        throw_error("Couldn't find the engine library in memory");
+
+    void* base = mmap(nullptr, arena_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED)
+        throw_error("Couldn't reserve the engine's arena");
+    s_arena.base = (char*)base;
+    s_arena.size = arena_size;
+    HookAllocator(m);
+
+    //what's left writable once relocation is done is what the game can
+    //change; the part made read-only after relocation is left out
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    ElfW(Addr) relro_start = 0, relro_end = 0;
+    for (int i = 0; i < m.phnum; ++i) {
+        const ElfW(Phdr)& ph = m.phdr[i];
+        if (ph.p_type == PT_GNU_RELRO) {
+            relro_start = (m.bias + ph.p_vaddr) & ~(page - 1);
+            relro_end = (m.bias + ph.p_vaddr + ph.p_memsz) & ~(page - 1);
+        }
+    }
+    for (int i = 0; i < m.phnum; ++i) {
+        const ElfW(Phdr)& ph = m.phdr[i];
+        if (ph.p_type != PT_LOAD || !(ph.p_flags & PF_W))
+            continue;
+        ElfW(Addr) start = m.bias + ph.p_vaddr;
+        ElfW(Addr) end = start + ph.p_memsz;
+        ElfW(Addr) pieces[2][2] = {
+            { start, std::min(end, relro_start) },
+            { std::max(start, relro_end), end },
+        };
+        for (auto& piece : pieces) {
+            if (piece[0] >= piece[1])
+                continue;
+            Segment s;
+            s.start = (char*)piece[0];
+            s.saved.assign(s.start, s.start + (piece[1] - piece[0]));
+            m_segments.push_back(std::move(s));
+        }
+    }
+}
+
+void EngineReset::Restore()
+{
+    for (Segment& s : m_segments)
+        memcpy(s.start, s.saved.data(), s.saved.size());
+    s_arena.used = 0;
+}
+
+size_t EngineReset::ArenaUsed() const
+{
+    return s_arena.used;
+}
+
+size_t EngineReset::SavedSize() const
+{
+    size_t size = 0;
+    for (const Segment& s : m_segments)
+        size += s.saved.size();
+    return size;
+}
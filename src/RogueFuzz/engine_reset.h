@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+//Puts an engine library that is already loaded back the way it was when this
+//was made, without loading it again.  The engines keep the whole game in
+//globals, so copying the library's writable segments back is enough to start
+//a new game from scratch.  What they allocate is kept in an arena instead of
+//on the heap: the library's imports of the allocator are pointed at it, and
+//Restore empties it, so a game that's abandoned part way through doesn't leak.
+//Signal handlers the engine sets are ignored, since nothing would undo them.
+//
+//Only one engine can be reset this way in a process.  Linux only.
+class EngineReset
+{
+public:
+    //entry is any function in the library; arena_size is the most a game can allocate
+    EngineReset(void* entry, size_t arena_size);
+
+    //Start over from the state the library was in when this was made
+    void Restore();
+
+    //Bytes of the arena the game since the last Restore has used
+    size_t ArenaUsed() const;
+
+    //Bytes copied back by each Restore
+    size_t SavedSize() const;
+
+private:
+    struct Segment
+    {
+        char* start;
+        std::vector<char> saved;
+    };
+    std::vector<Segment> m_segments;
+};
@@ -0,0 +1,447 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <display_interface.h>
+#include <input_interface.h>
+#include "engine_reset.h"
+
+//A fuzz target that plays an engine on keys made up by a fuzzer, in the
+//fuzzer's own process.  The engine library is loaded once, and
+//EngineReset puts it back the way it was before every input, so each input is
+//a whole game from the start.  The first four bytes of an input are the
+//game's seed and the rest are its keys; a game ends when they run out.
+//
+//Built with libFuzzer it's coverage guided, if the engine library was built
+//with -fsanitize=fuzzer-no-link; "make LIBFUZZER=1" builds both that way.
+//Built with -DROGUE_FUZZ_DRIVER instead, as a plain "make" does, it has a
+//driver of its own, which replays a corpus and then plays random changes to
+//it, with no coverage.
+//
+//ROGUE_FUZZ_ENGINE names the engine library.  As well as crashes, it stops on
+//a hang, a game that runs for longer than ROGUE_FUZZ_HANG_MS (default 1000)
+//or keeps polling for keys without ever waiting for one, and it reports each
+//new slowest game that takes longer than ROGUE_FUZZ_SLOW_MS (default 50).
+//The input is written to hang-<hash>, slow-<hash>, or with the driver,
+//crash-<hash>.  ROGUE_FUZZ_ARENA_MB (default 256) is the most one game can
+//allocate.  Linux only.
+
+typedef int(*game_main_fn)(int, char**, char**);
+typedef void(*init_game_fn)(DisplayInterface*, InputInterface*, int lines, int cols);
+
+void throw_error(const std::string& msg)
+{
+    throw std::runtime_error(msg);
+}
+
+DisplayInterface::~DisplayInterface() {}
+InputInterface::~InputInterface() {}
+
+namespace
+{
+    const int kLines = 25;
+    const int kColumns = 80;
+    const int kSeedBytes = 4;
+    const int kMaxPolls = 1000000;
+
+    //Thrown out of GetChar to unwind a game whose keys have run out
+    struct OutOfKeys {};
+
+    //The input being played, where a report can get at it
+    const uint8_t* s_input = nullptr;
+    size_t s_input_size = 0;
+
+    //Writes the input being played to <kind>-<hash>.  Safe in a signal handler.
+    void SaveInput(const char* kind)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < s_input_size; ++i)
+            hash = (hash ^ s_input[i]) * 1099511628211ull;
+
+        char name[64];
+        size_t n = 0;
+        while (*kind && n < 40)
+            name[n++] = *kind++;
+        name[n++] = '-';
+        for (int i = 60; i >= 0; i -= 4)
+            name[n++] = "0123456789abcdef"[(hash >> i) & 0xf];
+        name[n] = 0;
+
+        int fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0) {
+            if (write(fd, s_input, s_input_size) < 0) {}
+            close(fd);
+        }
+        const char* msg = "==RogueFuzz: input written to ";
+        if (write(2, msg, strlen(msg)) < 0 || write(2, name, n) < 0 || write(2, "\n", 1) < 0) {}
+    }
+
+    std::atomic<bool> s_hung(false);
+
+    void ReportHang(const char* why)
+    {
+        s_hung = true;
+        fprintf(stderr, "==RogueFuzz: hang: %s\n", why);
+        SaveInput("hang");
+        abort();
+    }
+
+    //A game with no screen, playing the keys of one input
+    struct FuzzGame : public DisplayInterface, public InputInterface
+    {
+        void Start(const uint8_t* keys, size_t count)
+        {
+            m_keys = keys;
+            m_count = count;
+            m_next = 0;
+            m_polls = 0;
+        }
+
+        virtual void SetDimensions(Coord dimensions) override {}
+        virtual void UpdateRegion(uint32_t* buf) override {}
+        virtual void UpdateRegion(uint32_t* buf, Region rect) override {}
+        virtual void MoveCursor(Coord pos) override {}
+        virtual void SetCursor(bool enable) override {}
+        virtual void PlaySound(const std::string& id) override {}
+
+        virtual char GetChar(bool block, bool for_string, bool *is_replay) override
+        {
+            //there is never any typeahead, so a game that keeps asking is stuck
+            if (!block) {
+                if (++m_polls > kMaxPolls)
+                    ReportHang("the game kept polling for keys without waiting for one");
+                return 0;
+            }
+            m_polls = 0;
+            if (m_next >= m_count)
+                throw OutOfKeys();
+            return (char)m_keys[m_next++];
+        }
+
+        virtual void Flush() override {}
+
+    private:
+        const uint8_t* m_keys = nullptr;
+        size_t m_count = 0;
+        size_t m_next = 0;
+        int m_polls = 0;
+    };
+
+    void* s_engine = nullptr;
+    std::unique_ptr<EngineReset> s_reset;
+    init_game_fn s_init = nullptr;
+    game_main_fn s_main = nullptr;
+    FuzzGame s_game;
+
+    //The engine reads its seed from the environment, and this is changed in
+    //place so setting it doesn't allocate
+    char s_seed_env[] = "SEED=0000000000";
+
+    int s_hang_ms = 1000;
+    int s_slow_ms = 50;
+    double s_slowest_ms = 0;
+    std::atomic<int64_t> s_started(0);  //when the game being played started, or 0
+
+    int64_t NowMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count() + 1;
+    }
+
+    void Watch()
+    {
+        for (;;) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::max(10, s_hang_ms / 10)));
+            int64_t started = s_started;
+            if (started && NowMs() - started > s_hang_ms) {
+                char why[64];
+                sprintf(why, "a game ran for more than %d ms", s_hang_ms);
+                ReportHang(why);
+            }
+        }
+    }
+
+    int EnvInt(const char* name, int value)
+    {
+        const char* s = getenv(name);
+        return s && atoi(s) > 0 ? atoi(s) : value;
+    }
+}
+
+extern char** environ;
+
+extern "C" int LLVMFuzzerInitialize(int* argc, char*** argv)
+{
+    const char* library = getenv("ROGUE_FUZZ_ENGINE");
+    if (!library) {
+        fprintf(stderr, "Set ROGUE_FUZZ_ENGINE to the engine library to fuzz\n");
+        exit(1);
+    }
+    s_hang_ms = EnvInt("ROGUE_FUZZ_HANG_MS", s_hang_ms);
+    s_slow_ms = EnvInt("ROGUE_FUZZ_SLOW_MS", s_slow_ms);
+    size_t arena_mb = EnvInt("ROGUE_FUZZ_ARENA_MB", 256);
+
+    try {
+        s_engine = dlopen(library, RTLD_NOW | RTLD_LOCAL);
+        if (!s_engine)
+            throw_error("Couldn't load " + std::string(library) + ": " + dlerror());
+        s_init = (init_game_fn)dlsym(s_engine, "init_game");
+        s_main = (game_main_fn)dlsym(s_engine, "rogue_main");
+        if (!s_init || !s_main)
+            throw_error(std::string(library) + " isn't an engine library");
+        s_reset.reset(new EngineReset((void*)s_main, arena_mb << 20));
+    }
+    catch (const std::runtime_error& e) {
+        fprintf(stderr, "%s\n", e.what());
+        exit(1);
+    }
+    unsetenv("ROGUEOPTS");
+    putenv(s_seed_env);
+
+    std::thread(&Watch).detach();
+    fprintf(stderr, "RogueFuzz: %s, %zu KB of globals to restore per game\n", library, s_reset->SavedSize() >> 10);
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    s_input = data;
+    s_input_size = size;
+    s_reset->Restore();
+
+    unsigned int seed = 0;
+    for (size_t i = 0; i < kSeedBytes && i < size; ++i)
+        seed |= (unsigned int)data[i] << (8 * i);
+    sprintf(s_seed_env + 5, "%010u", seed);
+    size_t skip = std::min(size, (size_t)kSeedBytes);
+    s_game.Start(data + skip, size - skip);
+
+    int64_t started = NowMs();
+    s_started = started;
+    try {
+        (*s_init)(&s_game, &s_game, kLines, kColumns);
+        (*s_main)(0, 0, environ);
+    }
+    catch (const OutOfKeys&) {
+    }
+    s_started = 0;
+
+    double elapsed = double(NowMs() - started);
+    if (elapsed > s_slow_ms && elapsed > s_slowest_ms) {
+        s_slowest_ms = elapsed;
+        fprintf(stderr, "==RogueFuzz: slow: a game took %.0f ms\n", elapsed);
+        SaveInput("slow");
+    }
+    return 0;
+}
+
+#ifdef ROGUE_FUZZ_DRIVER
+
+namespace
+{
+    //Keys worth more than a random byte: moves, runs, and the common commands
+    const char kKeys[] = "hjklyubnHJKLYUBNs. \n\x1bieqrwWtTPRdzf<>abcdefgh0123456789";
+
+    struct DriverOptions
+    {
+        int runs = -1;
+        size_t max_len = 4096;
+        unsigned int seed = 0;
+        int max_total_time = 0;
+        std::vector<std::string> paths;
+    };
+
+    void Usage()
+    {
+        fprintf(stderr,
+            "usage: RogueFuzz [-runs=n] [-max_len=n] [-seed=n] [-max_total_time=s] [corpus file or directory ...]\n"
+            "  -runs            random inputs to play after the corpus (default: none if there's a corpus, else forever)\n"
+            "  -max_len         longest input in bytes (default 4096)\n"
+            "  -seed            seed for the random changes (default: from the clock)\n"
+            "  -max_total_time  stop after this many seconds\n");
+        exit(1);
+    }
+
+    DriverOptions ParseArgs(int argc, char** argv)
+    {
+        DriverOptions o;
+        o.seed = (unsigned int)time(nullptr);
+        for (int i = 1; i < argc; ++i) {
+            std::string s(argv[i]);
+            size_t eq = s.find('=');
+            std::string value = eq == std::string::npos ? std::string() : s.substr(eq + 1);
+            if (s.compare(0, 6, "-runs=") == 0)
+                o.runs = atoi(value.c_str());
+            else if (s.compare(0, 9, "-max_len=") == 0)
+                o.max_len = (size_t)std::max(kSeedBytes, atoi(value.c_str()));
+            else if (s.compare(0, 6, "-seed=") == 0)
+                o.seed = (unsigned int)strtoul(value.c_str(), nullptr, 10);
+            else if (s.compare(0, 16, "-max_total_time=") == 0)
+                o.max_total_time = atoi(value.c_str());
+            else if (s[0] != '-')
+                o.paths.push_back(s);
+            else
+                Usage();
+        }
+        return o;
+    }
+
+    bool ReadFile(const std::string& path, std::vector<uint8_t>* data)
+    {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f)
+            return false;
+        uint8_t buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+            data->insert(data->end(), buf, buf + n);
+        fclose(f);
+        return true;
+    }
+
+    std::vector<std::vector<uint8_t>> LoadCorpus(const std::vector<std::string>& paths)
+    {
+        std::vector<std::vector<uint8_t>> corpus;
+        for (const auto& path : paths) {
+            std::vector<std::string> files;
+            if (DIR* dir = opendir(path.c_str())) {
+                while (dirent* e = readdir(dir)) {
+                    if (e->d_name[0] != '.')
+                        files.push_back(path + "/" + e->d_name);
+                }
+                closedir(dir);
+                std::sort(files.begin(), files.end());
+            }
+            else
+                files.push_back(path);
+
+            for (const auto& file : files) {
+                std::vector<uint8_t> data;
+                if (!ReadFile(file, &data))
+                    throw_error("Couldn't read " + file);
+                corpus.push_back(std::move(data));
+            }
+        }
+        return corpus;
+    }
+
+    void Mutate(std::vector<uint8_t>& in, const std::vector<std::vector<uint8_t>>& corpus, size_t max_len, std::mt19937& gen)
+    {
+        auto pick = [&](size_t n) { return n ? gen() % n : 0; };
+        auto key = [&]() { return (uint8_t)kKeys[pick(sizeof(kKeys) - 1)]; };
+        if (in.size() < kSeedBytes) {
+            while (in.size() < kSeedBytes)
+                in.push_back((uint8_t)gen());
+        }
+
+        int changes = 1 + (int)pick(4);
+        for (int c = 0; c < changes; ++c) {
+            size_t at = kSeedBytes + pick(in.size() - kSeedBytes + 1);
+            switch (pick(6)) {
+            case 0: //a few keys in
+                for (size_t n = 1 + pick(16); n > 0; --n)
+                    in.insert(in.begin() + at, key());
+                break;
+            case 1: //a stretch out
+                in.erase(in.begin() + at, in.begin() + std::min(in.size(), at + 1 + pick(32)));
+                break;
+            case 2: //a key changed to any byte at all
+                if (at < in.size())
+                    in[at] = (uint8_t)gen();
+                break;
+            case 3: //a stretch played twice
+                if (at < in.size()) {
+                    size_t len = 1 + pick(std::min<size_t>(64, in.size() - at));
+                    std::vector<uint8_t> copy(in.begin() + at, in.begin() + at + len);
+                    in.insert(in.begin() + at, copy.begin(), copy.end());
+                }
+                break;
+            case 4: //the end of another input
+                if (!corpus.empty()) {
+                    const auto& other = corpus[pick(corpus.size())];
+                    if (other.size() > kSeedBytes) {
+                        size_t from = kSeedBytes + pick(other.size() - kSeedBytes);
+                        in.resize(at);
+                        in.insert(in.end(), other.begin() + from, other.end());
+                    }
+                }
+                break;
+            case 5: //another game
+                in[pick(kSeedBytes)] = (uint8_t)gen();
+                break;
+            }
+        }
+        if (in.size() > max_len)
+            in.resize(max_len);
+    }
+
+    void OnCrash(int sig)
+    {
+        //a hang has been reported already
+        if (s_hung)
+            _exit(1);
+        const char* msg = "==RogueFuzz: crash: the game was stopped by a signal\n";
+        if (write(2, msg, strlen(msg)) < 0) {}
+        SaveInput("crash");
+        _exit(1);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    DriverOptions o = ParseArgs(argc, argv);
+    LLVMFuzzerInitialize(&argc, &argv);
+
+    std::vector<std::vector<uint8_t>> corpus;
+    try {
+        corpus = LoadCorpus(o.paths);
+    }
+    catch (const std::runtime_error& e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    for (int sig : { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT })
+        signal(sig, &OnCrash);
+
+    auto start = std::chrono::steady_clock::now();
+    auto seconds = [&]() { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+    for (const auto& input : corpus)
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    if (!corpus.empty())
+        fprintf(stderr, "#%zu replayed the corpus in %.2fs\n", corpus.size(), seconds());
+
+    int runs = o.runs >= 0 ? o.runs : (corpus.empty() ? -1 : 0);
+    std::mt19937 gen(o.seed);
+    std::vector<uint8_t> input;
+    start = std::chrono::steady_clock::now();
+    for (int i = 1; runs < 0 || i <= runs; ++i) {
+        if (corpus.empty() || gen() % 8 == 0)
+            input.clear();
+        else
+            input = corpus[gen() % corpus.size()];
+        Mutate(input, corpus, o.max_len, gen);
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+
+        if ((i & (i - 1)) == 0 || i == runs)
+            fprintf(stderr, "#%d exec/s: %.0f arena: %zu KB\n", i, i / std::max(seconds(), 1e-6), s_reset->ArenaUsed() >> 10);
+        if (o.max_total_time > 0 && seconds() >= o.max_total_time)
+            break;
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,86 @@
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#ifndef _WIN32
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+#include "engine_library.h"
+
+void throw_error(const std::string& msg);
+
+namespace
+{
+    std::atomic<int> s_copies(0);
+
+    bool CopyLibrary(const std::string& from, const std::string& to)
+    {
+        std::ifstream in(from, std::ios::binary);
+        if (!in)
+            return false;
+        {
+            std::ofstream out(to, std::ios::binary | std::ios::trunc);
+            if (out && out << in.rdbuf() && out.flush())
+                return true;
+        }
+        remove(to.c_str());
+        return false;
+    }
+}
+
+EngineLibrary::EngineLibrary(const std::string& library) :
+    m_library(library)
+{
+    int id = s_copies++;
+#ifdef _WIN32
+    char dir[MAX_PATH];
+    GetTempPath(MAX_PATH, dir);
+    m_path = std::string(dir) + "RogueGym_" + std::to_string(GetCurrentProcessId()) + "_" + std::to_string(id) + ".dll";
+    if (!CopyFile(library.c_str(), m_path.c_str(), FALSE))
+        throw_error("Couldn't copy " + library + " to " + m_path);
+    m_handle = LoadLibrary(m_path.c_str());
+#else
+    //dlopen shares a library between handles unless the path differs
+    m_path = "/tmp/RogueGym_" + std::to_string(getpid()) + "_" + std::to_string(id) + ".so";
+    if (!CopyLibrary(library, m_path))
+        throw_error("Couldn't copy " + library + " to " + m_path);
+    m_handle = dlopen(m_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+#endif
+    if (!m_handle) {
+#ifdef _WIN32
+        DeleteFile(m_path.c_str());
+#else
+        unlink(m_path.c_str());
+#endif
+        throw_error("Couldn't load library: " + library);
+    }
+}
+
+EngineLibrary::~EngineLibrary()
+{
+#ifdef _WIN32
+    FreeLibrary(m_handle);
+    DeleteFile(m_path.c_str());
+#else
+    dlclose(m_handle);
+    unlink(m_path.c_str());
+#endif
+}
+
+void* EngineLibrary::Find(const char* name) const
+{
+#ifdef _WIN32
+    return (void*)GetProcAddress(m_handle, name);
+#else
+    return dlsym(m_handle, name);
+#endif
+}
+
+void* EngineLibrary::Get(const char* name) const
+{
+    void* p = Find(name);
+    if (!p)
+        throw_error(std::string("Couldn't load ") + name + " from: " + m_library);
+    return p;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+//A private copy of an engine library.  The engines keep the whole game in
+//globals, so a game that needs its own state needs its own copy of the
+//library, and loading a fresh copy is the only way to start over cleanly.
+//Every copy gets its own file, so any number of gyms can share a process.
+struct EngineLibrary
+{
+    explicit EngineLibrary(const std::string& library);
+    ~EngineLibrary();
+
+    //Look up an export, or null if the engine doesn't have it
+    void* Find(const char* name) const;
+    //Look up an export the engine has to have
+    void* Get(const char* name) const;
+
+private:
+    std::string m_library;
+    std::string m_path;
+#ifdef _WIN32
+    HMODULE m_handle = 0;
+#else
+    void* m_handle = 0;
+#endif
+};
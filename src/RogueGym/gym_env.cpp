@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include "gym_env.h"
+#include "leaderboard.h"
+
+#ifndef _WIN32
+extern char** environ;
+#endif
+
+typedef int(*game_main_fn)(int, char**, char**);
+typedef void(*init_game_fn)(DisplayInterface*, InputInterface*, int lines, int cols);
+typedef void(*reseed_game_fn)(unsigned int seed);
+typedef unsigned int(*get_random_draws_fn)();
+
+void throw_error(const std::string& msg);
+
+namespace
+{
+    //The games read their seed and options from the process environment, so
+    //only one game at a time can be between setting it and reading it
+    std::mutex s_env_mutex;
+
+    //Thrown out of GetChar to unwind a game that is being abandoned
+    struct AbandonGame {};
+
+    void SetEnv(const std::string& name, const std::string& value)
+    {
+#ifdef _WIN32
+        _putenv((name + "=" + value).c_str());
+#else
+        if (value.empty())
+            unsetenv(name.c_str());
+        else
+            setenv(name.c_str(), value.c_str(), 1);
+#endif
+    }
+}
+
+DisplayInterface::~DisplayInterface() {}
+InputInterface::~InputInterface() {}
+
+GymEnv::GymEnv(const std::string& library, const std::string& options, uint32_t* screen, AgentState* state, unsigned char* done) :
+    m_library(library),
+    m_options(options),
+    m_screen(screen),
+    m_state(state),
+    m_done(done)
+{
+    std::fill(m_screen, m_screen + kLines * kColumns, 0);
+    memset(m_state, 0, sizeof(*m_state));
+    *m_done = 1;
+}
+
+GymEnv::~GymEnv()
+{
+    Stop();
+}
+
+void GymEnv::StartReset(int seed)
+{
+    Stop();
+
+    //a fresh copy of the library gets a fresh set of globals
+    m_engine.reset();
+    m_engine.reset(new EngineLibrary(m_library));
+    m_engine->Get("init_game");
+    m_engine->Get("rogue_main");
+
+    std::fill(m_screen, m_screen + kLines * kColumns, 0);
+    memset(m_state, 0, sizeof(*m_state));
+    *m_done = 0;
+
+    m_waiting = false;
+    m_has_key = false;
+    m_abort = false;
+    m_finished = false;
+    m_thread = std::thread(&GymEnv::Run, this, seed);
+}
+
+void GymEnv::StartStep(char key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_finished)
+        return;
+    m_key = key;
+    m_has_key = true;
+    m_cv.notify_all();
+}
+
+void GymEnv::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return (m_waiting && !m_has_key) || m_finished; });
+}
+
+std::vector<RolloutOutcome> GymEnv::Lookahead(const LookaheadRequest& request)
+{
+    if (request.candidates.empty() || request.samples <= 0)
+        throw_error("Nothing to look ahead at");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_finished || !m_waiting || m_has_key)
+        throw_error("The game isn't waiting for a key");
+
+    m_lookahead = &request;
+    m_lookahead_error.clear();
+    m_cv.notify_all();
+    m_cv.wait(lock, [this] { return m_lookahead == nullptr; });
+
+    if (!m_lookahead_error.empty())
+        throw_error(m_lookahead_error);
+    return std::move(m_outcomes);
+}
+
+void GymEnv::DistanceMap(int field, int* distances)
+{
+    //the game thread is parked in GetChar and can't move on while this is held
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_finished || !m_waiting || m_has_key)
+        throw_error("The game isn't waiting for a key");
+
+    get_distance_map_fn get_map = (get_distance_map_fn)m_engine->Find("get_distance_map");
+    if (!get_map)
+        throw_error("The engine has no distance maps");
+    if ((*get_map)(field, distances, kLines, kColumns) != 0)
+        throw_error("No distance field " + std::to_string(field));
+}
+
+unsigned int GymEnv::RandomDraws()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_finished || !m_waiting || m_has_key)
+        throw_error("The game isn't waiting for a key");
+
+    get_random_draws_fn get_draws = (get_random_draws_fn)m_engine->Find("get_random_draws");
+    if (!get_draws)
+        throw_error("The engine doesn't count its random numbers");
+    return (*get_draws)();
+}
+
+void GymEnv::SetLeaderboard(Leaderboard* board)
+{
+    m_leaderboard = board;
+}
+
+void GymEnv::Run(int seed)
+{
+    m_env_lock = std::unique_lock<std::mutex>(s_env_mutex);
+    SetEnv("SEED", std::to_string(seed));
+    SetEnv("ROGUEOPTS", m_options);
+
+    init_game_fn init = (init_game_fn)m_engine->Get("init_game");
+    game_main_fn game = (game_main_fn)m_engine->Get("rogue_main");
+    bool ended = false;
+    try {
+        (*init)(this, this, kLines, kColumns);
+        (*game)(0, 0, environ);
+        ended = true;
+    }
+    catch (const AbandonGame&) {
+    }
+
+    if (m_rollout >= 0)
+        FinishRollout(false);
+
+    if (m_env_lock.owns_lock())
+        m_env_lock.unlock();
+
+    if (ended && m_leaderboard)
+        RecordScore(seed);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_finished = true;
+    *m_done = 1;
+    m_cv.notify_all();
+}
+
+//The hero as the game last stopped for a key, which is on the way out
+void GymEnv::RecordScore(int seed)
+{
+    ScoreEntry entry;
+    size_t start = m_library.find_last_of("/\\");
+    entry.version = m_library.substr(start == std::string::npos ? 0 : start + 1);
+    entry.version = entry.version.substr(0, entry.version.find('.'));
+    entry.seed = seed;
+    entry.name = "agent";
+    entry.score = m_state->gold;
+    entry.depth = m_state->depth;
+    entry.rank = m_state->level;
+    entry.flags = m_state->hp > 0 ? 1 : 0;
+    entry.time = time(nullptr);
+
+    //an engine that says how the game ended knows better than the hero's state
+    GameEnd end;
+    get_game_end_fn get_end = (get_game_end_fn)m_engine->Find("get_game_end");
+    if (get_end && (*get_end)(&end)) {
+        entry.score = end.score;
+        entry.flags = end.flags;
+        entry.monster = end.monster;
+    }
+
+    //there's no one to hand an error to on the game's thread
+    try {
+        m_leaderboard->Add(entry);
+    }
+    catch (const std::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+    }
+}
+
+void GymEnv::Stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_abort = true;
+        m_cv.notify_all();
+    }
+    m_thread.join();
+}
+
+void GymEnv::SetDimensions(Coord dimensions)
+{
+}
+
+void GymEnv::UpdateRegion(uint32_t* buf)
+{
+    //nobody sees a rollout's screen
+    if (m_rollout >= 0)
+        return;
+    std::copy(buf, buf + kLines * kColumns, m_screen);
+}
+
+void GymEnv::UpdateRegion(uint32_t* buf, Region rect)
+{
+    //the game always passes the whole buffer
+    UpdateRegion(buf);
+}
+
+void GymEnv::MoveCursor(Coord pos)
+{
+}
+
+void GymEnv::SetCursor(bool enable)
+{
+}
+
+void GymEnv::PlaySound(const std::string& id)
+{
+}
+
+char GymEnv::GetChar(bool block, bool for_string, bool *is_replay)
+{
+    //there is never any typeahead
+    if (!block)
+        return 0;
+    if (m_rollout >= 0)
+        return NextRolloutKey();
+
+    //the game has read its seed by the time it wants a key
+    if (m_env_lock.owns_lock())
+        m_env_lock.unlock();
+
+    //the game is stopped here, so it's safe to look at its state
+    get_agent_state_fn get_state = (get_agent_state_fn)m_engine->Find("get_agent_state");
+    if (get_state)
+        (*get_state)(m_state);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_waiting = true;
+    m_cv.notify_all();
+    for (;;) {
+        m_cv.wait(lock, [this] { return m_has_key || m_abort || m_lookahead; });
+        if (!m_lookahead)
+            break;
+
+        //copies of the game play out the lookahead while this one waits on
+        lock.unlock();
+        if (PlayLookahead())
+            return NextRolloutKey();
+        lock.lock();
+        m_lookahead = nullptr;
+        m_cv.notify_all();
+    }
+    m_waiting = false;
+    if (m_abort)
+        throw AbandonGame();
+
+    m_has_key = false;
+    return m_key;
+}
+
+void GymEnv::Flush()
+{
+}
+
+//Returns true in a copy of the process that is to play a rollout, and false
+//back in this one once they're all done
+bool GymEnv::PlayLookahead()
+{
+    const LookaheadRequest& request = *m_lookahead;
+    int count = (int)request.candidates.size() * request.samples;
+    try {
+        m_pool.reset(new RolloutPool(count, request.workers));
+        int rollout = m_pool->Run();
+        if (rollout >= 0) {
+            StartRollout(rollout);
+            return true;
+        }
+        m_outcomes.resize(count);
+        for (int i = 0; i < count; ++i)
+            m_outcomes[i] = m_pool->Outcome(i);
+    }
+    catch (const std::exception& e) {
+        m_lookahead_error = e.what();
+    }
+    m_pool.reset();
+    return false;
+}
+
+void GymEnv::StartRollout(int rollout)
+{
+    const LookaheadRequest& request = *m_lookahead;
+    int candidate = rollout / request.samples;
+    int sample = rollout % request.samples;
+
+    m_rollout = rollout;
+    m_rollout_keys = request.candidates[candidate].c_str();
+    m_rollout_outcome = RolloutOutcome();
+    m_rollout_outcome.depth = m_state->depth;
+    m_rollout_hp = m_state->hp;
+
+    //without a reseed every sample of a candidate would play out the same
+    reseed_game_fn reseed = (reseed_game_fn)m_engine->Find("reseed_game");
+    if (reseed)
+        (*reseed)(RolloutSeed(request.seed, candidate, sample));
+}
+
+char GymEnv::NextRolloutKey()
+{
+    get_agent_state_fn get_state = (get_agent_state_fn)m_engine->Find("get_agent_state");
+    if (get_state)
+        (*get_state)(m_state);
+    m_rollout_outcome.depth = std::max(m_rollout_outcome.depth, m_state->depth);
+
+    if (*m_rollout_keys == 0)
+        FinishRollout(true);
+    ++m_rollout_outcome.keys;
+    return *m_rollout_keys++;
+}
+
+//Ends the copy of the process the rollout was played in
+void GymEnv::FinishRollout(bool playing)
+{
+    RolloutOutcome& o = m_rollout_outcome;
+    o.alive = playing && m_state->hp > 0;
+    o.hp_delta = (o.alive ? m_state->hp : 0) - m_rollout_hp;
+    m_pool->Finish(o);
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <display_interface.h>
+#include <input_interface.h>
+#include <agent_state.h>
+#include <distance_map.h>
+#include "engine_library.h"
+#include "lookahead.h"
+
+class Leaderboard;
+
+//Key sequences to try from where a game stands, each played samples times
+struct LookaheadRequest
+{
+    std::vector<std::string> candidates;
+    int samples = 1;
+    unsigned int seed = 0;
+    int workers = 0;             //processes to play them in, 0 for one per core
+};
+
+//One game played a key at a time.  The game runs on its own thread and only
+//moves while it has a key to act on; it writes its screen and the hero's
+//state into buffers owned by the caller each time it stops for input.
+struct GymEnv : public DisplayInterface, public InputInterface
+{
+    GymEnv(const std::string& library, const std::string& options, uint32_t* screen, AgentState* state, unsigned char* done);
+    ~GymEnv();
+
+    //Abandon any game in progress and start a new one.  Wait() returns once
+    //the new game wants its first key.
+    void StartReset(int seed);
+
+    //Hand the game a key.  Wait() returns once it wants the next one.
+    void StartStep(char key);
+
+    void Wait();
+
+    //Play each candidate from where the game stands, in copies of it, and
+    //leave the game itself as it was.  Rollouts are in candidate order, with
+    //each candidate's samples together.  Only while the game wants a key.
+    std::vector<RolloutOutcome> Lookahead(const LookaheadRequest& request);
+
+    //Fill in kLines x kColumns distances with one of the engine's DIST_
+    //fields.  Only while the game wants a key.
+    void DistanceMap(int field, int* distances);
+
+    //How many random numbers the game has drawn.  Only while the game wants a key.
+    unsigned int RandomDraws();
+
+    //Record each game that ends, rather than is abandoned, in board
+    void SetLeaderboard(Leaderboard* board);
+
+    //display interface
+    virtual void SetDimensions(Coord dimensions) override;
+    virtual void UpdateRegion(uint32_t* buf) override;
+    virtual void UpdateRegion(uint32_t* buf, Region rect) override;
+    virtual void MoveCursor(Coord pos) override;
+    virtual void SetCursor(bool enable) override;
+    virtual void PlaySound(const std::string& id) override;
+
+    //input interface
+    virtual char GetChar(bool block, bool for_string, bool *is_replay) override;
+    virtual void Flush() override;
+
+    static const int kLines = 25;
+    static const int kColumns = 80;
+
+private:
+    void Run(int seed);
+    void Stop();
+    void RecordScore(int seed);
+    bool PlayLookahead();
+    void StartRollout(int rollout);
+    char NextRolloutKey();
+    void FinishRollout(bool playing);
+
+    std::string m_library;
+    std::string m_options;
+    std::unique_ptr<EngineLibrary> m_engine;
+    Leaderboard* m_leaderboard = nullptr;
+    std::thread m_thread;
+
+    //written by the game thread only while the caller is waiting
+    uint32_t* m_screen;
+    AgentState* m_state;
+    unsigned char* m_done;
+
+    //held by the game thread from setting the environment until the game has read it
+    std::unique_lock<std::mutex> m_env_lock;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_waiting = false;
+    bool m_has_key = false;
+    char m_key = 0;
+    bool m_abort = false;
+    bool m_finished = true;
+
+    //handed to the game thread, which plays it while the caller waits
+    const LookaheadRequest* m_lookahead = nullptr;
+    std::vector<RolloutOutcome> m_outcomes;
+    std::string m_lookahead_error;
+    std::unique_ptr<RolloutPool> m_pool;
+
+    //only set in a copy of the process playing a rollout
+    int m_rollout = -1;
+    const char* m_rollout_keys = nullptr;
+    RolloutOutcome m_rollout_outcome = {};
+    int m_rollout_hp = 0;
+};
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "lookahead.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+void throw_error(const std::string& msg);
+
+//Lives in memory every copy of the process shares
+struct RolloutPool::Shared
+{
+    std::atomic<int> next;
+    RolloutOutcome outcomes[1];
+};
+
+RolloutPool::RolloutPool(int count, int workers) :
+    m_count(count),
+    m_workers(workers)
+{
+#ifdef _WIN32
+    throw_error("Lookahead needs fork(), which Windows doesn't have");
+#else
+    if (count <= 0)
+        throw_error("Nothing to look ahead at");
+    if (m_workers <= 0)
+        m_workers = std::max(1u, std::thread::hardware_concurrency());
+    m_workers = std::min(m_workers, count);
+
+    m_size = sizeof(Shared) + sizeof(RolloutOutcome) * (count - 1);
+    void* p = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        throw_error(std::string("Couldn't map rollout results: ") + strerror(errno));
+    m_shared = new (p) Shared;
+    m_shared->next = 0;
+    memset(m_shared->outcomes, 0, sizeof(RolloutOutcome) * count);
+#endif
+}
+
+RolloutPool::~RolloutPool()
+{
+#ifndef _WIN32
+    if (m_shared)
+        munmap(m_shared, m_size);
+#endif
+}
+
+int RolloutPool::Run()
+{
+#ifndef _WIN32
+    std::vector<pid_t> workers;
+    for (int i = 0; i < m_workers; ++i) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            Work();
+            if (m_rollout >= 0)
+                return m_rollout;
+            _exit(0);
+        }
+        if (pid > 0)
+            workers.push_back(pid);
+    }
+    if (workers.empty())
+        throw_error(std::string("Couldn't fork: ") + strerror(errno));
+
+    for (pid_t pid : workers) {
+        while (waitpid(pid, nullptr, 0) < 0 && errno == EINTR)
+            ;
+    }
+
+    //rollouts no worker got to, if some never started
+    for (int i = m_shared->next; i < m_count; ++i)
+        m_shared->outcomes[i].failed = 1;
+#endif
+    return -1;
+}
+
+//A worker: takes rollouts until there are none left, playing each in a fresh
+//copy of itself.  Returns only in a copy, with m_rollout set.
+void RolloutPool::Work()
+{
+#ifndef _WIN32
+    int i;
+    while ((i = m_shared->next++) < m_count) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            m_rollout = i;
+            return;
+        }
+
+        int status = 0;
+        if (pid > 0) {
+            while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+                ;
+        }
+        if (pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            m_shared->outcomes[i].failed = 1;
+    }
+#endif
+}
+
+void RolloutPool::Finish(const RolloutOutcome& outcome)
+{
+#ifndef _WIN32
+    m_shared->outcomes[m_rollout] = outcome;
+    _exit(0);
+#endif
+}
+
+const RolloutOutcome& RolloutPool::Outcome(int i) const
+{
+    return m_shared->outcomes[i];
+}
+
+namespace
+{
+    //splitmix64's finalizer, so nearby candidates and samples get unrelated seeds
+    unsigned long long Mix(unsigned long long x)
+    {
+        x += 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+}
+
+unsigned int RolloutSeed(unsigned int seed, int candidate, int sample)
+{
+    return (unsigned int)Mix(Mix(Mix(seed) ^ (unsigned)candidate) ^ (unsigned)sample);
+}
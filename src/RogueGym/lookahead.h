@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+
+//How one rollout ended
+struct RolloutOutcome
+{
+    int alive;      //the game was still going once the keys ran out
+    int hp_delta;   //hit points at the end less those at the start; a death loses them all
+    int depth;      //deepest level reached
+    int keys;       //keys the game took before the rollout ended
+    int failed;     //the copy of the game crashed
+};
+
+//Plays rollouts in copies of the process made with fork(), so each one starts
+//exactly where the game stood, whatever the engine keeps in its globals.
+//Worker processes are forked once, and each forks a fresh copy of itself for
+//every rollout it plays, so the copying is spread over all the cores.
+class RolloutPool
+{
+public:
+    RolloutPool(int count, int workers);
+    ~RolloutPool();
+
+    //Like fork(): returns the rollout the calling process is now to play, or
+    //-1 in the original process once every rollout has finished
+    int Run();
+
+    //Hands back a rollout's outcome from its copy of the process, and ends it
+    void Finish(const RolloutOutcome& outcome);
+
+    const RolloutOutcome& Outcome(int i) const;
+
+private:
+    void Work();
+
+    struct Shared;
+    Shared* m_shared = nullptr;
+    size_t m_size = 0;
+    int m_count;
+    int m_workers;
+    int m_rollout = -1;
+};
+
+//The seed each rollout starts its random numbers from, so results repeat
+unsigned int RolloutSeed(unsigned int seed, int candidate, int sample);
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "rogue_gym.h"
+#include "vec_gym_env.h"
+
+//C bindings for VecGymEnv.  Errors come back as return values, with the
+//message kept per thread for rogue_gym_error.
+
+struct RogueGym
+{
+    RogueGym(const char* library, int count, const char* options) :
+        env(library, count, options ? options : "")
+    {
+    }
+
+    VecGymEnv env;
+};
+
+namespace
+{
+    thread_local std::string s_error;
+
+    template <typename F>
+    int Guard(F f)
+    {
+        try {
+            f();
+            return 0;
+        }
+        catch (const std::exception& e) {
+            s_error = e.what();
+            return -1;
+        }
+    }
+}
+
+RogueGym* rogue_gym_create(const char* library, int count, const char* options)
+{
+    RogueGym* gym = nullptr;
+    Guard([&] { gym = new RogueGym(library, count, options); });
+    return gym;
+}
+
+void rogue_gym_destroy(RogueGym* gym)
+{
+    delete gym;
+}
+
+int rogue_gym_count(const RogueGym* gym)
+{
+    return gym->env.Count();
+}
+
+int rogue_gym_reset(RogueGym* gym, const int* seeds)
+{
+    return Guard([&] { gym->env.Reset(seeds); });
+}
+
+int rogue_gym_reset_one(RogueGym* gym, int index, int seed)
+{
+    return Guard([&] { gym->env.Reset(index, seed); });
+}
+
+int rogue_gym_step(RogueGym* gym, const char* keys)
+{
+    return Guard([&] { gym->env.Step(keys); });
+}
+
+int rogue_gym_set_leaderboard(RogueGym* gym, const char* path)
+{
+    return Guard([&] { gym->env.SetLeaderboard(path); });
+}
+
+int rogue_gym_lookahead(RogueGym* gym, int index, const char* const* candidates, int count, int samples,
+    unsigned int seed, RogueGymLookahead* results)
+{
+    return Guard([&] {
+        std::vector<std::string> keys(candidates, candidates + count);
+        std::vector<RogueGymLookahead> r = gym->env.Lookahead(index, keys, samples, seed);
+        std::copy(r.begin(), r.end(), results);
+    });
+}
+
+int rogue_gym_distance_map(RogueGym* gym, int index, int field, int* distances)
+{
+    return Guard([&] { gym->env.DistanceMap(index, field, distances); });
+}
+
+int rogue_gym_random_draws(RogueGym* gym, int index, unsigned int* draws)
+{
+    return Guard([&] { *draws = gym->env.RandomDraws(index); });
+}
+
+const uint32_t* rogue_gym_screens(const RogueGym* gym)
+{
+    return gym->env.Screens();
+}
+
+const AgentState* rogue_gym_states(const RogueGym* gym)
+{
+    return gym->env.States();
+}
+
+const unsigned char* rogue_gym_done(const RogueGym* gym)
+{
+    return gym->env.Done();
+}
+
+const char* rogue_gym_error(void)
+{
+    return s_error.c_str();
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <stdint.h>
+#include <agent_state.h>
+#include <distance_map.h>
+
+#ifdef _WIN32
+#ifdef ROGUE_GYM_EXPORTS
+#define ROGUE_GYM_API __declspec(dllexport)
+#else
+#define ROGUE_GYM_API __declspec(dllimport)
+#endif
+#else
+#define ROGUE_GYM_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Size of each environment's screen.  Every game runs on an 80x25 screen.
+#define ROGUE_GYM_LINES   25
+#define ROGUE_GYM_COLUMNS 80
+
+typedef struct RogueGym RogueGym;
+
+//What came of one candidate in rogue_gym_lookahead
+struct RogueGymLookahead
+{
+    int samples;
+    int survived;                //samples where the game was still going once the keys ran out
+    int failed;                  //samples whose copy of the game crashed, left out of the rest
+    double mean_hp_delta;        //hit points at the end less those at the start; a death loses them all
+    double mean_depth;           //of the deepest level each sample reached
+    int max_depth;
+};
+
+//Creates count environments that each run a private copy of the given engine
+//library.  options is passed to the games as ROGUEOPTS and may be null.
+//Returns null on failure; rogue_gym_error() says why.
+ROGUE_GYM_API RogueGym* rogue_gym_create(const char* library, int count, const char* options);
+ROGUE_GYM_API void rogue_gym_destroy(RogueGym* gym);
+
+ROGUE_GYM_API int rogue_gym_count(const RogueGym* gym);
+
+//Starts a new game in every environment, one seed each, and returns once they
+//all want a key.  Returns 0 on success, -1 on failure.
+ROGUE_GYM_API int rogue_gym_reset(RogueGym* gym, const int* seeds);
+
+//Starts a new game in a single environment.
+ROGUE_GYM_API int rogue_gym_reset_one(RogueGym* gym, int index, int seed);
+
+//Sends one key to every environment and returns once they all want another
+//key or have ended.  Environments that have ended ignore their key.
+ROGUE_GYM_API int rogue_gym_step(RogueGym* gym, const char* keys);
+
+//Adds each game that ends from now on, rather than being abandoned by a reset,
+//to the shared leaderboard log at path.  Any number of gyms and processes can
+//use the same log.
+ROGUE_GYM_API int rogue_gym_set_leaderboard(RogueGym* gym, const char* path);
+
+//Plays each of count candidate key strings from where environment index
+//stands, samples times each, and fills in one result per candidate.  Every
+//sample runs in its own copy of the game made with fork(), with its random
+//numbers started over from a seed made from seed, the candidate, and the
+//sample, so the results repeat.  The game itself is left as it was.  Not
+//available on Windows.
+ROGUE_GYM_API int rogue_gym_lookahead(RogueGym* gym, int index, const char* const* candidates, int count, int samples,
+    unsigned int seed, struct RogueGymLookahead* results);
+
+//Fills in ROGUE_GYM_LINES x ROGUE_GYM_COLUMNS distances, laid out like the
+//screen, with one of the DIST_ fields in distance_map.h for environment index:
+//the moves from each square to the hero, the stairs, or the edge of what's
+//been explored, over the squares the hero knows, or -1 where there's no known
+//way.  The engine keeps the fields and only works one out again once the hero
+//or the known map has changed.  Fails if the engine doesn't have them.
+ROGUE_GYM_API int rogue_gym_distance_map(RogueGym* gym, int index, int field, int* distances);
+
+//Sets *draws to how many random numbers environment index's game has drawn
+//since it started, so two builds of an engine can be checked against each
+//other.  Fails if the game has ended or the engine doesn't count them.
+ROGUE_GYM_API int rogue_gym_random_draws(RogueGym* gym, int index, unsigned int* draws);
+
+//Observations, laid out environment by environment.  The buffers belong to
+//the gym and are rewritten in place by every reset and step.
+//screens: count x ROGUE_GYM_LINES x ROGUE_GYM_COLUMNS cells, as the display gets them
+ROGUE_GYM_API const uint32_t* rogue_gym_screens(const RogueGym* gym);
+ROGUE_GYM_API const struct AgentState* rogue_gym_states(const RogueGym* gym);
+//non-zero once the game in an environment has ended
+ROGUE_GYM_API const unsigned char* rogue_gym_done(const RogueGym* gym);
+
+//Describes the last failure on this thread
+ROGUE_GYM_API const char* rogue_gym_error(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <stdexcept>
+#include "vec_gym_env.h"
+#include "gym_env.h"
+#include "leaderboard.h"
+
+void throw_error(const std::string& msg)
+{
+    throw std::runtime_error(msg);
+}
+
+VecGymEnv::VecGymEnv(const std::string& library, int count, const std::string& options) :
+    m_screens(size_t(count) * kLines * kColumns),
+    m_states(count),
+    m_done(count)
+{
+    static_assert(kLines == GymEnv::kLines && kColumns == GymEnv::kColumns, "screen size mismatch");
+    if (count <= 0)
+        throw_error("Need at least one environment");
+
+    for (int i = 0; i < count; ++i) {
+        m_envs.emplace_back(new GymEnv(library, options, &m_screens[size_t(i) * kLines * kColumns], &m_states[i], &m_done[i]));
+    }
+}
+
+VecGymEnv::~VecGymEnv()
+{
+}
+
+int VecGymEnv::Count() const
+{
+    return (int)m_envs.size();
+}
+
+void VecGymEnv::Reset(const int* seeds)
+{
+    for (size_t i = 0; i < m_envs.size(); ++i)
+        m_envs[i]->StartReset(seeds[i]);
+    for (auto& env : m_envs)
+        env->Wait();
+}
+
+void VecGymEnv::Reset(int i, int seed)
+{
+    if (i < 0 || i >= Count())
+        throw_error("No environment " + std::to_string(i));
+    m_envs[i]->StartReset(seed);
+    m_envs[i]->Wait();
+}
+
+void VecGymEnv::Step(const char* keys)
+{
+    for (size_t i = 0; i < m_envs.size(); ++i)
+        m_envs[i]->StartStep(keys[i]);
+    for (auto& env : m_envs)
+        env->Wait();
+}
+
+std::vector<RogueGymLookahead> VecGymEnv::Lookahead(int i, const std::vector<std::string>& candidates, int samples,
+    unsigned int seed, int workers)
+{
+    if (i < 0 || i >= Count())
+        throw_error("No environment " + std::to_string(i));
+
+    LookaheadRequest request;
+    request.candidates = candidates;
+    request.samples = samples;
+    request.seed = seed;
+    request.workers = workers;
+    std::vector<RolloutOutcome> outcomes = m_envs[i]->Lookahead(request);
+
+    std::vector<RogueGymLookahead> results(candidates.size());
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        RogueGymLookahead& r = results[c];
+        r.samples = samples;
+        int played = 0;
+        for (int n = 0; n < samples; ++n) {
+            const RolloutOutcome& o = outcomes[c * samples + n];
+            if (o.failed) {
+                ++r.failed;
+                continue;
+            }
+            ++played;
+            r.survived += o.alive;
+            r.mean_hp_delta += o.hp_delta;
+            r.mean_depth += o.depth;
+            r.max_depth = std::max(r.max_depth, o.depth);
+        }
+        if (played > 0) {
+            r.mean_hp_delta /= played;
+            r.mean_depth /= played;
+        }
+    }
+    return results;
+}
+
+void VecGymEnv::DistanceMap(int i, int field, int* distances)
+{
+    if (i < 0 || i >= Count())
+        throw_error("No environment " + std::to_string(i));
+    m_envs[i]->DistanceMap(field, distances);
+}
+
+unsigned int VecGymEnv::RandomDraws(int i)
+{
+    if (i < 0 || i >= Count())
+        throw_error("No environment " + std::to_string(i));
+    return m_envs[i]->RandomDraws();
+}
+
+void VecGymEnv::SetLeaderboard(const std::string& path)
+{
+    std::unique_ptr<Leaderboard> board(new Leaderboard(path));
+    for (auto& env : m_envs)
+        env->SetLeaderboard(board.get());
+    m_leaderboard = std::move(board);
+}
+
+const uint32_t* VecGymEnv::Screens() const
+{
+    return m_screens.data();
+}
+
+const uint32_t* VecGymEnv::Screen(int i) const
+{
+    return &m_screens[size_t(i) * kLines * kColumns];
+}
+
+const AgentState* VecGymEnv::States() const
+{
+    return m_states.data();
+}
+
+const unsigned char* VecGymEnv::Done() const
+{
+    return m_done.data();
+}
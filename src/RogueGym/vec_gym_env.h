@@ -0,0 +1,71 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "rogue_gym.h"
+
+struct GymEnv;
+class Leaderboard;
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4251) //private members don't need exporting
+#endif
+
+//A batch of games stepped in lockstep for training agents.  Each game runs on
+//its own thread with its own copy of the engine library, so a batched step
+//hands every game its key and then waits for all of them, and the games play
+//their turns in parallel.  Observations go straight into buffers allocated
+//once up front.
+struct ROGUE_GYM_API VecGymEnv
+{
+    VecGymEnv(const std::string& library, int count, const std::string& options);
+    ~VecGymEnv();
+
+    int Count() const;
+
+    //Start a new game in every environment, one seed each
+    void Reset(const int* seeds);
+    void Reset(int i, int seed);
+
+    //Send one key to every environment.  Environments that are done ignore it.
+    void Step(const char* keys);
+
+    //Try each candidate key string from where environment i stands, samples
+    //times each, in copies of the game made with fork().  See
+    //rogue_gym_lookahead.  workers is how many processes play them, 0 for one
+    //per core.
+    std::vector<RogueGymLookahead> Lookahead(int i, const std::vector<std::string>& candidates, int samples,
+        unsigned int seed, int workers = 0);
+
+    //Fill in kLines x kColumns distances for environment i.  See
+    //rogue_gym_distance_map.
+    void DistanceMap(int i, int field, int* distances);
+
+    //How many random numbers environment i's game has drawn.  See
+    //rogue_gym_random_draws.
+    unsigned int RandomDraws(int i);
+
+    //Add every game that ends from now on to the leaderboard log at path
+    void SetLeaderboard(const std::string& path);
+
+    //count x kLines x kColumns screen cells
+    const uint32_t* Screens() const;
+    const uint32_t* Screen(int i) const;
+    const AgentState* States() const;
+    const unsigned char* Done() const;
+
+    static const int kLines = ROGUE_GYM_LINES;
+    static const int kColumns = ROGUE_GYM_COLUMNS;
+
+private:
+    std::vector<uint32_t> m_screens;
+    std::vector<AgentState> m_states;
+    std::vector<unsigned char> m_done;
+    std::unique_ptr<Leaderboard> m_leaderboard;
+    std::vector<std::unique_ptr<GymEnv>> m_envs;
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
@@ -0,0 +1,227 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include "corpus_index.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+void throw_error(const std::string& msg);
+
+namespace
+{
+    const char kMagic[4] = { 'R', 'C', 'I', 'X' };
+    const uint32_t kFormat = 1;
+
+    void ReplaceFile(const std::string& from, const std::string& to)
+    {
+#ifdef _WIN32
+        bool ok = MoveFileEx(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        bool ok = rename(from.c_str(), to.c_str()) == 0;
+#endif
+        if (!ok) {
+            remove(from.c_str());
+            throw_error("Couldn't replace " + to);
+        }
+    }
+}
+
+struct CorpusIndex::Header
+{
+    char magic[4];
+    uint32_t format;
+    uint32_t count;              //games
+    uint32_t version_count;      //entries in the version table that follows
+    uint32_t strings_size;
+    uint32_t reserved;
+    uint64_t columns;            //offset of the first column
+    uint64_t strings;            //offset of the string pool
+};
+
+CorpusIndex::CorpusIndex(const std::string& path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw_error("Couldn't open " + path);
+    LARGE_INTEGER size;
+    HANDLE mapping = GetFileSizeEx(file, &size) && size.QuadPart > 0 ? CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    const void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    m_file = (intptr_t)file;
+    m_mapping = (intptr_t)mapping;
+    m_data = (const char*)data;
+    m_size = data ? (size_t)size.QuadPart : 0;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw_error("Couldn't open " + path);
+    struct stat st;
+    void* data = fstat(fd, &st) == 0 && st.st_size > 0 ? mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    m_file = fd;
+    m_mapping = 0;
+    m_data = data != MAP_FAILED ? (const char*)data : nullptr;
+    m_size = m_data ? (size_t)st.st_size : 0;
+#endif
+
+    //check everything a query could touch once, up front
+    m_header = (const Header*)m_data;
+    bool ok = m_size >= sizeof(Header) && memcmp(m_header->magic, kMagic, sizeof(kMagic)) == 0 && m_header->format == kFormat;
+    if (ok) {
+        uint64_t table_end = sizeof(Header) + uint64_t(m_header->version_count) * sizeof(int32_t);
+        uint64_t columns_end = m_header->columns + uint64_t(kColumnCount) * m_header->count * sizeof(int32_t);
+        ok = m_header->columns >= table_end && m_header->columns % sizeof(int32_t) == 0 &&
+            m_header->strings >= columns_end && m_header->strings_size > 0 &&
+            m_header->strings + m_header->strings_size <= m_size &&
+            m_data[m_header->strings + m_header->strings_size - 1] == 0;
+    }
+    if (!ok) {
+        Close();
+        throw_error(path + " isn't a corpus index");
+    }
+}
+
+CorpusIndex::~CorpusIndex()
+{
+    Close();
+}
+
+void CorpusIndex::Close()
+{
+#ifdef _WIN32
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle((HANDLE)m_mapping);
+    CloseHandle((HANDLE)m_file);
+#else
+    if (m_data)
+        munmap((void*)m_data, m_size);
+    close((int)m_file);
+#endif
+}
+
+int CorpusIndex::Count() const
+{
+    return (int)m_header->count;
+}
+
+const int32_t* CorpusIndex::Get(Column column) const
+{
+    return (const int32_t*)(m_data + m_header->columns) + size_t(column) * m_header->count;
+}
+
+int CorpusIndex::VersionCount() const
+{
+    return (int)m_header->version_count;
+}
+
+const char* CorpusIndex::VersionName(int version) const
+{
+    if (version < 0 || version >= VersionCount())
+        return "";
+    const int32_t* table = (const int32_t*)(m_data + sizeof(Header));
+    return String(table[version]);
+}
+
+int CorpusIndex::FindVersion(const std::string& name) const
+{
+    for (int i = 0; i < VersionCount(); ++i) {
+        if (name == VersionName(i))
+            return i;
+    }
+    return -1;
+}
+
+const char* CorpusIndex::Path(int row) const
+{
+    return String(Get(kPath)[row]);
+}
+
+IndexEntry CorpusIndex::Entry(int row) const
+{
+    IndexEntry e;
+    e.path = Path(row);
+    e.version = VersionName(Get(kVersion)[row]);
+    e.seed = Get(kSeed)[row];
+    e.keys = Get(kKeys)[row];
+    e.depth = Get(kDepth)[row];
+    e.max_depth = Get(kMaxDepth)[row];
+    e.flags = Get(kFlags)[row];
+    e.monster = Get(kMonster)[row];
+    e.score = Get(kScore)[row];
+    e.keylog_offset = Get(kKeylogOffset)[row];
+    e.keylog_size = Get(kKeylogSize)[row];
+    return e;
+}
+
+const char* CorpusIndex::String(int32_t offset) const
+{
+    //the pool ends in a 0, so any offset inside it is a whole string
+    if (offset < 0 || (uint32_t)offset >= m_header->strings_size)
+        return "";
+    return m_data + m_header->strings + offset;
+}
+
+void CorpusIndex::Write(const std::string& path, const std::vector<IndexEntry>& entries)
+{
+    std::string pool(1, '\0');
+    std::map<std::string, int32_t> versions;
+    std::vector<int32_t> version_table;
+    std::vector<int32_t> columns(size_t(kColumnCount) * entries.size());
+    auto column = [&](Column c) { return &columns[size_t(c) * entries.size()]; };
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const IndexEntry& e = entries[i];
+        auto v = versions.find(e.version);
+        if (v == versions.end()) {
+            v = versions.insert(std::make_pair(e.version, (int32_t)version_table.size())).first;
+            version_table.push_back((int32_t)pool.size());
+            pool.append(e.version.c_str(), e.version.size() + 1);
+        }
+        column(kPath)[i] = (int32_t)pool.size();
+        pool.append(e.path.c_str(), e.path.size() + 1);
+
+        column(kVersion)[i] = v->second;
+        column(kSeed)[i] = e.seed;
+        column(kKeys)[i] = e.keys;
+        column(kDepth)[i] = e.depth;
+        column(kMaxDepth)[i] = e.max_depth;
+        column(kFlags)[i] = e.flags;
+        column(kMonster)[i] = e.monster;
+        column(kScore)[i] = e.score;
+        column(kKeylogOffset)[i] = e.keylog_offset;
+        column(kKeylogSize)[i] = e.keylog_size;
+    }
+
+    Header header = {};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.format = kFormat;
+    header.count = (uint32_t)entries.size();
+    header.version_count = (uint32_t)version_table.size();
+    header.strings_size = (uint32_t)pool.size();
+    header.columns = sizeof(Header) + version_table.size() * sizeof(int32_t);
+    header.strings = header.columns + columns.size() * sizeof(int32_t);
+
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write((const char*)&header, sizeof(header));
+        out.write((const char*)version_table.data(), version_table.size() * sizeof(int32_t));
+        out.write((const char*)columns.data(), columns.size() * sizeof(int32_t));
+        out.write(pool.data(), pool.size());
+        if (!out) {
+            out.close();
+            remove(temp.c_str());
+            throw_error("Couldn't write " + temp);
+        }
+    }
+    ReplaceFile(temp, path);
+}
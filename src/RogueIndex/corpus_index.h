@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//One save file, as replaying it found it
+struct IndexEntry
+{
+    std::string path;
+    std::string version;         //the game's name, e.g. "Unix Rogue 5.4.2"
+    int seed = 0;
+    int keys = 0;                //keys the game read before it ended or they ran out
+    int depth = 0;               //the level it ended on
+    int max_depth = 0;           //the deepest level reached
+    int flags = -1;              //as GameEnd has it, or one of the kUnfinished values
+    int monster = 0;             //what did the killing, in the game's own coding
+    int score = 0;
+    int keylog_offset = 0;       //where the keys start in the save file
+    int keylog_size = 0;
+};
+
+//A corpus of save files summed up in one file that queries read through a
+//memory mapping.  Each field is a column of 32 bit values, one per game, so a
+//query only touches the columns it filters on; paths and version names sit
+//in a string pool at the end.  The file is written once and replaced whole.
+//
+//    header, version table, one column after another, string pool
+class CorpusIndex
+{
+public:
+    enum Column
+    {
+        kPath,                   //offset in the string pool
+        kVersion,                //index in the version table
+        kSeed,
+        kKeys,
+        kDepth,
+        kMaxDepth,
+        kFlags,
+        kMonster,
+        kScore,
+        kKeylogOffset,
+        kKeylogSize,
+        kColumnCount
+    };
+
+    //flags for a game that didn't end
+    static const int kUnfinished = -1;      //the keys ran out first
+    static const int kUnreadable = -2;      //the save or its game couldn't be read
+
+    explicit CorpusIndex(const std::string& path);
+    ~CorpusIndex();
+
+    int Count() const;
+    const int32_t* Get(Column column) const;
+
+    int VersionCount() const;
+    const char* VersionName(int version) const;
+    //-1 if no game in the index has the version
+    int FindVersion(const std::string& name) const;
+
+    const char* Path(int row) const;
+    IndexEntry Entry(int row) const;
+
+    //Replaces the index at path in a single rename
+    static void Write(const std::string& path, const std::vector<IndexEntry>& entries);
+
+private:
+    struct Header;
+
+    void Close();
+    const char* String(int32_t offset) const;
+
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    const Header* m_header = nullptr;
+    intptr_t m_file;
+    intptr_t m_mapping;
+};
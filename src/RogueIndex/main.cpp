@@ -0,0 +1,532 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include <Windows.h>
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+#include <display_interface.h>
+#include <input_interface.h>
+#include <agent_state.h>
+#include "engine_library.h"
+#include "environment.h"
+#include "game_config.h"
+#include "utility.h"
+#include "corpus_index.h"
+
+#ifndef _WIN32
+extern char** environ;
+#endif
+
+//Indexes a corpus of save files so games can be found without replaying
+//them again: build replays every save headlessly, a batch side by side, and
+//writes what came of each to a columnar index; query filters the index
+//through a memory mapping; keys fetches a game's keys straight from where
+//the index says they start in its save file.
+
+typedef int(*game_main_fn)(int, char**, char**);
+typedef void(*init_game_fn)(DisplayInterface*, InputInterface*, int lines, int cols);
+
+namespace
+{
+    //as SdlRogue writes them
+    const unsigned char kSaveVersion = 2;
+
+    struct Options
+    {
+        std::string index;
+        std::string command;
+        std::vector<std::string> paths;  //saves and directories of them to build from
+        std::string engines;             //directory the engine libraries are in
+        int threads = 0;
+
+        //query filters, each unset unless given
+        std::string version;
+        bool has_seed = false;
+        int seed = 0;
+        int depth = -1;
+        int min_depth = -1;
+        int flags = INT32_MIN;
+        int monster = -1;
+        int min_score = -1;
+        int count = 0;
+
+        int row = -1;
+        bool raw = false;
+    };
+
+    void Usage()
+    {
+        fprintf(stderr,
+            "usage: RogueIndex <index> build [--engines dir] [--threads n] <save or directory> ...\n"
+            "       RogueIndex <index> query [--version v] [--seed n] [--depth n] [--min-depth n]\n"
+            "                                [--flags n] [--monster c] [--min-score n] [--count n]\n"
+            "       RogueIndex <index> keys [--raw] <row>\n"
+            "  build      replay every save, searching directories for .sav files, and write the index\n"
+            "  query      print the games that match every filter given\n"
+            "  keys       print a game's keys, with C escapes unless --raw\n"
+            "  --engines  where the engine libraries are (default: the current directory)\n"
+            "  --threads  saves replayed side by side (default: one per core)\n"
+            "  --depth    the level the game ended on\n"
+            "  --min-depth  the deepest level reached, at least\n"
+            "  --flags    0 killed, 1 quit, 2 won, 3 killed with the amulet, -1 unfinished, -2 unreadable\n"
+            "  --monster  what did the killing, e.g. X, in the game's own coding\n");
+        exit(1);
+    }
+
+    Options ParseArgs(int argc, char** argv)
+    {
+        Options o;
+        if (argc < 3)
+            Usage();
+        o.index = argv[1];
+        o.command = argv[2];
+        for (int i = 3; i < argc; ++i) {
+            std::string s(argv[i]);
+            bool has_value = i + 1 < argc;
+            if (s == "--engines" && has_value)
+                o.engines = argv[++i];
+            else if (s == "--threads" && has_value)
+                o.threads = atoi(argv[++i]);
+            else if (s == "--version" && has_value)
+                o.version = argv[++i];
+            else if (s == "--seed" && has_value) {
+                o.seed = atoi(argv[++i]);
+                o.has_seed = true;
+            }
+            else if (s == "--depth" && has_value)
+                o.depth = atoi(argv[++i]);
+            else if (s == "--min-depth" && has_value)
+                o.min_depth = atoi(argv[++i]);
+            else if (s == "--flags" && has_value)
+                o.flags = atoi(argv[++i]);
+            else if (s == "--monster" && has_value) {
+                std::string m(argv[++i]);
+                o.monster = m.size() == 1 ? (unsigned char)m[0] : atoi(m.c_str());
+            }
+            else if (s == "--min-score" && has_value)
+                o.min_score = atoi(argv[++i]);
+            else if (s == "--count" && has_value)
+                o.count = atoi(argv[++i]);
+            else if (s == "--raw")
+                o.raw = true;
+            else if (s[0] != '-')
+                o.paths.push_back(s);
+            else
+                Usage();
+        }
+
+        if (o.command == "build") {
+            if (o.paths.empty())
+                Usage();
+        }
+        else if (o.command == "keys") {
+            if (o.paths.size() != 1)
+                Usage();
+            o.row = atoi(o.paths[0].c_str());
+        }
+        else if (o.command != "query" || !o.paths.empty()) {
+            Usage();
+        }
+        if (!o.engines.empty() && o.engines.back() != '/' && o.engines.back() != '\\')
+            o.engines += '/';
+        if (o.threads <= 0)
+            o.threads = std::max(1u, std::thread::hardware_concurrency());
+        if (o.count < 0)
+            Usage();
+        return o;
+    }
+
+    void SetEnv(const std::string& name, const std::string& value)
+    {
+#ifdef _WIN32
+        _putenv((name + "=" + value).c_str());
+#else
+        if (value.empty())
+            unsetenv(name.c_str());
+        else
+            setenv(name.c_str(), value.c_str(), 1);
+#endif
+    }
+
+    bool HasExtension(const std::string& path, const std::string& extension)
+    {
+        return path.size() >= extension.size() &&
+            std::equal(extension.rbegin(), extension.rend(), path.rbegin(), [](char a, char b) { return tolower(a) == tolower(b); });
+    }
+
+    //Every save in a directory and those under it, or the path itself if
+    //it's a file
+    void FindSaves(const std::string& path, std::vector<std::string>* saves)
+    {
+        std::vector<std::string> names;
+        bool is_dir = false;
+#ifdef _WIN32
+        WIN32_FIND_DATA data;
+        HANDLE h = FindFirstFile((path + "\\*").c_str(), &data);
+        if (h != INVALID_HANDLE_VALUE) {
+            is_dir = true;
+            do {
+                if (data.cFileName[0] != '.')
+                    names.push_back(path + "\\" + data.cFileName);
+            } while (FindNextFile(h, &data));
+            FindClose(h);
+        }
+#else
+        if (DIR* dir = opendir(path.c_str())) {
+            is_dir = true;
+            while (dirent* e = readdir(dir)) {
+                if (e->d_name[0] != '.')
+                    names.push_back(path + "/" + e->d_name);
+            }
+            closedir(dir);
+        }
+#endif
+        if (!is_dir) {
+            saves->push_back(path);
+            return;
+        }
+
+        for (const auto& name : names) {
+#ifdef _WIN32
+            DWORD attributes = GetFileAttributes(name.c_str());
+            bool sub_dir = attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+#else
+            struct stat st;
+            bool sub_dir = stat(name.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+            if (sub_dir)
+                FindSaves(name, saves);
+            else if (HasExtension(name, ".sav"))
+                saves->push_back(name);
+        }
+    }
+
+    //The games read their seed and options from the process environment, so
+    //only one game at a time can be between setting it and reading it
+    std::mutex s_env_mutex;
+
+    //Thrown out of GetChar once a save's keys run out
+    struct OutOfKeys {};
+
+    //A game with no screen, playing a save's keys as SdlRogue replays them:
+    //every read takes the next key, waiting for one or not
+    class Replay : public DisplayInterface, public InputInterface
+    {
+    public:
+        explicit Replay(const std::string& keys) :
+            m_keys(keys)
+        {
+        }
+
+        void Run(const std::string& library, const std::string& options, const std::string& seed, Coord dimensions, IndexEntry* e)
+        {
+            EngineLibrary engine(library);
+            init_game_fn init = (init_game_fn)engine.Get("init_game");
+            game_main_fn game = (game_main_fn)engine.Get("rogue_main");
+            get_game_end_fn get_end = (get_game_end_fn)engine.Find("get_game_end");
+            m_get_state = (get_agent_state_fn)engine.Find("get_agent_state");
+
+            m_env_lock = std::unique_lock<std::mutex>(s_env_mutex);
+            SetEnv("SEED", seed);
+            SetEnv("ROGUEOPTS", options);
+            try {
+                (*init)(this, this, dimensions.y, dimensions.x);
+                (*game)(0, 0, environ);
+            }
+            catch (const OutOfKeys&) {
+            }
+            if (m_env_lock.owns_lock())
+                m_env_lock.unlock();
+
+            e->keys = (int)m_next;
+            e->depth = m_state.depth;
+            e->score = m_state.gold;
+            e->flags = CorpusIndex::kUnfinished;
+
+            //a game can end with keys to spare, or be closed at its tombstone
+            //with the last key never pressed
+            GameEnd end;
+            if (get_end && (*get_end)(&end)) {
+                e->flags = end.flags;
+                e->monster = end.monster;
+                e->score = end.score;
+            }
+        }
+
+        virtual void SetDimensions(Coord dimensions) override {}
+        virtual void UpdateRegion(uint32_t* buf) override {}
+        virtual void UpdateRegion(uint32_t* buf, Region rect) override {}
+        virtual void MoveCursor(Coord pos) override {}
+        virtual void SetCursor(bool enable) override {}
+        virtual void PlaySound(const std::string& id) override {}
+
+        virtual char GetChar(bool block, bool for_string, bool *is_replay) override
+        {
+            //the game has read its seed by the time it wants a key
+            if (m_env_lock.owns_lock())
+                m_env_lock.unlock();
+
+            if (m_get_state) {
+                (*m_get_state)(&m_state);
+                m_deepest = std::max(m_deepest, m_state.depth);
+            }
+            if (m_next >= m_keys.size()) {
+                if (!block)
+                    return 0;
+                throw OutOfKeys();
+            }
+            if (is_replay)
+                *is_replay = true;
+            return m_keys[m_next++];
+        }
+
+        virtual void Flush() override {}
+
+        int Deepest() const { return m_deepest; }
+
+    private:
+        const std::string& m_keys;
+        size_t m_next = 0;
+        std::unique_lock<std::mutex> m_env_lock;
+        get_agent_state_fn m_get_state = nullptr;
+        AgentState m_state = {};
+        int m_deepest = 0;
+    };
+
+    const GameConfig& FindGame(const std::string& name)
+    {
+        for (const auto& game : s_options) {
+            if (game.name == name)
+                return game;
+        }
+        throw_error("Unknown game: " + name);
+        return s_options[0];
+    }
+
+    //Reads a save's header as SdlRogue::ReadSaveHeader does, and replays its keys
+    void IndexSave(const Options& o, IndexEntry* e)
+    {
+        std::ifstream file(e->path, std::ios::binary | std::ios::in);
+        if (!file)
+            throw_error("Couldn't open save file");
+
+        unsigned char version = 0;
+        uint16_t restore_count = 0;
+        std::string name;
+        Environment env;
+        Read(file, &version);
+        Read(file, &restore_count);
+        ReadShortString(file, &name);
+        env.Deserialize(file);
+        if (!file || version == 0 || version > kSaveVersion)
+            throw_error("Not a save file");
+        e->version = name;
+
+        env.Set("in_replay", "true");
+        if (version == 1) {
+            env.Set("trap_bugfix", "false");
+            env.Set("room_bugfix", "false");
+            env.Set("confused_bugfix", "false");
+        }
+        std::string seed;
+        env.Get("seed", &seed);
+        e->seed = atoi(seed.c_str());
+
+        e->keylog_offset = (int)file.tellg();
+        std::string keys((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        e->keylog_size = (int)keys.size();
+
+        const GameConfig& game = FindGame(e->version);
+        Coord dimensions = game.screen;
+        std::string value;
+        if (env.Get("small_screen", &value) && value == "true")
+            dimensions = game.small_screen;
+
+        Replay replay(keys);
+        replay.Run(o.engines + game.dll_name, env.RogueOpts(game.is_unix), seed, dimensions, e);
+        e->max_depth = replay.Deepest();
+    }
+
+    void Build(const Options& o)
+    {
+        std::vector<std::string> saves;
+        for (const auto& path : o.paths)
+            FindSaves(path, &saves);
+        std::sort(saves.begin(), saves.end());
+        saves.erase(std::unique(saves.begin(), saves.end()), saves.end());
+
+        std::vector<IndexEntry> entries(saves.size());
+        for (size_t i = 0; i < saves.size(); ++i)
+            entries[i].path = saves[i];
+
+        auto start = std::chrono::steady_clock::now();
+        std::atomic<size_t> next(0);
+        std::atomic<int> done(0), unreadable(0);
+        std::mutex report_mutex;
+        auto work = [&] {
+            for (size_t i = next++; i < entries.size(); i = next++) {
+                IndexEntry& e = entries[i];
+                try {
+                    IndexSave(o, &e);
+                }
+                catch (const std::exception& ex) {
+                    e.flags = CorpusIndex::kUnreadable;
+                    ++unreadable;
+                    std::lock_guard<std::mutex> lock(report_mutex);
+                    fprintf(stderr, "%s: %s\n", e.path.c_str(), ex.what());
+                }
+                if (++done % 1000 == 0) {
+                    std::lock_guard<std::mutex> lock(report_mutex);
+                    fprintf(stderr, "%d of %d\n", done.load(), (int)entries.size());
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int i = 1; i < std::min(o.threads, (int)entries.size()); ++i)
+            threads.emplace_back(work);
+        work();
+        for (auto& t : threads)
+            t.join();
+
+        CorpusIndex::Write(o.index, entries);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        fprintf(stderr, "indexed %d saves in %.1fs, %d unreadable\n", (int)entries.size(), seconds, unreadable.load());
+    }
+
+    std::string MonsterText(int monster)
+    {
+        if (monster > ' ' && monster <= '~')
+            return std::string(1, (char)monster);
+        return monster ? std::to_string(monster) : "-";
+    }
+
+    void Query(const Options& o)
+    {
+        CorpusIndex index(o.index);
+        std::vector<int> rows(index.Count());
+        for (int i = 0; i < index.Count(); ++i)
+            rows[i] = i;
+
+        //each filter reads just its own column, for the rows still left
+        auto filter = [&](CorpusIndex::Column c, std::function<bool(int32_t)> keep) {
+            const int32_t* column = index.Get(c);
+            rows.erase(std::remove_if(rows.begin(), rows.end(), [&](int r) { return !keep(column[r]); }), rows.end());
+        };
+        if (!o.version.empty()) {
+            int version = index.FindVersion(o.version);
+            filter(CorpusIndex::kVersion, [=](int32_t v) { return v == version; });
+        }
+        if (o.has_seed)
+            filter(CorpusIndex::kSeed, [&](int32_t v) { return v == o.seed; });
+        if (o.depth >= 0)
+            filter(CorpusIndex::kDepth, [&](int32_t v) { return v == o.depth; });
+        if (o.min_depth >= 0)
+            filter(CorpusIndex::kMaxDepth, [&](int32_t v) { return v >= o.min_depth; });
+        if (o.flags != INT32_MIN)
+            filter(CorpusIndex::kFlags, [&](int32_t v) { return v == o.flags; });
+        if (o.monster >= 0)
+            filter(CorpusIndex::kMonster, [&](int32_t v) { return v == o.monster; });
+        if (o.min_score >= 0)
+            filter(CorpusIndex::kScore, [&](int32_t v) { return v >= o.min_score; });
+        if (o.count > 0 && (int)rows.size() > o.count)
+            rows.resize(o.count);
+
+        printf("row\tversion\tseed\tkeys\tdepth\tdeepest\tflags\tmonster\tscore\tpath\n");
+        for (int r : rows) {
+            IndexEntry e = index.Entry(r);
+            printf("%d\t%s\t%d\t%d\t%d\t%d\t%d\t%s\t%d\t%s\n", r, e.version.c_str(), e.seed, e.keys, e.depth,
+                e.max_depth, e.flags, MonsterText(e.monster).c_str(), e.score, e.path.c_str());
+        }
+    }
+
+    //The keys as RogueDiff's --script reads them
+    std::string Escape(const std::string& keys)
+    {
+        std::string s;
+        char buf[8];
+        for (char c : keys) {
+            if (c == '\n')
+                s += "\\n";
+            else if (c == '\t')
+                s += "\\t";
+            else if (c == '\x1b')
+                s += "\\e";
+            else if (c == '\\')
+                s += "\\\\";
+            else if (c < ' ' || c > '~') {
+                sprintf(buf, "\\x%02x", (unsigned char)c);
+                s += buf;
+            }
+            else
+                s += c;
+        }
+        return s;
+    }
+
+    //Reads only the keys, from where the index says they are
+    void Keys(const Options& o)
+    {
+        CorpusIndex index(o.index);
+        if (o.row < 0 || o.row >= index.Count())
+            throw_error("No row " + std::to_string(o.row));
+        IndexEntry e = index.Entry(o.row);
+        if (e.flags == CorpusIndex::kUnreadable)
+            throw_error(e.path + " couldn't be read when the index was built");
+
+        std::ifstream file(e.path, std::ios::binary | std::ios::in);
+        std::string keys(e.keylog_size, 0);
+        file.seekg(e.keylog_offset);
+        file.read(&keys[0], keys.size());
+        if (!file)
+            throw_error("Couldn't read the keys from " + e.path);
+
+        if (o.raw) {
+#ifdef _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif
+            fwrite(keys.data(), 1, keys.size(), stdout);
+        }
+        else
+            printf("%s\n", Escape(keys).c_str());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options o = ParseArgs(argc, argv);
+
+    try {
+        if (o.command == "build")
+            Build(o);
+        else if (o.command == "query")
+            Query(o);
+        else if (o.command == "keys")
+            Keys(o);
+    }
+    catch (const std::runtime_error& e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
+
+DisplayInterface::~DisplayInterface() {}
+InputInterface::~InputInterface() {}
@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include "leaderboard.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+void throw_error(const std::string& msg);
+
+namespace
+{
+    //Every log starts with this and a generation that changes each time the
+    //log is compacted, so readers can tell they need to start over.
+    const char kHeader[] = "#rogue scores ";
+    const int kFields = 9;
+
+    std::string NewGeneration()
+    {
+        std::random_device rd;
+        return std::to_string((long long)time(nullptr)) + "-" + std::to_string(rd());
+    }
+
+    //Tabs and line breaks would split the entry
+    std::string Clean(const std::string& s)
+    {
+        std::string r(s);
+        std::replace_if(r.begin(), r.end(), [](char c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+        return r;
+    }
+
+    std::string Format(const ScoreEntry& e)
+    {
+        std::ostringstream ss;
+        ss << Clean(e.version) << '\t' << e.seed << '\t' << e.score << '\t' << e.depth << '\t'
+           << e.rank << '\t' << e.flags << '\t' << e.monster << '\t' << e.time << '\t'
+           << Clean(e.name) << '\n';
+        return ss.str();
+    }
+
+    bool ParseNumber(const std::string& s, long long* n)
+    {
+        if (s.empty())
+            return false;
+        char* end;
+        *n = strtoll(s.c_str(), &end, 10);
+        return *end == '\0';
+    }
+
+    bool Parse(const std::string& line, ScoreEntry* e)
+    {
+        std::vector<std::string> fields;
+        size_t start = 0;
+        for (int i = 0; i < kFields - 1; ++i) {
+            size_t tab = line.find('\t', start);
+            if (tab == std::string::npos)
+                return false;
+            fields.push_back(line.substr(start, tab - start));
+            start = tab + 1;
+        }
+        fields.push_back(line.substr(start));
+
+        long long n[kFields - 2];
+        for (int i = 0; i < kFields - 2; ++i) {
+            if (!ParseNumber(fields[i + 1], &n[i]))
+                return false;
+        }
+        e->version = fields[0];
+        e->seed = (int)n[0];
+        e->score = (int)n[1];
+        e->depth = (int)n[2];
+        e->rank = (int)n[3];
+        e->flags = (int)n[4];
+        e->monster = (int)n[5];
+        e->time = n[6];
+        e->name = fields[8];
+        return true;
+    }
+
+    //Reads a file from the given offset to the end; false if there's no file
+    bool ReadFrom(const std::string& path, long long pos, std::string* data)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        file.seekg(pos);
+        std::ostringstream ss;
+        ss << file.rdbuf();
+        *data = ss.str();
+        return true;
+    }
+
+    std::string ReadHeader(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    //Writes data in one call, either onto the end of the file or as the whole
+    //of a new one.  A new file is flushed to disk before returning.
+    void WriteAll(const std::string& path, const std::string& data, bool append)
+    {
+#ifdef _WIN32
+        HANDLE h = CreateFile(path.c_str(), append ? FILE_APPEND_DATA : GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, append ? OPEN_ALWAYS : CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (h == INVALID_HANDLE_VALUE)
+            throw_error("Couldn't open " + path);
+        DWORD written = 0;
+        BOOL ok = WriteFile(h, data.data(), (DWORD)data.size(), &written, NULL) && written == data.size();
+        if (ok && !append)
+            ok = FlushFileBuffers(h);
+        CloseHandle(h);
+#else
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0666);
+        if (fd < 0)
+            throw_error("Couldn't open " + path);
+        bool ok = write(fd, data.data(), data.size()) == (ssize_t)data.size();
+        if (ok && !append)
+            ok = fsync(fd) == 0;
+        close(fd);
+#endif
+        if (!ok)
+            throw_error("Couldn't write " + path);
+    }
+
+    void Replace(const std::string& from, const std::string& to)
+    {
+#ifdef _WIN32
+        bool ok = MoveFileEx(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        bool ok = rename(from.c_str(), to.c_str()) == 0;
+#endif
+        if (!ok)
+            throw_error("Couldn't replace " + to);
+    }
+}
+
+//Holds a lock on the .lock file for as long as it exists
+struct Leaderboard::FileLock
+{
+    FileLock(intptr_t file, LockMode mode) : m_file(file)
+    {
+#ifdef _WIN32
+        OVERLAPPED ov = {};
+        if (!LockFileEx((HANDLE)m_file, mode == kExclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0, 0, MAXDWORD, MAXDWORD, &ov))
+            throw_error("Couldn't lock the leaderboard");
+#else
+        if (flock((int)m_file, mode == kExclusive ? LOCK_EX : LOCK_SH) != 0)
+            throw_error("Couldn't lock the leaderboard");
+#endif
+    }
+
+    ~FileLock()
+    {
+#ifdef _WIN32
+        OVERLAPPED ov = {};
+        UnlockFileEx((HANDLE)m_file, 0, MAXDWORD, MAXDWORD, &ov);
+#else
+        flock((int)m_file, LOCK_UN);
+#endif
+    }
+
+    intptr_t m_file;
+};
+
+Leaderboard::Leaderboard(const std::string& path) :
+    m_path(path)
+{
+    std::string lock_path = path + ".lock";
+#ifdef _WIN32
+    HANDLE h = CreateFile(lock_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h == INVALID_HANDLE_VALUE)
+        throw_error("Couldn't open " + lock_path);
+    m_lock_file = (intptr_t)h;
+#else
+    int fd = open(lock_path.c_str(), O_RDWR | O_CREAT, 0666);
+    if (fd < 0)
+        throw_error("Couldn't open " + lock_path);
+    m_lock_file = fd;
+#endif
+}
+
+Leaderboard::~Leaderboard()
+{
+#ifdef _WIN32
+    CloseHandle((HANDLE)m_lock_file);
+#else
+    close((int)m_lock_file);
+#endif
+}
+
+void Leaderboard::Add(const ScoreEntry& entry)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    FileLock lock(m_lock_file, kExclusive);
+    Refresh();
+
+    //a log without a whole header line is new, or was cut short by a crash
+    //while its first entry was going in
+    if (m_generation.empty()) {
+        WriteAll(m_path, kHeader + NewGeneration() + "\n" + Format(entry), false);
+        return;
+    }
+
+    //close off a line some writer didn't finish
+    std::string data = m_torn ? "\n" : "";
+    data += Format(entry);
+    WriteAll(m_path, data, true);
+}
+
+std::vector<ScoreEntry> Leaderboard::Top(size_t count, const std::string& version, int seed)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    {
+        FileLock lock(m_lock_file, kShared);
+        Refresh();
+    }
+
+    const std::vector<size_t>* list = &m_all;
+    static const std::vector<size_t> empty;
+    if (seed != kAnySeed) {
+        auto i = m_by_seed.find(seed);
+        list = (i == m_by_seed.end()) ? &empty : &i->second;
+    }
+    else if (!version.empty()) {
+        auto i = m_by_version.find(version);
+        list = (i == m_by_version.end()) ? &empty : &i->second;
+    }
+
+    std::vector<ScoreEntry> top;
+    for (size_t i : *list) {
+        if (top.size() >= count)
+            break;
+        if (version.empty() || m_entries[i].version == version)
+            top.push_back(m_entries[i]);
+    }
+    return top;
+}
+
+void Leaderboard::Compact(size_t keep)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    FileLock lock(m_lock_file, kExclusive);
+    Refresh();
+
+    //m_all is best first, so the first keep of each version and seed stay
+    std::vector<size_t> kept;
+    std::map<std::pair<std::string, int>, size_t> counts;
+    for (size_t i : m_all) {
+        size_t& n = counts[std::make_pair(m_entries[i].version, m_entries[i].seed)];
+        if (keep == 0 || n < keep) {
+            kept.push_back(i);
+            ++n;
+        }
+    }
+    std::sort(kept.begin(), kept.end());
+
+    std::string data = kHeader + NewGeneration() + "\n";
+    for (size_t i : kept)
+        data += Format(m_entries[i]);
+
+    std::string temp = m_path + ".tmp";
+    WriteAll(temp, data, false);
+    Replace(temp, m_path);
+
+    Reset();
+    Refresh();
+}
+
+//Brings the index up to date with the log.  The caller holds the file lock.
+void Leaderboard::Refresh()
+{
+    if (!m_generation.empty() && ReadHeader(m_path) != m_generation)
+        Reset();
+
+    std::string data;
+    if (!ReadFrom(m_path, m_read_pos, &data)) {
+        Reset();
+        return;
+    }
+
+    //a whole log is sorted once at the end rather than a line at a time
+    bool loading = m_read_pos == 0;
+    size_t start = 0;
+    for (;;) {
+        size_t end = data.find('\n', start);
+        if (end == std::string::npos)
+            break;
+        std::string line = data.substr(start, end - start);
+        if (m_read_pos == 0 && start == 0) {
+            if (line.compare(0, sizeof(kHeader) - 1, kHeader) != 0)
+                throw_error(m_path + " isn't a leaderboard");
+            m_generation = line;
+        }
+        else {
+            ScoreEntry entry;
+            if (Parse(line, &entry))
+                Index(entry, !loading);
+        }
+        start = end + 1;
+    }
+    if (loading)
+        SortAll();
+    m_read_pos += start;
+    m_torn = start < data.size();
+}
+
+void Leaderboard::Reset()
+{
+    m_generation.clear();
+    m_read_pos = 0;
+    m_torn = false;
+    m_entries.clear();
+    m_all.clear();
+    m_by_version.clear();
+    m_by_seed.clear();
+}
+
+//Adds an entry to the lists, in place if sorted, else at the end for SortAll
+void Leaderboard::Index(const ScoreEntry& entry, bool sorted)
+{
+    size_t i = m_entries.size();
+    m_entries.push_back(entry);
+    if (sorted) {
+        Insert(m_all, i);
+        Insert(m_by_version[entry.version], i);
+        Insert(m_by_seed[entry.seed], i);
+    }
+    else {
+        m_all.push_back(i);
+        m_by_version[entry.version].push_back(i);
+        m_by_seed[entry.seed].push_back(i);
+    }
+}
+
+//Puts every list best first, keeping equal scores in the order they were added
+void Leaderboard::SortAll()
+{
+    auto better = [this](size_t a, size_t b) { return m_entries[a].score > m_entries[b].score; };
+    std::stable_sort(m_all.begin(), m_all.end(), better);
+    for (auto& v : m_by_version)
+        std::stable_sort(v.second.begin(), v.second.end(), better);
+    for (auto& s : m_by_seed)
+        std::stable_sort(s.second.begin(), s.second.end(), better);
+}
+
+//Keeps a list best first, with equal scores in the order they were added
+void Leaderboard::Insert(std::vector<size_t>& list, size_t i)
+{
+    int score = m_entries[i].score;
+    auto pos = std::upper_bound(list.begin(), list.end(), score,
+        [this](int s, size_t j) { return s > m_entries[j].score; });
+    list.insert(pos, i);
+}
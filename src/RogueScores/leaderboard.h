@@ -0,0 +1,70 @@
+#pragma once
+#include <climits>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//One finished game
+struct ScoreEntry
+{
+    std::string version;         //which game, e.g. the engine library's name
+    int seed = 0;
+    std::string name;
+    int score = 0;               //gold
+    int depth = 0;               //deepest level reached
+    int rank = 0;                //level of mastery
+    int flags = 0;               //0 killed, 1 quit, 2 won, 3 killed with the amulet, as the games' score() has it
+    int monster = 0;             //what did the killing, in the game's own coding
+    long long time = 0;          //seconds since 1970
+};
+
+//Scores from every game and every process, kept in one append-only log.
+//
+//Each entry is a line of text added with a single write while holding an
+//exclusive lock on a companion .lock file, so any number of processes can add
+//to the log at once.  A line that a crash left half written is skipped and
+//closed off by the next writer.  Queries come from an in-memory index that
+//first picks up whatever other processes have added since the last call.
+class Leaderboard
+{
+public:
+    explicit Leaderboard(const std::string& path);
+    ~Leaderboard();
+
+    void Add(const ScoreEntry& entry);
+
+    //Best scores first, optionally only one version and/or one seed
+    std::vector<ScoreEntry> Top(size_t count, const std::string& version = "", int seed = kAnySeed);
+
+    //Rewrite the log keeping the best keep entries for each version and seed
+    //(all of them if keep is 0) and without any half written lines.  The new
+    //log replaces the old one in a single rename.
+    void Compact(size_t keep);
+
+    static const int kAnySeed = INT_MIN;
+
+private:
+    enum LockMode { kShared, kExclusive };
+    struct FileLock;
+
+    void Refresh();
+    void Reset();
+    void Index(const ScoreEntry& entry, bool sorted);
+    void SortAll();
+    void Insert(std::vector<size_t>& list, size_t i);
+
+    std::string m_path;
+    std::string m_generation;    //header of the log the index was built from
+    long long m_read_pos = 0;    //bytes of the log in the index
+    bool m_torn = false;         //the log ends in a half written line
+    intptr_t m_lock_file;
+    std::mutex m_mutex;          //for threads sharing this object
+
+    //indices into m_entries, best score first
+    std::vector<ScoreEntry> m_entries;
+    std::vector<size_t> m_all;
+    std::map<std::string, std::vector<size_t>> m_by_version;
+    std::map<int, std::vector<size_t>> m_by_seed;
+};
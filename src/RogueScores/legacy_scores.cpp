@@ -0,0 +1,103 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "legacy_scores.h"
+
+void throw_error(const std::string& msg);
+
+namespace
+{
+    const size_t kTopScores = 10;
+
+    //5.4.2: from vers.c and the score code in save.c
+    namespace v542
+    {
+        const char encstr[] = "\300k||`\251Y.'\305\321\201+\277~r\"]\240_\223=1\341)\222\212\241t;\t$\270\314/<#\201\254";
+        const char statlist[] = "\355kl{+\204\255\313idJ\361\214=4:\311\271\341wK<\312\321\213,,7\271/Rk%\b\312\f\246";
+        const size_t kNameSize = 1024;
+        const size_t kLineSize = 100;
+
+        //encwrite: the key starts over with every call
+        void EncWrite(std::ofstream& out, const char* start, size_t size)
+        {
+            std::vector<char> buf(start, start + size);
+            const char* e1 = encstr;
+            const char* e2 = statlist;
+            char fb = 0;
+            for (char& c : buf) {
+                c ^= *e1 ^ *e2 ^ fb;
+                int temp = *e1++;
+                fb = fb + ((char)(temp * *e2++));
+                if (*e1 == '\0')
+                    e1 = encstr;
+                if (*e2 == '\0')
+                    e2 = statlist;
+            }
+            out.write(buf.data(), buf.size());
+        }
+
+        void Write(std::ofstream& out, const std::vector<ScoreEntry>& top)
+        {
+            for (size_t i = 0; i < kTopScores; ++i) {
+                char name[kNameSize] = {};
+                char line[kLineSize] = {};
+                if (i < top.size()) {
+                    const ScoreEntry& e = top[i];
+                    strncpy(name, e.name.c_str(), kNameSize - 1);
+                    snprintf(line, kLineSize, " %u %d %u %u %d %x \n", 0u, e.score, (unsigned)e.flags, (unsigned)e.monster, e.depth, (unsigned)e.time);
+                }
+                else {
+                    snprintf(line, kLineSize, " %u %d %u %u %d %x \n", 0u, 0, 0u, 0u, 0, 0u);
+                }
+                EncWrite(out, name, kNameSize);
+                EncWrite(out, line, kLineSize);
+            }
+        }
+    }
+
+    //PC: from rip.cpp, written raw and ended by the first entry with no gold
+    namespace pc
+    {
+        struct LeaderboardEntry
+        {
+            char name[38];
+            int rank;
+            int gold;
+            int fate;
+            int level;
+        };
+
+        void Write(std::ofstream& out, const std::vector<ScoreEntry>& top)
+        {
+            for (size_t i = 0; i < top.size() && i < kTopScores && top[i].score > 0; ++i) {
+                const ScoreEntry& e = top[i];
+                LeaderboardEntry entry = {};
+                strncpy(entry.name, e.name.c_str(), sizeof(entry.name) - 1);
+                entry.rank = e.rank;
+                entry.gold = e.score;
+                entry.fate = e.flags ? e.flags : e.monster;
+                entry.level = e.depth;
+                out.write((const char*)&entry, sizeof(entry));
+            }
+        }
+    }
+}
+
+void ExportLegacyScores(const std::vector<ScoreEntry>& top, const std::string& format, const std::string& path)
+{
+    if (format != "5.4.2" && format != "pc")
+        throw_error("Unknown score file format: " + format);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw_error("Couldn't open " + path);
+
+    if (format == "5.4.2")
+        v542::Write(out, top);
+    else
+        pc::Write(out, top);
+
+    out.close();
+    if (!out)
+        throw_error("Couldn't write " + path);
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "leaderboard.h"
+
+//Writes the best entries as a game's own score file, so that game's top ten
+//shows them.  The formats are "5.4.2" for rogue54.scr and "pc" for
+//roguepc.scr and roguepc11.scr.  Entries past the file's ten are left out.
+void ExportLegacyScores(const std::vector<ScoreEntry>& top, const std::string& format, const std::string& path);
@@ -0,0 +1,134 @@
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include "leaderboard.h"
+#include "legacy_scores.h"
+
+//Looks after the shared leaderboard: lists the best scores, adds one by hand,
+//compacts the log, and writes a game's own score file from it.
+
+void throw_error(const std::string& msg)
+{
+    throw std::runtime_error(msg);
+}
+
+namespace
+{
+    struct Options
+    {
+        std::string log;
+        std::string command;
+        std::string version;
+        std::string format;
+        std::string file;
+        int seed = Leaderboard::kAnySeed;
+        int count = 10;
+        int keep = 0;
+        ScoreEntry entry;
+    };
+
+    void Usage()
+    {
+        fprintf(stderr,
+            "usage: RogueScores <log> top [--count n] [--version v] [--seed n]\n"
+            "       RogueScores <log> add --version v --seed n --score n [--depth n] [--rank n]\n"
+            "                             [--flags n] [--monster n] [--name s]\n"
+            "       RogueScores <log> compact [--keep n]\n"
+            "       RogueScores <log> export --format 5.4.2|pc [--version v] [--seed n] <score file>\n"
+            "  top      print the best scores, optionally for one version and/or seed\n"
+            "  add      add a score\n"
+            "  compact  rewrite the log keeping the best n per version and seed (default all)\n"
+            "  export   write the best ten in a game's own score file format\n");
+        exit(1);
+    }
+
+    Options ParseArgs(int argc, char** argv)
+    {
+        Options o;
+        if (argc < 3)
+            Usage();
+        o.log = argv[1];
+        o.command = argv[2];
+        for (int i = 3; i < argc; ++i) {
+            std::string s(argv[i]);
+            bool has_value = i + 1 < argc;
+            if (s == "--version" && has_value)
+                o.version = argv[++i];
+            else if (s == "--seed" && has_value)
+                o.seed = atoi(argv[++i]);
+            else if (s == "--count" && has_value)
+                o.count = atoi(argv[++i]);
+            else if (s == "--keep" && has_value)
+                o.keep = atoi(argv[++i]);
+            else if (s == "--format" && has_value)
+                o.format = argv[++i];
+            else if (s == "--score" && has_value)
+                o.entry.score = atoi(argv[++i]);
+            else if (s == "--depth" && has_value)
+                o.entry.depth = atoi(argv[++i]);
+            else if (s == "--rank" && has_value)
+                o.entry.rank = atoi(argv[++i]);
+            else if (s == "--flags" && has_value)
+                o.entry.flags = atoi(argv[++i]);
+            else if (s == "--monster" && has_value)
+                o.entry.monster = atoi(argv[++i]);
+            else if (s == "--name" && has_value)
+                o.entry.name = argv[++i];
+            else if (s[0] != '-' && o.file.empty())
+                o.file = s;
+            else
+                Usage();
+        }
+
+        if (o.command == "add") {
+            if (o.version.empty() || o.seed == Leaderboard::kAnySeed)
+                Usage();
+            o.entry.version = o.version;
+            o.entry.seed = o.seed;
+            o.entry.time = time(nullptr);
+        }
+        else if (o.command == "export") {
+            if (o.format.empty() || o.file.empty())
+                Usage();
+        }
+        else if (o.command != "top" && o.command != "compact") {
+            Usage();
+        }
+        if (o.count <= 0 || o.keep < 0)
+            Usage();
+        return o;
+    }
+
+    void PrintScores(const std::vector<ScoreEntry>& top)
+    {
+        printf("score\tversion\tseed\tdepth\trank\tflags\tmonster\ttime\tname\n");
+        for (const auto& e : top) {
+            printf("%d\t%s\t%d\t%d\t%d\t%d\t%d\t%lld\t%s\n", e.score, e.version.c_str(), e.seed,
+                e.depth, e.rank, e.flags, e.monster, e.time, e.name.c_str());
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options o = ParseArgs(argc, argv);
+
+    try {
+        Leaderboard board(o.log);
+        if (o.command == "top")
+            PrintScores(board.Top(o.count, o.version, o.seed));
+        else if (o.command == "add")
+            board.Add(o.entry);
+        else if (o.command == "compact")
+            board.Compact(o.keep);
+        else if (o.command == "export")
+            ExportLegacyScores(board.Top(10, o.version, o.seed), o.format, o.file);
+    }
+    catch (const std::runtime_error& e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
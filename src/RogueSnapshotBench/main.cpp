@@ -0,0 +1,339 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <display_interface.h>
+#include <input_interface.h>
+#include <game_snapshot.h>
+#include "engine_library.h"
+
+#ifndef _WIN32
+extern char** environ;
+#endif
+
+//Times an engine's snapshot_game and restore_game, one call at a time, and
+//checks that a restored game carries on exactly as the original did.
+//
+//For each seed the engine plays a random walk headlessly.  At the first
+//command it waits for after --steps keys the game is snapshotted, plays on
+//for --replay more keys, and is snapshotted again.  Then the first snapshot
+//is taken and restored --calls times each, and the same keys are played
+//again from it: every screen and cursor on the way, and the game at the
+//end, have to match the first time through.
+
+typedef int(*game_main_fn)(int, char**, char**);
+typedef void(*init_game_fn)(DisplayInterface*, InputInterface*, int lines, int cols);
+
+void throw_error(const std::string& msg)
+{
+    throw std::runtime_error(msg);
+}
+
+namespace
+{
+    //the newline runs down, and gets past the tombstone of a walk that dies
+    const char kWalk[] = "hjklyubnhjklyubnHJKLs. \n";
+    const int kLines = 25;
+    const int kColumns = 80;
+
+    struct Options
+    {
+        std::string library;
+        int first = 1;
+        int count = 10;
+        int steps = 200;
+        int replay = 200;
+        int calls = 1000;
+    };
+
+    void Usage()
+    {
+        fprintf(stderr,
+            "usage: RogueSnapshotBench <engine library> [--first n] [--count n] [--steps n] [--replay n] [--calls n]\n"
+            "  --first    first seed (default 1)\n"
+            "  --count    number of seeds (default 10)\n"
+            "  --steps    keys played before the snapshot is taken (default 200)\n"
+            "  --replay   keys played on from it and then again after restoring it (default 200)\n"
+            "  --calls    snapshots and restores timed per seed (default 1000)\n");
+        exit(1);
+    }
+
+    Options ParseArgs(int argc, char** argv)
+    {
+        Options o;
+        for (int i = 1; i < argc; ++i) {
+            std::string s(argv[i]);
+            bool has_value = i + 1 < argc;
+            if (s == "--first" && has_value)
+                o.first = atoi(argv[++i]);
+            else if (s == "--count" && has_value)
+                o.count = atoi(argv[++i]);
+            else if (s == "--steps" && has_value)
+                o.steps = atoi(argv[++i]);
+            else if (s == "--replay" && has_value)
+                o.replay = atoi(argv[++i]);
+            else if (s == "--calls" && has_value)
+                o.calls = atoi(argv[++i]);
+            else if (s[0] != '-' && o.library.empty())
+                o.library = s;
+            else
+                Usage();
+        }
+        if (o.library.empty() || o.count <= 0 || o.steps < 0 || o.replay < 0 || o.calls <= 0)
+            Usage();
+        return o;
+    }
+
+    void SetEnv(const std::string& name, const std::string& value)
+    {
+#ifdef _WIN32
+        _putenv((name + "=" + value).c_str());
+#else
+        setenv(name.c_str(), value.c_str(), 1);
+#endif
+    }
+
+    //Microseconds per call: the median and the 99th percentile
+    struct Timing
+    {
+        double median = 0;
+        double p99 = 0;
+    };
+
+    Timing Summarize(std::vector<double> times)
+    {
+        std::sort(times.begin(), times.end());
+        Timing t;
+        t.median = times[times.size() / 2];
+        t.p99 = times[std::min(times.size() - 1, times.size() * 99 / 100)];
+        return t;
+    }
+
+    struct SeedResult
+    {
+        bool finished = false;       //the game lived long enough to be measured
+        size_t bytes = 0;
+        Timing snapshot;
+        Timing restore;
+        std::string mismatch;        //how the replay went astray, if it did
+    };
+
+    //Thrown out of GetChar once a seed has been measured
+    struct Finished {};
+
+    //A game with no screen that walks at random, and takes over between
+    //commands to snapshot and restore itself
+    class Bench : public DisplayInterface, public InputInterface
+    {
+    public:
+        Bench(const Options& options, int seed) :
+            m_options(options),
+            m_random(seed)
+        {
+        }
+
+        ~Bench()
+        {
+            if (m_release) {
+                (*m_release)(&m_start);
+                (*m_release)(&m_end);
+                (*m_release)(&m_scratch);
+            }
+        }
+
+        SeedResult Run(int seed)
+        {
+            EngineLibrary engine(m_options.library);
+            init_game_fn init = (init_game_fn)engine.Get("init_game");
+            game_main_fn game = (game_main_fn)engine.Get("rogue_main");
+            m_snapshot = (snapshot_game_fn)engine.Get("snapshot_game");
+            m_restore = (restore_game_fn)engine.Get("restore_game");
+            m_release = (release_snapshot_fn)engine.Get("release_snapshot");
+
+            SetEnv("SEED", std::to_string(seed));
+            try {
+                (*init)(this, this, kLines, kColumns);
+                (*game)(0, 0, environ);
+                //the game ended before it could be measured, or while the
+                //restored copy was playing keys the original lived through
+                if (m_phase == kReplaying)
+                    m_result.mismatch = "the game ended after " + std::to_string(m_replayed) + " keys";
+            }
+            catch (const Finished&) {
+            }
+            //free the snapshots while the engine that made them is loaded
+            (*m_release)(&m_start);
+            (*m_release)(&m_end);
+            (*m_release)(&m_scratch);
+            m_release = nullptr;
+            return m_result;
+        }
+
+        virtual void SetDimensions(Coord dimensions) override {}
+        virtual void UpdateRegion(uint32_t* buf) override { m_screen = buf; }
+        virtual void UpdateRegion(uint32_t* buf, Region rect) override { m_screen = buf; }
+        virtual void MoveCursor(Coord pos) override { m_cursor = pos; }
+        virtual void SetCursor(bool enable) override {}
+        virtual void PlaySound(const std::string& id) override {}
+
+        virtual char GetChar(bool block, bool for_string, bool *is_replay) override
+        {
+            if (!block)
+                return 0;
+
+            switch (m_phase) {
+            case kWalking:
+                //snapshot_game turns the game away until it wants a command
+                if (m_keys.size() >= (size_t)m_options.steps && (*m_snapshot)(&m_start) == 0) {
+                    m_phase = kRecording;
+                    m_walked = m_keys.size();
+                    m_screens.push_back(ScreenHash());
+                }
+                break;
+            case kRecording:
+                if (m_keys.size() - m_walked >= (size_t)m_options.replay && (*m_snapshot)(&m_end) == 0) {
+                    m_played = m_keys.size() - m_walked;
+                    Measure();
+                    m_phase = kReplaying;
+                    return NextReplayKey();
+                }
+                m_screens.push_back(ScreenHash());
+                break;
+            case kReplaying:
+                return NextReplayKey();
+            }
+
+            m_keys.push_back(kWalk[m_random() % (sizeof(kWalk) - 1)]);
+            return m_keys.back();
+        }
+
+        virtual void Flush() override {}
+
+    private:
+        enum Phase { kWalking, kRecording, kReplaying };
+
+        uint64_t ScreenHash() const
+        {
+            uint64_t h = 14695981039346656037ull;
+            auto mix = [&h](const void* p, size_t n) {
+                const unsigned char* b = (const unsigned char*)p;
+                for (size_t i = 0; i < n; ++i)
+                    h = (h ^ b[i]) * 1099511628211ull;
+            };
+            if (m_screen)
+                mix(m_screen, kLines * kColumns * sizeof(uint32_t));
+            mix(&m_cursor, sizeof(m_cursor));
+            return h;
+        }
+
+        char NextReplayKey()
+        {
+            if (m_replayed == m_played)
+                Finish();
+            if (ScreenHash() != m_screens[m_replayed])
+                Mismatch("the screen differs after " + std::to_string(m_replayed) + " keys");
+            return m_keys[m_walked + m_replayed++];
+        }
+
+        //Times the calls, leaving the game restored to the first snapshot
+        void Measure()
+        {
+            std::vector<double> times(m_options.calls);
+            for (auto& t : times) {
+                auto start = std::chrono::steady_clock::now();
+                if ((*m_snapshot)(&m_scratch) != 0)
+                    throw_error("snapshot_game failed");
+                t = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            }
+            m_result.snapshot = Summarize(times);
+
+            for (auto& t : times) {
+                auto start = std::chrono::steady_clock::now();
+                if ((*m_restore)(&m_start) != 0)
+                    throw_error("restore_game failed");
+                t = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            }
+            m_result.restore = Summarize(times);
+            m_result.bytes = m_start.size;
+            m_result.finished = true;
+        }
+
+        void Finish()
+        {
+            if ((*m_snapshot)(&m_scratch) != 0)
+                Mismatch("the game wasn't waiting for a command after " + std::to_string(m_played) + " keys");
+            if (m_scratch.size != m_end.size || memcmp(m_scratch.data, m_end.data, m_end.size) != 0)
+                Mismatch("the game differs after " + std::to_string(m_played) + " keys");
+            throw Finished();
+        }
+
+        void Mismatch(const std::string& what)
+        {
+            m_result.mismatch = what;
+            throw Finished();
+        }
+
+        const Options& m_options;
+        std::minstd_rand m_random;
+        snapshot_game_fn m_snapshot = nullptr;
+        restore_game_fn m_restore = nullptr;
+        release_snapshot_fn m_release = nullptr;
+
+        Phase m_phase = kWalking;
+        std::vector<char> m_keys;
+        size_t m_walked = 0;         //keys before the first snapshot
+        size_t m_played = 0;         //keys between the two snapshots
+        size_t m_replayed = 0;
+        std::vector<uint64_t> m_screens;
+        uint32_t* m_screen = nullptr;
+        Coord m_cursor = { 0, 0 };
+
+        GameSnapshot m_start = {};
+        GameSnapshot m_end = {};
+        GameSnapshot m_scratch = {};
+        SeedResult m_result;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    Options o = ParseArgs(argc, argv);
+
+    int measured = 0, failed = 0;
+    double snapshot_total = 0, restore_total = 0;
+    try {
+        printf("seed\tbytes\tsnapshot_us\tsnapshot_p99_us\trestore_us\trestore_p99_us\treplay\n");
+        for (int seed = o.first; seed < o.first + o.count; ++seed) {
+            Bench bench(o, seed);
+            SeedResult r = bench.Run(seed);
+            if (!r.finished) {
+                printf("%d\t-\t-\t-\t-\t-\tthe game ended first\n", seed);
+                continue;
+            }
+            printf("%d\t%zu\t%.1f\t%.1f\t%.1f\t%.1f\t%s\n", seed, r.bytes, r.snapshot.median, r.snapshot.p99,
+                r.restore.median, r.restore.p99, r.mismatch.empty() ? "same" : r.mismatch.c_str());
+            ++measured;
+            snapshot_total += r.snapshot.median;
+            restore_total += r.restore.median;
+            if (!r.mismatch.empty())
+                ++failed;
+        }
+    }
+    catch (const std::runtime_error& e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    if (measured)
+        fprintf(stderr, "%d seeds: snapshot %.1fus, restore %.1fus (mean of medians), %d replays differed\n",
+            measured, snapshot_total / measured, restore_total / measured, failed);
+    return failed ? 1 : 0;
+}
+
+DisplayInterface::~DisplayInterface() {}
+InputInterface::~InputInterface() {}
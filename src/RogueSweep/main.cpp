@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <level_stats.h>
+#include "engine_library.h"
+
+//Generates levels straight from an engine's sweep_levels export across a
+//range of seeds and prints one tab separated row of statistics per level.
+//
+//Each engine keeps the whole game in globals, so every worker thread loads its
+//own copy of the engine library to get a private set of them.
+
+void throw_error(const std::string& msg)
+{
+    throw std::runtime_error(msg);
+}
+
+namespace
+{
+    const int kBatchSize = 1024;
+
+    const char* const kColumns[] = {
+        "seed", "depth", "rooms", "gone_rooms", "dark_rooms", "maze_rooms",
+        "doors", "secret_doors", "traps", "monsters",
+        "gold", "potions", "scrolls", "food", "weapons", "armor", "rings", "sticks", "amulets",
+        "stair_distance"
+    };
+    const int kNumColumns = sizeof(kColumns) / sizeof(kColumns[0]);
+
+    struct Options
+    {
+        std::string library;
+        int first = 1;
+        int count = 1000;
+        int depth = 1;
+        int threads = 0;
+        bool summary = false;
+    };
+
+    void Usage()
+    {
+        fprintf(stderr,
+            "usage: RogueSweep <engine library> [--first n] [--count n] [--depth n] [--threads n] [--summary]\n"
+            "  --first    first seed (default 1)\n"
+            "  --count    number of seeds (default 1000)\n"
+            "  --depth    dungeon level to generate (default 1)\n"
+            "  --threads  worker threads (default: one per core)\n"
+            "  --summary  print min/mean/max per column instead of one row per level\n");
+        exit(1);
+    }
+
+    Options ParseArgs(int argc, char** argv)
+    {
+        Options o;
+        for (int i = 1; i < argc; ++i) {
+            std::string s(argv[i]);
+            bool has_value = i + 1 < argc;
+            if (s == "--first" && has_value)
+                o.first = atoi(argv[++i]);
+            else if (s == "--count" && has_value)
+                o.count = atoi(argv[++i]);
+            else if (s == "--depth" && has_value)
+                o.depth = atoi(argv[++i]);
+            else if (s == "--threads" && has_value)
+                o.threads = atoi(argv[++i]);
+            else if (s == "--summary")
+                o.summary = true;
+            else if (s[0] != '-' && o.library.empty())
+                o.library = s;
+            else
+                Usage();
+        }
+        if (o.library.empty() || o.count <= 0 || o.depth <= 0)
+            Usage();
+        if (o.threads <= 0)
+            o.threads = std::max(1u, std::thread::hardware_concurrency());
+        o.threads = std::min(o.threads, (o.count + kBatchSize - 1) / kBatchSize);
+        return o;
+    }
+
+    void GetColumns(const LevelStats& s, int* values)
+    {
+        int* p = values;
+        *p++ = s.seed;
+        *p++ = s.depth;
+        *p++ = s.rooms;
+        *p++ = s.gone_rooms;
+        *p++ = s.dark_rooms;
+        *p++ = s.maze_rooms;
+        *p++ = s.doors;
+        *p++ = s.secret_doors;
+        *p++ = s.traps;
+        *p++ = s.monsters;
+        for (int i = 0; i < STAT_NUM_ITEMS; ++i)
+            *p++ = s.items[i];
+        *p++ = s.stair_distance;
+    }
+
+    void PrintRows(const std::vector<LevelStats>& stats)
+    {
+        std::string line;
+        for (int i = 0; i < kNumColumns; ++i) {
+            line += kColumns[i];
+            line += i + 1 < kNumColumns ? '\t' : '\n';
+        }
+        fputs(line.c_str(), stdout);
+
+        int values[kNumColumns];
+        char buf[16];
+        for (const auto& s : stats) {
+            GetColumns(s, values);
+            line.clear();
+            for (int i = 0; i < kNumColumns; ++i) {
+                sprintf(buf, "%d", values[i]);
+                line += buf;
+                line += i + 1 < kNumColumns ? '\t' : '\n';
+            }
+            fputs(line.c_str(), stdout);
+        }
+    }
+
+    void PrintSummary(const std::vector<LevelStats>& stats)
+    {
+        int values[kNumColumns];
+        int lo[kNumColumns], hi[kNumColumns];
+        double total[kNumColumns] = {};
+        int unreachable = 0;
+
+        for (size_t n = 0; n < stats.size(); ++n) {
+            GetColumns(stats[n], values);
+            for (int i = 0; i < kNumColumns; ++i) {
+                if (n == 0 || values[i] < lo[i])
+                    lo[i] = values[i];
+                if (n == 0 || values[i] > hi[i])
+                    hi[i] = values[i];
+                total[i] += values[i];
+            }
+            if (stats[n].stair_distance < 0)
+                ++unreachable;
+        }
+
+        printf("column\tmin\tmean\tmax\n");
+        for (int i = 2; i < kNumColumns; ++i)
+            printf("%s\t%d\t%.3f\t%d\n", kColumns[i], lo[i], total[i] / stats.size(), hi[i]);
+        printf("unreachable_stairs\t%d\n", unreachable);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options o = ParseArgs(argc, argv);
+    std::vector<LevelStats> stats(o.count);
+
+    try {
+        //an empty sweep gets each engine through its own setup, so the time
+        //it takes to start a game can be told apart from the levels
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::unique_ptr<EngineLibrary>> engines;
+        std::vector<sweep_levels_fn> sweeps;
+        for (int i = 0; i < o.threads; ++i) {
+            engines.emplace_back(new EngineLibrary(o.library));
+            sweeps.push_back((sweep_levels_fn)engines.back()->Get("sweep_levels"));
+            (*sweeps.back())(o.first, 0, o.depth, nullptr);
+        }
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        fprintf(stderr, "%d engines started in %.1fms (%.2fms each)\n", o.threads, elapsed, elapsed / o.threads);
+
+        start = std::chrono::steady_clock::now();
+        std::atomic<int> next(0);
+        std::vector<std::thread> workers;
+        for (int i = 0; i < o.threads; ++i) {
+            workers.emplace_back([&, i]() {
+                sweep_levels_fn sweep = sweeps[i];
+                int n;
+                while ((n = next.fetch_add(kBatchSize)) < o.count) {
+                    int batch = std::min(kBatchSize, o.count - n);
+                    (*sweep)(o.first + n, batch, o.depth, &stats[n]);
+                }
+            });
+        }
+        for (auto& t : workers)
+            t.join();
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        fprintf(stderr, "%d levels in %.2fs on %d threads (%.0f levels/s)\n",
+            o.count, elapsed, o.threads, o.count / std::max(elapsed, 1e-6));
+    }
+    catch (const std::runtime_error& e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    if (o.summary)
+        PrintSummary(stats);
+    else
+        PrintRows(stats);
+    return 0;
+}
@@ -15,6 +15,18 @@
 
 coord ch_ret;				/* Where chasing takes you */
 
+/*
+ * The exit of each room nearest to where a monster is headed.  Most
+ * monsters are after the hero, so an answer found for one is good for
+ * the rest of the turn.
+ */
+static struct exit_memo {
+    coord em_dest;			/* where the monster is headed */
+    int em_exit;			/* nearest exit, -1 if there are none */
+    int em_turn;			/* chase_turn the answer was found on */
+} exit_memo[MAXROOMS];
+static int chase_turn = 0;		/* bumped each time runners() starts */
+
 /*
  * runners:
  *	Make all the running monsters move.
@@ -26,6 +38,7 @@ runners()
     struct linked_list *item;
     struct thing *tp;
 
+    chase_turn++;
     for (item = mlist; item != NULL;)
     {
 	tp = (struct thing *) ldata(item);
@@ -43,6 +56,39 @@ runners()
     }
 }
 
+/*
+ * near_exit:
+ *	Run to the exit of a room nearest to dest, using this turn's
+ *	answer for the room if there is one
+ */
+
+static void
+near_exit(struct room *rp, coord *dest, coord *this)
+{
+    struct exit_memo *ep;
+    int mindist, i, dist;
+
+    ep = &exit_memo[rp - rooms];
+    if (ep->em_turn != chase_turn || !ce(ep->em_dest, *dest))
+    {
+	ep->em_turn = chase_turn;
+	ep->em_dest = *dest;
+	ep->em_exit = -1;
+	mindist = 32767;
+	for (i = 0; i < rp->r_nexits; i++)	/* loop through doors */
+	{
+	    dist = DISTANCE(dest->y, dest->x, rp->r_exit[i].y, rp->r_exit[i].x);
+	    if (dist < mindist)			/* minimize distance */
+	    {
+		ep->em_exit = i;
+		mindist = dist;
+	    }
+	}
+    }
+    if (ep->em_exit >= 0)
+	*this = rp->r_exit[ep->em_exit];
+}
+
 /*
  * do_chase:
  *	Make one thing chase another.
@@ -52,7 +98,6 @@ int
 do_chase(struct thing *th)
 {
     struct room *rer, *ree;	/* room of chaser, room of chasee */
-    int mindist = 32767, i, dist;
     int stoprun = FALSE;	/* TRUE means we are there */
     int sch;
     coord this;				/* Temporary destination for chaser */
@@ -62,7 +107,7 @@ do_chase(struct thing *th)
     /*
      * We don't count doors as inside rooms for this routine
      */
-    if (CMVWINCH(stdscr, th->t_pos.y, th->t_pos.x) == DOOR)
+    if (chat(th->t_pos.y, th->t_pos.x) == DOOR)
 	rer = NULL;
     this = *th->t_dest;
     /*
@@ -71,16 +116,7 @@ do_chase(struct thing *th)
      * door nearest to our goal.
      */
     if (rer != NULL && rer != ree)
-	for (i = 0; i < rer->r_nexits; i++)	/* loop through doors */
-	{
-	    dist = DISTANCE(th->t_dest->y, th->t_dest->x,
-			    rer->r_exit[i].y, rer->r_exit[i].x);
-	    if (dist < mindist)			/* minimize distance */
-	    {
-		this = rer->r_exit[i];
-		mindist = dist;
-	    }
-	}
+	near_exit(rer, th->t_dest, &this);
     /*
      * this now contains what we want to run to this time
      * so we run to it.  If we hit it we either want to fight it
@@ -108,9 +144,9 @@ do_chase(struct thing *th)
 
     if (cansee(unc(ch_ret)) && !on(*th, ISINVIS))
         mvwaddrawch(cw, ch_ret.y, ch_ret.x, th->t_type);
-    mvwaddrawch(mw, th->t_pos.y, th->t_pos.x, ' ');
-    mvwaddrawch(mw, ch_ret.y, ch_ret.x, th->t_type);
-    th->t_pos = ch_ret;
+    put_mch(th->t_pos.y, th->t_pos.x, ' ');
+    put_mch(ch_ret.y, ch_ret.x, th->t_type);
+    move_mons(th, &ch_ret);
     /*
      * And stop running if need be
      */
@@ -253,21 +289,13 @@ chase(struct thing *tp, coord *ee)
 struct room *
 roomin_rc(int r, int c)
 {
-    coord coord;
-    coord.x = c;
-    coord.y = r;
-    return roomin(&coord);
+    return places[r][c].p_room;
 }
 
 struct room *
 roomin(coord *cp)
 {
-    struct room *rp;
-
-    for (rp = rooms; rp <= &rooms[MAXROOMS-1]; rp++)
-	if (inroom(rp, cp))
-	    return rp;
-    return NULL;
+    return places[cp->y][cp->x].p_room;
 }
 
 /*
@@ -281,6 +309,8 @@ find_mons(int y, int x)
     struct linked_list *item;
     struct thing *th;
 
+    if (places[y][x].p_nmons < 2)
+	return places[y][x].p_mon;
     for (item = mlist; item != NULL; item = next(item))
     {
 	th = (struct thing *) ldata(item);
@@ -300,7 +330,7 @@ diag_ok(coord *sp, coord *ep)
 {
     if (ep->x == sp->x || ep->y == sp->y)
 	return TRUE;
-    return (step_ok(CMVINCH(ep->y, sp->x)) && step_ok(CMVINCH(sp->y, ep->x)));
+    return (step_ok(chat(ep->y, sp->x)) && step_ok(chat(sp->y, ep->x)));
 }
 
 /*
@@ -388,7 +388,7 @@ search()
 	    {
 		case SECRETDOOR:
 		    if (rnd(100) < 20) {
-			mvaddrawch(y, x, DOOR);
+			put_ch(y, x, DOOR);
 			count = 0;
 		    }
 		    break;
@@ -635,8 +635,9 @@ bounce(struct object *weap, char *mname)
 void
 remove_monster(coord *mp, struct linked_list *item)
 {
-    mvwaddrawch(mw, mp->y, mp->x, ' ');
+    put_mch(mp->y, mp->x, ' ');
     mvwaddrawch(cw, mp->y, mp->x, ((struct thing *) ldata(item))->t_oldch);
+    unplace_mons(THINGPTR(item));
     detach(mlist, item);
     discard(item);
 }
@@ -715,7 +716,7 @@ killed(struct linked_list *item, int pr)
 		if (save(VS_MAGIC))
 		    rp->r_goldval += GOLDCALC + GOLDCALC
 				   + GOLDCALC + GOLDCALC;
-		mvwaddrawch(stdscr, rp->r_gold.y, rp->r_gold.x, GOLD);
+		put_ch(rp->r_gold.y, rp->r_gold.x, GOLD);
 		if (!(rp->r_flags & ISDARK))
 		{
 		    light(&hero);
@@ -31,6 +31,7 @@ int lastscore = -1;
 
 struct thing player;
 struct room rooms[MAXROOMS];
+struct place places[MAXLINES][MAXCOLS];
 struct room *oldrp;
 struct stats max_stats; 
 struct object *cur_armor;
@@ -74,7 +74,7 @@ look(int wakeup)
 	{
 	    if (y <= 0 || y >= LINES - 1)
 		continue;
-	    if (ismons(CMVWINCH(mw, y, x)))
+	    if (ismons(mwat(y, x)))
 	    {
 		struct linked_list *it;
 		struct thing *tp;
@@ -84,7 +84,7 @@ look(int wakeup)
 		else
 		    it = find_mons(y, x);
 		tp = (struct thing *) ldata(it);
-		if ((tp->t_oldch = CMVINCH(y, x)) == TRAP)
+		if ((tp->t_oldch = chat(y, x)) == TRAP)
 		    tp->t_oldch =
 			(trap_at(y,x)->tr_flags&ISFOUND) ? TRAP : FLOOR;
 		if (tp->t_oldch == FLOOR && (rp != NULL) && (rp->r_flags & ISDARK)
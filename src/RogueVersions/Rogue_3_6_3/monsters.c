@@ -60,8 +60,9 @@ new_monster(struct linked_list *item, int type, coord *cp)
     tp = (struct thing *) ldata(item);
     tp->t_type = type;
     tp->t_pos = *cp;
+    place_mons(item);
     tp->t_oldch = CMVWINCH(cw, cp->y, cp->x);
-    mvwaddrawch(mw, cp->y, cp->x, tp->t_type);
+    put_mch(cp->y, cp->x, tp->t_type);
     mp = &monsters[tp->t_type-'A'];
     tp->t_stats.s_hpt = roll(mp->m_stats.s_lvl, 8);
     tp->t_stats.s_lvl = mp->m_stats.s_lvl;
@@ -118,7 +119,7 @@ wanderer()
 	if ((rp = &rooms[i]) == hr)
 	    continue;
 	rnd_pos(rp, &cp);
-	if ((ch = CMVWINCH(stdscr, cp.y, cp.x)) == ERR)
+	if ((ch = chat(cp.y, cp.x)) == ERR)
 	{
 	    debug("Routine wanderer: CMVWINCH failed to %d,%d", cp.y, cp.x);
 	    if (wizard)
@@ -135,6 +136,78 @@ wanderer()
 	msg("Started a wandering %s", monsters[tp->t_type-'A'].m_name);
 }
 
+/*
+ * put_mch:
+ *	Change the monster shown at a spot on the monster map
+ */
+
+void
+put_mch(int y, int x, int ch)
+{
+    mwat(y, x) = ch;
+    mvwaddrawch(mw, y, x, ch);
+}
+
+/*
+ * place_mons:
+ *	Note where a monster is, once its t_pos is set
+ */
+
+void
+place_mons(struct linked_list *item)
+{
+    struct thing *tp = THINGPTR(item);
+    struct place *pp = &places[tp->t_pos.y][tp->t_pos.x];
+
+    pp->p_mon = (pp->p_nmons++ == 0 ? item : NULL);
+}
+
+/*
+ * unplace_mons:
+ *	Forget where a monster is, before it moves or goes away
+ */
+
+void
+unplace_mons(struct thing *tp)
+{
+    struct place *pp = &places[tp->t_pos.y][tp->t_pos.x];
+    struct linked_list *item;
+    struct thing *th;
+
+    pp->p_mon = NULL;
+    if (--pp->p_nmons != 1)
+	return;
+    /*
+     * Two monsters can share a spot (wanderers don't look at mw), so
+     * find the one that is left
+     */
+    for (item = mlist; item != NULL; item = next(item))
+    {
+	th = THINGPTR(item);
+	if (th != tp && ce(th->t_pos, tp->t_pos))
+	    pp->p_mon = item;
+    }
+}
+
+/*
+ * move_mons:
+ *	Change where a monster is
+ */
+
+void
+move_mons(struct thing *tp, coord *cp)
+{
+    struct linked_list *item;
+
+    item = places[tp->t_pos.y][tp->t_pos.x].p_mon;
+    if (item == NULL)
+	for (item = mlist; THINGPTR(item) != tp; item = next(item))
+	    continue;
+    unplace_mons(tp);
+    tp->t_pos = *cp;
+    place_mons(item);
+}
+
 /*
  * what to do when the hero steps next to a monster
  */
@@ -186,7 +259,7 @@ wake_monster(int y, int x)
      * Hide invisible monsters
      */
     if (on(*tp, ISINVIS) && off(player, CANSEE))
-	ch = CMVWINCH(stdscr, y, x);
+	ch = chat(y, x);
     /*
      * Let greedy ones guard gold
      */
@@ -176,7 +176,7 @@ light(coord *cp)
 		    if (((struct thing *) ldata(item))->t_oldch == ' ')
 			if (!(rp->r_flags & ISDARK))
 			    ((struct thing *) ldata(item))->t_oldch =
-				CMVWINCH(stdscr, rp->r_pos.y+j, rp->r_pos.x+k);
+				chat(rp->r_pos.y+j, rp->r_pos.x+k);
 		}
 		if (rp->r_flags & ISDARK)
 		{
@@ -228,7 +228,7 @@ show(int y, int x)
 	 * Hide invisible monsters
 	 */
 	else if (off(player, CANSEE))
-	    ch = CMVWINCH(stdscr, y, x);
+	    ch = chat(y, x);
     }
     return ch;
 }
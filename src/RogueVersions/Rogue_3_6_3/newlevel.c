@@ -26,14 +26,14 @@ new_level()
     if (level > max_level)
 	max_level = level;
     wclear(cw);
-    wclear(mw);
-    clear();
+    clear_map();
     status();
     /*
      * Free up the monsters on the last level
      */
     free_list(mlist);
     do_rooms();				/* Draw rooms */
+    map_rooms();
     do_passages();			/* Draw passages */
     no_food++;
     put_things();			/* Place objects (if any) */
@@ -44,7 +44,7 @@ new_level()
         rm = rnd_room();
 	rnd_pos(&rooms[rm], &stairs);
     } until (winat(stairs.y, stairs.x) == FLOOR);
-    addrawch(STAIRS);
+    put_ch(stairs.y, stairs.x, STAIRS);
     /*
      * Place the traps
      */
@@ -70,7 +70,7 @@ new_level()
 		when 4: ch = TELTRAP;
 		when 5: ch = DARTTRAP;
 	    }
-	    addrawch(TRAP);
+	    put_ch(stairs.y, stairs.x, TRAP);
 	    traps[i].tr_type = ch;
 	    traps[i].tr_flags = 0;
 	    traps[i].tr_pos = stairs;
@@ -146,7 +146,7 @@ put_things()
 	        rm = rnd_room();
 		rnd_pos(&rooms[rm], &tp);
 	    } until (winat(tp.y, tp.x) == FLOOR);
-	    mvaddrawch(tp.y, tp.x, cur->o_type);
+	    put_ch(tp.y, tp.x, cur->o_type);
 	    cur->o_pos = tp;
 	}
     /*
@@ -170,7 +170,7 @@ put_things()
 	    rm = rnd_room();
 	    rnd_pos(&rooms[rm], &tp);
 	} until (winat(tp.y, tp.x) == FLOOR);
-	mvaddrawch(tp.y, tp.x, cur->o_type);
+	put_ch(tp.y, tp.x, cur->o_type);
 	cur->o_pos = tp;
     }
 }
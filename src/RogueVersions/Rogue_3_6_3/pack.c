@@ -58,7 +58,7 @@ add_pack(struct linked_list *item, int silent)
 		if (from_floor)
 		{
 		    detach(lvl_obj, item);
-		    mvaddrawch(hero.y, hero.x,
+		    put_ch(hero.y, hero.x,
 			(roomin(&hero) == NULL ? PASSAGE : FLOOR));
 		}
 		discard(item);
@@ -83,7 +83,7 @@ add_pack(struct linked_list *item, int silent)
 	{
 	    msg("The scroll turns to dust as you pick it up.");
 	    detach(lvl_obj, item);
-	    mvaddrawch(hero.y, hero.x, FLOOR);
+	    put_ch(hero.y, hero.x, FLOOR);
 	    return;
 	}
 	else
@@ -93,7 +93,7 @@ add_pack(struct linked_list *item, int silent)
     if (from_floor)
     {
 	detach(lvl_obj, item);
-	mvaddrawch(hero.y, hero.x, (roomin(&hero) == NULL ? PASSAGE : FLOOR));
+	put_ch(hero.y, hero.x, (roomin(&hero) == NULL ? PASSAGE : FLOOR));
     }
     /*
      * Search for an object of the same type
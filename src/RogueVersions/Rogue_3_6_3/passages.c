@@ -214,14 +214,12 @@ conn(int r1, int r2)
     if (!(rpf->r_flags & ISGONE)) door(rpf, &spos);
     else
     {
-	cmov(spos);
-	addrawch(PASSAGE);
+	put_ch(spos.y, spos.x, PASSAGE);
     }
     if (!(rpt->r_flags & ISGONE)) door(rpt, &epos);
     else
     {
-	cmov(epos);
-	addrawch(PASSAGE);
+	put_ch(epos.y, epos.x, PASSAGE);
     }
     /*
      * Get ready to move...
@@ -241,16 +239,14 @@ conn(int r1, int r2)
 	if (distance == turn_spot && turn_distance > 0)
 	    while(turn_distance--)
 	    {
-		cmov(curr);
-		addrawch(PASSAGE);
+		put_ch(curr.y, curr.x, PASSAGE);
 		curr.x += turn_delta.x;
 		curr.y += turn_delta.y;
 	    }
 	/*
 	 * Continue digging along
 	 */
-	cmov(curr);
-	addrawch(PASSAGE);
+	put_ch(curr.y, curr.x, PASSAGE);
 	distance--;
     }
     curr.x += pdelta.x;
@@ -267,8 +263,7 @@ conn(int r1, int r2)
 void
 door(struct room *rm, coord *cp)
 {
-    cmov(*cp);
-    addrawch( (rnd(10) < level - 1 && rnd(100) < 20 ? SECRETDOOR : DOOR) );
+    put_ch(cp->y, cp->x, (rnd(10) < level - 1 && rnd(100) < 20 ? SECRETDOOR : DOOR) );
     rm->r_exit[rm->r_nexits++] = *cp;
 }
 
@@ -284,6 +279,6 @@ add_pass()
 
     for (y = 1; y < LINES - 2; y++)
 	for (x = 0; x < COLS; x++)
-	    if ((ch=CMVINCH(y, x)) == PASSAGE || ch == DOOR || ch == SECRETDOOR)
+	    if ((ch=chat(y, x)) == PASSAGE || ch == DOOR || ch == SECRETDOOR)
 		mvwaddrawch(cw, y, x, ch);
 }
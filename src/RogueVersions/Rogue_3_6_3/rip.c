@@ -137,6 +137,10 @@ score(int amount, int flags, int monst)
     char scoreline[100];
     int rogue_ver = 0, scorefile_ver = 0;
 
+#ifdef ROGUE_COLLECTION
+    note_game_end(amount, flags, monst);
+#endif
+
     /*
      * Open file and read list
      */
@@ -17,6 +17,8 @@
  */
 #define MAXROOMS 9
 #define MAXTHINGS 9
+#define MAXLINES 32	/* Most lines of the screen the level can use */
+#define MAXCOLS 80	/* Most columns of the screen the level can use */
 #define MAXOBJ 9
 #define MAXPACK 23
 #define MAXTRAPS 10
@@ -41,9 +43,18 @@
 #define inroom(rp, cp) (\
     (cp)->x <= (rp)->r_pos.x + ((rp)->r_max.x - 1) && (rp)->r_pos.x <= (cp)->x \
  && (cp)->y <= (rp)->r_pos.y + ((rp)->r_max.y - 1) && (rp)->r_pos.y <= (cp)->y)
-#define winat(y, x) (CMVWINCH(mw,y,x)==' '?CMVWINCH(stdscr,y,x):CCHAR(winch(mw)))
+#define chat(y, x) (places[y][x].p_ch)
+#define mwat(y, x) (places[y][x].p_mch)
+#define winat(y, x) (mwat(y,x)==' '?chat(y,x):mwat(y,x))
 #define debug if (wizard) msg
+#ifdef ROGUE_COLLECTION
+/* every draw is counted, so two builds can be checked against each other */
+extern unsigned int rnd_draws;
+void note_game_end(int amount, int flags, int monst);
+#define RN (rnd_draws++, ((seed = seed*11109+13849) & 0x7fff) >> 1)
+#else
 #define RN (((seed = seed*11109+13849) & 0x7fff) >> 1)
+#endif
 #define unc(cp) (cp).y, (cp).x
 #define cmov(xy) move((xy).y, (xy).x)
 #define DISTANCE(y1, x1, y2, x2) ((x2 - x1)*(x2 - x1) + (y2 - y1)*(y2 - y1))
@@ -321,6 +332,18 @@ struct linked_list {
     char *l_data;			/* Various structure pointers */
 };
 
+/*
+ * One spot on the level.  stdscr and mw only mirror p_ch and p_mch,
+ * for show_win() and save files.
+ */
+struct place {
+    unsigned char p_ch;			/* What the level has there */
+    unsigned char p_mch;		/* Monster shown there, or ' ' */
+    int p_nmons;			/* Monsters whose t_pos is here */
+    struct linked_list *p_mon;		/* The monster, if there's only one */
+    struct room *p_room;		/* What roomin() returns */
+};
+
 /*
  * Stuff about magic items
  */
@@ -484,6 +507,7 @@ extern char *                p_colors[MAXPOTIONS];	/* Colors of the potions */
 extern char *                p_guess[MAXPOTIONS];	/* Players guess at what potion is */
 extern int                   p_know[MAXPOTIONS];	/* Does he know what a potion does */
 extern struct magic_item     p_magic[MAXPOTIONS];	/* Names and chances for potions */
+extern struct place          places[MAXLINES][MAXCOLS];	/* The level, monsters and all */
 extern struct thing          player;			/* The rogue */
 extern int                   playing;			/* True until he quits */
 extern unsigned char         prbuf[80];			/* Buffer for sprintfs */
@@ -546,6 +570,7 @@ void                    check_level(void);
 void                    checkout(int p);
 void                    chg_str(int amt);
 void                    chmsg(char *fmt, ...);
+void                    clear_map(void);
 void                    command(void);
 void                    conn(int r1, int r2);
 void                    create_obj(void);
@@ -596,7 +621,7 @@ int                     gethand(void);
 void                    help(void);
 void                    hit(char *er, char *ee);
 int                     hit_monster(int y, int x, struct object *obj);
-void                    horiz(int cnt);
+void                    horiz(int y, int x, int cnt, int is_top);
 void                    identify(void);
 void                    init_colors(void);
 void                    init_materials(void);
@@ -615,7 +640,9 @@ char *                  killname(int monst);
 void                    lengthen(void (*func)(), int xtime);
 void                    light(coord *cp);
 void                    look(int wakeup);
+void                    map_rooms(void);
 void                    miss(char *er, char *ee);
+void                    move_mons(struct thing *tp, coord *cp);
 void                    missile(int ydelta, int xdelta);
 void                    money(void);
 void                    msg(char *fmt, ...);
@@ -632,12 +659,16 @@ void                    parse_opts(char *str);
 int                     passwd(void);
 int                     pick_one(struct magic_item *magic, int nitems);
 void                    pick_up(int ch);
+void                    place_mons(struct linked_list *item);
 void                    picky_inven(void);
 void                    playit(void);
 void                    put_bool(void *b);
+void                    put_ch(int y, int x, int ch);
+void                    put_mch(int y, int x, int ch);
 void                    put_str(void *str);
 void                    put_things(void);
 int                     readchar(WINDOW *win);
+void                    reload_map(void);
 int                     restore(char *file, char **envp);
 int                     roll(int number, int sides);
 struct room *           roomin(coord *cp);
@@ -646,6 +677,7 @@ void                    strucpy(char *s1, char *s2, size_t len);
 void                    swander(void);
 void                    take_off(void);
 void                    tstp(int p);
+void                    unplace_mons(struct thing *tp);
 void                    quaff(void);
 void                    quit(int p);
 void                    raise_level(void);
@@ -692,7 +724,7 @@ void                    thunk(struct object *weap, char *mname);
 void                    u_level(void);
 void                    unconfuse(void);
 void                    unsee(void);
-void                    vert(int cnt);
+void                    vert(int y, int x, int cnt);
 char *                  vowelstr(char *str);
 void                    wait_for(WINDOW *win, int ch);
 struct linked_list *    wake_monster(int y, int x);
@@ -86,7 +86,7 @@ do_rooms()
 	{
 	    rp->r_goldval = GOLDCALC;
 	    rnd_pos(rp, &rp->r_gold);
-	    if (roomin(&rp->r_gold) != rp)
+	    if (!inroom(rp, &rp->r_gold))
 		endwin(), abort();
 	}
 	draw_room(rp);
@@ -100,7 +100,7 @@ do_rooms()
 	    do
 	    {
 		rnd_pos(rp, &mp);
-	    } until(CMVWINCH(stdscr, mp.y, mp.x) == FLOOR);
+	    } until(chat(mp.y, mp.x) == FLOOR);
 	    new_monster(item, randmonster(FALSE), &mp);
 	    /*
 	     * See if we want to give it a treasure to carry around.
@@ -120,27 +120,21 @@ draw_room(struct room *rp)
 {
     int j, k;
 
-    move(rp->r_pos.y, rp->r_pos.x+1);
-    vert(rp->r_max.y-2);				/* Draw left side */
-    move(rp->r_pos.y+rp->r_max.y-1, rp->r_pos.x);
-    horiz(rp->r_max.x, 0);					/* Draw bottom */
-    move(rp->r_pos.y, rp->r_pos.x);
-    horiz(rp->r_max.x, 1);					/* Draw top */
-    vert(rp->r_max.y-2);				/* Draw right side */
+    vert(rp->r_pos.y, rp->r_pos.x, rp->r_max.y-2);	/* Draw left side */
+    horiz(rp->r_pos.y+rp->r_max.y-1, rp->r_pos.x, rp->r_max.x, 0);	/* Draw bottom */
+    horiz(rp->r_pos.y, rp->r_pos.x, rp->r_max.x, 1);	/* Draw top */
+    vert(rp->r_pos.y, rp->r_pos.x+rp->r_max.x-1, rp->r_max.y-2);	/* Draw right side */
     /*
      * Put the floor down
      */
     for (j = 1; j < rp->r_max.y-1; j++)
-    {
-	move(rp->r_pos.y + j, rp->r_pos.x+1);
 	for (k = 1; k < rp->r_max.x-1; k++)
-	    addrawch(FLOOR);
-    }
+	    put_ch(rp->r_pos.y + j, rp->r_pos.x + k, FLOOR);
     /*
      * Put the gold there
      */
     if (rp->r_goldval)
-	mvaddrawch(rp->r_gold.y, rp->r_gold.x, GOLD);
+	put_ch(rp->r_gold.y, rp->r_gold.x, GOLD);
 }
 
 /*
@@ -149,31 +143,25 @@ draw_room(struct room *rp)
  */
 
 void
-horiz(int cnt, int is_top)
+horiz(int y, int x, int cnt, int is_top)
 {
-    addrawch(is_top ? ULWALL : LLWALL);
+    put_ch(y, x++, is_top ? ULWALL : LLWALL);
     --cnt;
     while (cnt-- > 1)
-	    addrawch(HWALL);
-    addrawch(is_top ? URWALL : LRWALL);
+	    put_ch(y, x++, HWALL);
+    put_ch(y, x, is_top ? URWALL : LRWALL);
 }
 
 /*
  * vert:
- *	draw a vertical line
+ *	draw a vertical line below the given spot
  */
 
 void
-vert(int cnt)
+vert(int y, int x, int cnt)
 {
-    int x, y;
-
-    getyx(stdscr, y, x);
-    x--;
-    while (cnt--) {
-	move(++y, x);
-	addrawch(VWALL);
-    }
+    while (cnt--)
+	put_ch(++y, x, VWALL);
 }
 
 /*
@@ -187,3 +175,93 @@ rnd_pos(struct room *rp, coord *cp)
     cp->x = rp->r_pos.x + rnd(rp->r_max.x-2) + 1;
     cp->y = rp->r_pos.y + rnd(rp->r_max.y-2) + 1;
 }
+
+/*
+ * put_ch:
+ *	Change what the level has at a spot
+ */
+
+void
+put_ch(int y, int x, int ch)
+{
+    chat(y, x) = ch;
+    mvaddrawch(y, x, ch);
+}
+
+/*
+ * clear_map:
+ *	Empty the level for a new one to be drawn
+ */
+
+void
+clear_map()
+{
+    struct place *pp;
+
+    for (pp = &places[0][0]; pp < &places[MAXLINES][0]; pp++)
+    {
+	pp->p_ch = pp->p_mch = ' ';
+	pp->p_mon = NULL;
+	pp->p_room = NULL;
+    }
+    wclear(mw);
+    clear();
+}
+
+/*
+ * map_rooms:
+ *	Note which room each spot is in, once the rooms have all been
+ *	placed.  Where rooms overlap the first one wins, as it always has.
+ */
+
+void
+map_rooms()
+{
+    struct room *rp;
+    coord c;
+
+    for (c.y = 0; c.y < MAXLINES; c.y++)
+	for (c.x = 0; c.x < MAXCOLS; c.x++)
+	{
+	    places[c.y][c.x].p_room = NULL;
+	    for (rp = rooms; rp <= &rooms[MAXROOMS-1]; rp++)
+		if (inroom(rp, &c))
+		{
+		    places[c.y][c.x].p_room = rp;
+		    break;
+		}
+	}
+}
+
+/*
+ * reload_map:
+ *	Fill the level back in from a restored stdscr and mw
+ */
+
+void
+reload_map()
+{
+    struct linked_list *item;
+    struct thing *tp;
+    int y, x;
+
+    for (y = 0; y < MAXLINES; y++)
+	for (x = 0; x < MAXCOLS; x++)
+	{
+	    if (y < LINES && x < COLS)
+	    {
+		places[y][x].p_ch = CMVWINCH(stdscr, y, x);
+		places[y][x].p_mch = CMVWINCH(mw, y, x);
+	    }
+	    else
+		places[y][x].p_ch = places[y][x].p_mch = ' ';
+	    places[y][x].p_mon = NULL;
+	}
+    for (item = mlist; item != NULL; item = next(item))
+    {
+	tp = THINGPTR(item);
+	if (places[tp->t_pos.y][tp->t_pos.x].p_mon == NULL)
+	    places[tp->t_pos.y][tp->t_pos.x].p_mon = item;
+    }
+    map_rooms();
+}
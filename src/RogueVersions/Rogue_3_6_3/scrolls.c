@@ -89,7 +89,7 @@ read_scroll()
 
 		for (x = hero.x-2; x <= hero.x+2; x++)
 		    for (y = hero.y-2; y <= hero.y+2; y++)
-			if (y > 0 && x > 0 && ismons(CMVWINCH(mw, y, x)))
+			if (y > 0 && x > 0 && ismons(mwat(y, x)))
 			    if ((mon = find_mons(y, x)) != NULL)
 			    {
 				struct thing *th;
@@ -172,7 +172,7 @@ read_scroll()
 		    {
 			case SECRETDOOR:
                             nch = DOOR;
-			    mvaddrawch(i, j, nch);
+			    put_ch(i, j, nch);
 			case HWALL:
 			case VWALL:
 			PC_GFX_WALL_CASES
@@ -180,7 +180,7 @@ read_scroll()
 			case PASSAGE:
 			case ' ':
 			case STAIRS:
-			    if (CMVWINCH(mw, i, j) != ' ')
+			    if (mwat(i, j) != ' ')
 			    {
 				struct thing *it;
 
@@ -215,7 +215,7 @@ read_scroll()
 		{
 		    gtotal += rooms[i].r_goldval;
 		    if (rooms[i].r_goldval != 0 &&
-			CMVWINCH(stdscr, rooms[i].r_gold.y, rooms[i].r_gold.x)
+			chat(rooms[i].r_gold.y, rooms[i].r_gold.x)
 			== GOLD)
 			mvwaddrawch(hw,rooms[i].r_gold.y,rooms[i].r_gold.x,GOLD);
 		}
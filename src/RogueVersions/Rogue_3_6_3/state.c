@@ -1382,6 +1382,7 @@ rs_restore_file(FILE *savef)
     rs_read_chars(savef, lvl_mons, sizeof(lvl_mons));     /* monsters.c   */
     rs_read_chars(savef, wand_mons, sizeof(wand_mons));	/* monsters.c   */
     rs_fix_monsters(monsters);    
+    reload_map();
 
     return( encclearerr() );
 }
@@ -112,6 +112,7 @@ do_zap(int gotdir)
 	    int monster;
 	    int oldch;
 	    int rm;
+	    coord to;
 
 	    y = hero.y;
 	    x = hero.x;
@@ -120,7 +121,7 @@ do_zap(int gotdir)
 		y += delta.y;
 		x += delta.x;
 	    }
-	    if (ismons(monster = CMVWINCH(mw, y, x)))
+	    if (ismons(monster = mwat(y, x)))
 	    {
 		int omonst = monster;
 
@@ -130,6 +131,7 @@ do_zap(int gotdir)
 		tp = (struct thing *) ldata(item);
 		if (obj->o_which == WS_POLYMORPH)
 		{
+		    unplace_mons(tp);
 		    detach(mlist, item);
 		    oldch = tp->t_oldch;
 		    delta.y = y;
@@ -154,20 +156,21 @@ do_zap(int gotdir)
 			do
 			{
 			    rm = rnd_room();
-			    rnd_pos(&rooms[rm], &tp->t_pos);
-			} until(winat(tp->t_pos.y, tp->t_pos.x) == FLOOR);
+			    rnd_pos(&rooms[rm], &to);
+			} until(winat(to.y, to.x) == FLOOR);
 		    }
 		    else
 		    {
-			tp->t_pos.y = hero.y + delta.y;
-			tp->t_pos.x = hero.x + delta.x;
+			to.y = hero.y + delta.y;
+			to.x = hero.x + delta.x;
 		    }
+		    move_mons(tp, &to);
 		    if (ismons(CMVWINCH(cw, y, x)))
 			mvwaddrawch(cw, y, x, tp->t_oldch);
 		    tp->t_dest = &hero;
 		    tp->t_flags |= ISRUN;
-		    mvwaddrawch(mw, y, x, ' ');
-		    mvwaddrawch(mw, tp->t_pos.y, tp->t_pos.x, monster);
+		    put_mch(y, x, ' ');
+		    put_mch(tp->t_pos.y, tp->t_pos.x, monster);
 		    if (tp->t_pos.y != y || tp->t_pos.x != x)
 			tp->t_oldch = CMVWINCH(cw, tp->t_pos.y, tp->t_pos.x);
 		}
@@ -181,7 +184,7 @@ do_zap(int gotdir)
 	    };
 
 	    do_motion(&bolt, delta.y, delta.x);
-	    if (ismons(CMVWINCH(mw, bolt.o_pos.y, bolt.o_pos.x))
+	    if (ismons(mwat(bolt.o_pos.y, bolt.o_pos.x))
 		&& !save_throw(VS_MAGIC, THINGPTR(find_mons(unc(bolt.o_pos)))))
 		    hit_monster(unc(bolt.o_pos), &bolt);
 	    else if (terse)
@@ -221,7 +224,7 @@ do_zap(int gotdir)
 		y += delta.y;
 		x += delta.x;
 	    }
-	    if (ismons(CMVWINCH(mw, y, x)))
+	    if (ismons(mwat(y, x)))
 	    {
 		item = find_mons(y, x);
 		tp = (struct thing *) ldata(item);
@@ -362,7 +365,7 @@ drain(int ymin, int ymax, int xmin, int xmax)
     cnt = 0;
     for (i = ymin; i <= ymax; i++)
 	for (j = xmin; j <= xmax; j++)
-	    if (ismons(CMVWINCH(mw, i, j)))
+	    if (ismons(mwat(i, j)))
 		cnt++;
     if (cnt == 0)
     {
@@ -376,7 +379,7 @@ drain(int ymin, int ymax, int xmin, int xmax)
      */
     for (i = ymin; i <= ymax; i++)
 	for (j = xmin; j <= xmax; j++)
-	    if (ismons(CMVWINCH(mw, i, j)) &&
+	    if (ismons(mwat(i, j)) &&
 	        ((item = find_mons(i, j)) != NULL))
 	    {
 		ick = (struct thing *) ldata(item);
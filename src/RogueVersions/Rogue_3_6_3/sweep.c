@@ -0,0 +1,189 @@
+/*
+ * Generate levels without playing them, for dungeon statistics
+ *
+ * Rogue: Exploring the Dungeons of Doom
+ * Copyright (C) 1980, 1981 Michael Toy, Ken Arnold and Glenn Wichman
+ * All rights reserved.
+ *
+ * See the file LICENSE.TXT for full copyright and licensing information.
+ */
+
+#include "curses.h"
+#include "rogue.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <level_stats.h>
+
+#ifdef ROGUE_COLLECTION
+
+static struct magic_item raw_things[NUMTHINGS], raw_s_magic[MAXSCROLLS],
+			 raw_p_magic[MAXPOTIONS], raw_r_magic[MAXRINGS],
+			 raw_ws_magic[MAXSTICKS];
+static char *walkable;
+
+/*
+ * sweep_init:
+ *	Do the parts of main() that only happen once
+ */
+
+static void
+sweep_init()
+{
+    static int initialized = FALSE;
+
+    if (initialized)
+	return;
+    initialized = TRUE;
+    init_game(NULL, NULL, 25, 80);
+    initscr();
+    cw = newwin(LINES, COLS, 0, 0);
+    mw = newwin(LINES, COLS, 0, 0);
+    hw = newwin(LINES, COLS, 0, 0);
+    walkable = _new(LINES * COLS);
+    /*
+     * the init routines add up the probabilities in place
+     */
+    memcpy(raw_things, things, sizeof raw_things);
+    memcpy(raw_s_magic, s_magic, sizeof raw_s_magic);
+    memcpy(raw_p_magic, p_magic, sizeof raw_p_magic);
+    memcpy(raw_r_magic, r_magic, sizeof raw_r_magic);
+    memcpy(raw_ws_magic, ws_magic, sizeof raw_ws_magic);
+}
+
+/*
+ * sweep_start:
+ *	Start a new game with the given seed the way main() does, so
+ *	the first level matches a game run with SEED set
+ */
+
+static void
+sweep_start(int s)
+{
+    struct linked_list *item;
+    int i;
+
+    /*
+     * new_level() leaves behind whatever the monsters were carrying
+     */
+    for (item = mlist; item != NULL; item = next(item))
+	free_list(((struct thing *) ldata(item))->t_pack);
+    for (i = 0; i < MAXSCROLLS; i++)
+    {
+	FREE(s_names[i]);
+	s_names[i] = NULL;
+    }
+    player.t_flags = 0;
+    extinguish(unconfuse);
+    memcpy(things, raw_things, sizeof raw_things);
+    memcpy(s_magic, raw_s_magic, sizeof raw_s_magic);
+    memcpy(p_magic, raw_p_magic, sizeof raw_p_magic);
+    memcpy(r_magic, raw_r_magic, sizeof raw_r_magic);
+    memcpy(ws_magic, raw_ws_magic, sizeof raw_ws_magic);
+    seed = s;
+    init_player();
+    init_things();
+    init_names();
+    init_colors();
+    init_stones();
+    init_materials();
+}
+
+/*
+ * sweep_count:
+ *	Summarize the level new_level() just made
+ */
+
+static void
+sweep_count(struct LevelStats *sp)
+{
+    struct room *rp;
+    struct linked_list *item;
+    int y, x, ch;
+    coord stairs;
+
+    for (rp = rooms; rp <= &rooms[MAXROOMS-1]; rp++)
+    {
+	if (rp->r_flags & ISGONE)
+	    sp->gone_rooms++;
+	else
+	{
+	    sp->rooms++;
+	    if (rp->r_flags & ISDARK)
+		sp->dark_rooms++;
+	}
+	/*
+	 * gold is kept with the room rather than on the object list
+	 */
+	if (rp->r_goldval)
+	    sp->items[STAT_GOLD]++;
+    }
+    for (item = mlist; item != NULL; item = next(item))
+	sp->monsters++;
+    for (item = lvl_obj; item != NULL; item = next(item))
+	switch (((struct object *) ldata(item))->o_type)
+	{
+	    case GOLD: sp->items[STAT_GOLD]++;
+	    when POTION: sp->items[STAT_POTION]++;
+	    when SCROLL: sp->items[STAT_SCROLL]++;
+	    when FOOD: sp->items[STAT_FOOD]++;
+	    when WEAPON: sp->items[STAT_WEAPON]++;
+	    when ARMOR: sp->items[STAT_ARMOR]++;
+	    when RING: sp->items[STAT_RING]++;
+	    when STICK: sp->items[STAT_STICK]++;
+	    when AMULET: sp->items[STAT_AMULET]++;
+	}
+    sp->traps = ntraps;
+
+    /*
+     * the level only exists on the screen, stairs and all
+     */
+    stairs = hero;
+    for (y = 0; y < LINES; y++)
+	for (x = 0; x < COLS; x++)
+	{
+	    ch = chat(y, x);
+	    if (ch == DOOR)
+		sp->doors++;
+	    else if (ch == SECRETDOOR)
+		sp->secret_doors++;
+	    else if (ch == STAIRS)
+	    {
+		stairs.y = y;
+		stairs.x = x;
+	    }
+	    walkable[y * COLS + x] = step_ok(ch);
+	}
+    level_stair_distance(walkable, LINES, COLS, hero.y, hero.x, stairs.y, stairs.x, sp);
+}
+
+/*
+ * sweep_levels:
+ *	Make count levels at the given depth, one per seed, and
+ *	record what is on each of them
+ */
+
+int
+sweep_levels(int first_seed, int count, int depth, struct LevelStats *stats)
+{
+    struct LevelStats *sp;
+
+    sweep_init();
+    for (sp = stats; sp < &stats[count]; sp++)
+    {
+	memset(sp, 0, sizeof *sp);
+	sp->seed = first_seed + (int) (sp - stats);
+	sp->depth = depth;
+	sweep_start(sp->seed);
+	level = max_level = depth;
+	no_food = 0;
+	ntraps = 0;
+	amulet = FALSE;
+	mpos = 0;
+	new_level();
+	sweep_count(sp);
+    }
+    return count;
+}
+
+#endif
@@ -156,8 +156,7 @@ money()
 	    }
 	    purse += rp->r_goldval;
 	    rp->r_goldval = 0;
-	    cmov(rp->r_gold);
-	    addrawch(FLOOR);
+	    put_ch(rp->r_gold.y, rp->r_gold.x, FLOOR);
 	    return;
 	}
     msg("That gold must have been counterfeit");
@@ -174,7 +173,7 @@ drop()
     struct linked_list *obj, *nobj;
     struct object *op;
 
-    ch = CMVWINCH(stdscr, hero.y, hero.x);
+    ch = chat(hero.y, hero.x);
     if (ch != FLOOR && ch != PASSAGE)
     {
 	msg("There is something there already");
@@ -206,7 +205,7 @@ drop()
      * Link it into the level object list
      */
     attach(lvl_obj, obj);
-    mvaddrawch(hero.y, hero.x, op->o_type);
+    put_ch(hero.y, hero.x, op->o_type);
     op->o_pos = hero;
     msg("Dropped %s", inv_name(op, TRUE));
 }
@@ -97,7 +97,7 @@ missile(int ydelta, int xdelta)
      * AHA! Here it has hit something.  If it is a wall or a door,
      * or if it misses (combat) the mosnter, put it on the floor
      */
-    if (!ismons(CMVWINCH(mw, obj->o_pos.y, obj->o_pos.x))
+    if (!ismons(mwat(obj->o_pos.y, obj->o_pos.x))
 	|| !hit_monster(unc(obj->o_pos), obj))
 	    fall(item, TRUE);
     mvwaddrawch(cw, hero.y, hero.x, PLAYER);
@@ -163,7 +163,7 @@ fall(struct linked_list *item, int pr)
     obj = (struct object *) ldata(item);
     if (fallpos(&obj->o_pos, &fpos, TRUE))
     {
-	mvaddrawch(fpos.y, fpos.x, obj->o_type);
+	put_ch(fpos.y, fpos.x, obj->o_type);
 	obj->o_pos = fpos;
 	if ((rp = roomin(&hero)) != NULL && !(rp->r_flags & ISDARK))
 	{
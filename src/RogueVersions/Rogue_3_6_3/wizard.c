@@ -160,7 +160,7 @@ teleport()
     coord c;
 
     c = hero;
-    mvwaddrawch(cw, hero.y, hero.x, CMVWINCH(stdscr, hero.y, hero.x));
+    mvwaddrawch(cw, hero.y, hero.x, chat(hero.y, hero.x));
     do
     {
 	rm = rnd_room();
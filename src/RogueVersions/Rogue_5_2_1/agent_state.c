@@ -0,0 +1,130 @@
+/*
+ * Describe the hero for a program playing the game
+ *
+ * Rogue: Exploring the Dungeons of Doom
+ * Copyright (C) 1980, 1981, 1982 Michael Toy, Ken Arnold and Glenn Wichman
+ * All rights reserved.
+ *
+ * See the file LICENSE.TXT for full copyright and licensing information.
+ */
+
+#include <curses.h>
+#include <string.h>
+#include <agent_state.h>
+#include "rogue.h"
+
+#ifdef ROGUE_COLLECTION
+
+unsigned int rnd_draws;			/* random numbers drawn so far */
+struct GameEnd game_end = { -1, 0, 0 };	/* how the game ended, once it has */
+
+/*
+ * agent_kind:
+ *	Which kind of object something is, as level statistics count them
+ */
+static
+agent_kind(type)
+int type;
+{
+    switch (type)
+    {
+	case GOLD: return STAT_GOLD;
+	case POTION: return STAT_POTION;
+	case SCROLL: return STAT_SCROLL;
+	case FOOD: return STAT_FOOD;
+	case WEAPON: return STAT_WEAPON;
+	case ARMOR: return STAT_ARMOR;
+	case RING: return STAT_RING;
+	case STICK: return STAT_STICK;
+	case AMULET: return STAT_AMULET;
+    }
+    return -1;
+}
+
+/*
+ * get_agent_state:
+ *	Fill in the hero's stats, depth and pack.  Only call this
+ *	while the game is waiting for a key.
+ */
+void
+get_agent_state(sp)
+register struct AgentState *sp;
+{
+    register THING *obj;
+    register struct AgentItem *ip;
+    register char ch;
+
+    memset(sp, 0, sizeof *sp);
+    sp->str = pstats.s_str;
+    sp->max_str = max_stats.s_str;
+    sp->exp = pstats.s_exp;
+    sp->level = pstats.s_lvl;
+    sp->ac = cur_armor != NULL ? cur_armor->o_ac : pstats.s_arm;
+    sp->hp = pstats.s_hpt;
+    sp->hp_max = max_hp;
+    strncpy(sp->damage, pstats.s_dmg, sizeof sp->damage - 1);
+    sp->depth = level;
+    sp->gold = purse;
+    ch = 'a';
+    for (obj = pack; obj != NULL && sp->item_count < AGENT_PACK_SIZE; obj = next(obj))
+    {
+	ip = &sp->items[sp->item_count++];
+	ip->letter = ch++;
+	ip->kind = agent_kind(obj->o_type);
+	ip->count = obj->o_count;
+	strncpy(ip->name, inv_name(obj, FALSE), sizeof ip->name - 1);
+    }
+}
+
+/*
+ * reseed_game:
+ *	Start the random numbers over from a new seed, so copies of
+ *	one game can each play out a different future
+ */
+void
+reseed_game(s)
+unsigned int s;
+{
+    seed = s;
+}
+
+/*
+ * get_random_draws:
+ *	How many random numbers the game has drawn since it started
+ */
+unsigned int
+get_random_draws()
+{
+    return rnd_draws;
+}
+
+/*
+ * note_game_end:
+ *	Remember how the game ended, from what score() was handed
+ */
+void
+note_game_end(amount, flags, monst)
+int amount, flags, monst;
+{
+    if (flags < 0)
+	return;
+    game_end.flags = flags;
+    game_end.monster = (flags == 0 || flags == 3) ? monst : 0;
+    game_end.score = amount;
+}
+
+/*
+ * get_game_end:
+ *	How the game ended, or 0 while it's still going
+ */
+int
+get_game_end(ep)
+struct GameEnd *ep;
+{
+    if (game_end.flags < 0)
+	return 0;
+    *ep = game_end;
+    return 1;
+}
+
+#endif
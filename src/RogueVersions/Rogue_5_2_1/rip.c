@@ -69,6 +69,9 @@ char monst;
     };
     void endit();
 
+#ifdef ROGUE_COLLECTION
+    note_game_end(amount, flags, monst);
+#endif
     start_score();
 
     for (scp = top_ten; scp <= &top_ten[9]; scp++)
@@ -242,6 +245,7 @@ char monst;
 	    signal(SIGINT, fp);
 	}
     }
+    encflush(outf);
     fclose(outf);
 }
 
@@ -166,6 +166,7 @@ register FILE *savef;
 	msg("");
     rs_save_file(savef);
 
+    encflush(savef);
     fclose(savef);
 }
 
@@ -293,6 +294,31 @@ char **envp;
     return 0;
 }
 
+/*
+ * The key starts over with each encwrite, which is what the save and
+ * score file formats expect, but the encrypted bytes are collected in
+ * encbuf and written a block at a time.
+ */
+static char encbuf[BUFSIZ];		/* encrypted, not yet written */
+static int enclen = 0;			/* bytes used in encbuf */
+static FILE *encfile = NULL;		/* file encbuf is going to */
+
+/*
+ * encflush:
+ *	Write out what encwrite has collected for a file.  This has to
+ *	be done before the file is closed.
+ */
+encflush(outf)
+register FILE *outf;
+{
+    if (outf != NULL && outf == encfile)
+    {
+	fwrite(encbuf, 1, enclen, outf);
+	enclen = 0;
+	encfile = NULL;
+    }
+}
+
 /*
  * encwrite:
  *	Perform an encrypted write
@@ -304,11 +330,22 @@ register FILE *outf;
 {
     register char *ep;
     register char *start = (char *) starta;
+
+    if (outf != encfile)
+    {
+	encflush(encfile);
+	encfile = outf;
+    }
     ep = encstr;
 
     while (size--)
     {
-	putc(*start++ ^ *ep++, outf);
+	if (enclen == sizeof encbuf)
+	{
+	    encflush(outf);
+	    encfile = outf;
+	}
+	encbuf[enclen++] = *start++ ^ *ep++;
 	if (*ep == '\0')
 	    ep = encstr;
     }
@@ -0,0 +1,184 @@
+/*
+ * Generate levels without playing them, for dungeon statistics
+ *
+ * Rogue: Exploring the Dungeons of Doom
+ * Copyright (C) 1980, 1981, 1982 Michael Toy, Ken Arnold and Glenn Wichman
+ * All rights reserved.
+ *
+ * See the file LICENSE.TXT for full copyright and licensing information.
+ */
+
+#include <stdlib.h>
+#include <curses.h>
+#include <string.h>
+#include <level_stats.h>
+#include "rogue.h"
+
+#ifdef ROGUE_COLLECTION
+
+static struct magic_item raw_things[NUMTHINGS], raw_s_magic[MAXSCROLLS],
+			 raw_p_magic[MAXPOTIONS], raw_r_magic[MAXRINGS],
+			 raw_ws_magic[MAXSTICKS];
+
+/*
+ * sweep_init:
+ *	Do the parts of main() that only happen once
+ */
+static
+sweep_init()
+{
+    static bool initialized = FALSE;
+
+    if (initialized)
+	return;
+    initialized = TRUE;
+    init_game(NULL, NULL, 25, 80);
+    initscr();
+    hw = newwin(LINES, COLS, 0, 0);
+    /*
+     * an umber hulk waking up in the first room can print a message,
+     * which looks around from the last room he was in
+     */
+    oldrp = &passages[0];
+    /*
+     * the init routines add up the probabilities in place
+     */
+    memcpy(raw_things, things, sizeof raw_things);
+    memcpy(raw_s_magic, s_magic, sizeof raw_s_magic);
+    memcpy(raw_p_magic, p_magic, sizeof raw_p_magic);
+    memcpy(raw_r_magic, r_magic, sizeof raw_r_magic);
+    memcpy(raw_ws_magic, ws_magic, sizeof raw_ws_magic);
+}
+
+/*
+ * sweep_start:
+ *	Start a new game with the given seed the way main() does, so
+ *	the first level matches a game run with SEED set
+ */
+static
+sweep_start(s)
+int s;
+{
+    register int i;
+
+    free_list(pack);
+    inpack = 0;
+    for (i = 0; i < MAXSCROLLS; i++)
+    {
+	free(s_names[i]);
+	s_names[i] = NULL;
+    }
+    player.t_flags = 0;
+    extinguish(unconfuse);
+    memcpy(things, raw_things, sizeof raw_things);
+    memcpy(s_magic, raw_s_magic, sizeof raw_s_magic);
+    memcpy(p_magic, raw_p_magic, sizeof raw_p_magic);
+    memcpy(r_magic, raw_r_magic, sizeof raw_r_magic);
+    memcpy(ws_magic, raw_ws_magic, sizeof raw_ws_magic);
+    seed = s;
+    init_player();
+    init_things();
+    init_names();
+    init_colors();
+    init_stones();
+    init_materials();
+}
+
+/*
+ * sweep_count:
+ *	Summarize the level new_level() just made
+ */
+static
+sweep_count(sp)
+register struct LevelStats *sp;
+{
+    static char walkable[MAXLINES * MAXCOLS];
+    register struct room *rp;
+    register THING *tp;
+    register int y, x, ch;
+    coord stairs;
+
+    for (rp = rooms; rp < &rooms[MAXROOMS]; rp++)
+    {
+	if (rp->r_flags & ISGONE)
+	    sp->gone_rooms++;
+	else
+	{
+	    sp->rooms++;
+	    if (rp->r_flags & ISDARK)
+		sp->dark_rooms++;
+	}
+    }
+    for (tp = mlist; tp != NULL; tp = next(tp))
+	sp->monsters++;
+    for (tp = lvl_obj; tp != NULL; tp = next(tp))
+	switch (tp->o_type)
+	{
+	    case GOLD: sp->items[STAT_GOLD]++;
+	    when POTION: sp->items[STAT_POTION]++;
+	    when SCROLL: sp->items[STAT_SCROLL]++;
+	    when FOOD: sp->items[STAT_FOOD]++;
+	    when WEAPON: sp->items[STAT_WEAPON]++;
+	    when ARMOR: sp->items[STAT_ARMOR]++;
+	    when RING: sp->items[STAT_RING]++;
+	    when STICK: sp->items[STAT_STICK]++;
+	    when AMULET: sp->items[STAT_AMULET]++;
+	}
+    sp->traps = ntraps;
+
+    /*
+     * new_level() doesn't keep where it put the stairs
+     */
+    stairs = hero;
+    for (y = 0; y < LINES; y++)
+	for (x = 0; x < COLS; x++)
+	{
+	    ch = chat(y, x);
+	    if (ch == DOOR)
+		sp->doors++;
+	    else if ((ch == VWALL || ch == HWALL) && !(flat(y, x) & F_REAL))
+		sp->secret_doors++;
+	    else if (ch == STAIRS)
+	    {
+		stairs.y = y;
+		stairs.x = x;
+	    }
+	    /*
+	     * hidden passages are left blank and secret doors look like
+	     * walls, so neither is walkable until it is searched for
+	     */
+	    walkable[y * COLS + x] = step_ok(ch);
+	}
+    level_stair_distance(walkable, LINES, COLS, hero.y, hero.x, stairs.y, stairs.x, sp);
+}
+
+/*
+ * sweep_levels:
+ *	Make count levels at the given depth, one per seed, and
+ *	record what is on each of them
+ */
+sweep_levels(first_seed, count, depth, stats)
+int first_seed, count, depth;
+struct LevelStats *stats;
+{
+    register struct LevelStats *sp;
+
+    sweep_init();
+    for (sp = stats; sp < &stats[count]; sp++)
+    {
+	memset(sp, 0, sizeof *sp);
+	sp->seed = first_seed + (int) (sp - stats);
+	sp->depth = depth;
+	sweep_start(sp->seed);
+	level = max_level = depth;
+	no_food = 0;
+	ntraps = 0;
+	amulet = FALSE;
+	mpos = 0;
+	new_level();
+	sweep_count(sp);
+    }
+    return count;
+}
+
+#endif
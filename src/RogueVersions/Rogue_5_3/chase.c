@@ -11,6 +11,19 @@
 
 coord ch_ret;				/* Where chasing takes you */
 
+/*
+ * The exit of each room and passage nearest to where a monster is
+ * headed.  Most monsters are after the hero, so an answer found for one
+ * is good for the rest of the turn.
+ */
+static struct exit_memo {
+    coord em_dest;			/* where the monster is headed */
+    int em_exit;			/* nearest exit, -1 if there are none */
+    int em_dist;			/* distance from em_exit to em_dest */
+    int em_turn;			/* chase_turn the answer was found on */
+} exit_memo[MAXROOMS + MAXPASS];
+static int chase_turn = 0;		/* bumped each time runners() starts */
+
 /*
  * runners:
  *	Make all the running monsters move.
@@ -20,6 +33,7 @@ runners()
     register THING *tp;
     register THING *ntp;
 
+    chase_turn++;
     for (tp = mlist; tp != NULL; tp = ntp)
     {
 	ntp = next(tp);
@@ -36,6 +50,47 @@ runners()
     }
 }
 
+/*
+ * near_exit:
+ *	Run to the exit of a room nearest to dest if it is closer than
+ *	*mindist, using this turn's answer for the room if there is one
+ */
+static
+near_exit(rp, dest, this, mindist)
+register struct room *rp;
+register coord *dest, *this;
+register int *mindist;
+{
+    register struct exit_memo *ep;
+    register int i, dist;
+
+    if (rp >= rooms && rp < &rooms[MAXROOMS])
+	ep = &exit_memo[rp - rooms];
+    else
+	ep = &exit_memo[MAXROOMS + (rp - passages)];
+    if (ep->em_turn != chase_turn || !ce(ep->em_dest, *dest))
+    {
+	ep->em_turn = chase_turn;
+	ep->em_dest = *dest;
+	ep->em_exit = -1;
+	ep->em_dist = 32767;
+	for (i = 0; i < rp->r_nexits; i++)	/* loop through doors */
+	{
+	    dist = DISTANCE(dest->y, dest->x, rp->r_exit[i].y, rp->r_exit[i].x);
+	    if (dist < ep->em_dist)
+	    {
+		ep->em_exit = i;
+		ep->em_dist = dist;
+	    }
+	}
+    }
+    if (ep->em_exit >= 0 && ep->em_dist < *mindist)
+    {
+	*this = rp->r_exit[ep->em_exit];
+	*mindist = ep->em_dist;
+    }
+}
+
 /*
  * do_chase:
  *	Make one thing chase another.
@@ -45,7 +100,7 @@ do_chase(th)
 register THING *th;
 {
     register struct room *rer, *ree;	/* room of chaser, room of chasee */
-    register int mindist = 32767, i, dist;
+    int mindist = 32767;			/* distance to the exit we want */
     register bool stoprun = FALSE;	/* TRUE means we are there */
     register unsigned char sch;
     register bool door;
@@ -74,16 +129,7 @@ register THING *th;
 over:
     if (rer != ree)
     {
-	for (i = 0; i < rer->r_nexits; i++)	/* loop through doors */
-	{
-	    dist = DISTANCE(th->t_dest->y, th->t_dest->x,
-			    rer->r_exit[i].y, rer->r_exit[i].x);
-	    if (dist < mindist)
-	    {
-		this_p = rer->r_exit[i];
-		mindist = dist;
-	    }
-	}
+	near_exit(rer, th->t_dest, &this_p, &mindist);
 	if (door)
 	{
 	    rer = &passages[flat(th->t_pos.y, th->t_pos.x) & F_PNUM];
@@ -13,7 +13,14 @@
 #define MAXLINES	32	/* maximum number of screen lines used */
 #define MAXCOLS		80	/* maximum number of screen columns used */
 
+#ifdef ROGUE_COLLECTION
+/* every draw is counted, so two builds can be checked against each other */
+extern unsigned int rnd_draws;
+void	note_game_end();
+#define RN		(rnd_draws++, ((seed = seed*11109+13849) >> 16) & 0xffff)
+#else
 #define RN		(((seed = seed*11109+13849) >> 16) & 0xffff)
+#endif
 
 /*
  * Now all the global variables
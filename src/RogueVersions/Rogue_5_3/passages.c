@@ -115,6 +115,26 @@ do_passages()
     passnum();
 }
 
+/*
+ * maze_edge:
+ *	See if any of the len spots from (y, x) a door could go on
+ *	is part of the maze.  Small mazes in the top row sometimes
+ *	have none, and looking for one would never end.
+ */
+static
+maze_edge(y, x, dy, dx, len)
+register int y, x, dy, dx, len;
+{
+    while (len-- > 0)
+    {
+	if (chat(y, x) == PASSAGE)
+	    return TRUE;
+	y += dy;
+	x += dx;
+    }
+    return FALSE;
+}
+
 /*
  * conn:
  *	Draw a corridor from a room in a certain direction.
@@ -165,12 +185,14 @@ int r1, r2;
 	    {
 		spos.x = rpf->r_pos.x + rnd(rpf->r_max.x - 2) + 1;
 		spos.y = rpf->r_pos.y + rpf->r_max.y - 1;
-	    } while ((rpf->r_flags & ISMAZE) && chat(spos.y,spos.x) != PASSAGE);
+	    } while ((rpf->r_flags & ISMAZE) && chat(spos.y,spos.x) != PASSAGE
+		&& maze_edge(spos.y, rpf->r_pos.x + 1, 0, 1, rpf->r_max.x - 2));
 	if (!(rpt->r_flags & ISGONE))
 	    do
 	    {
 		epos.x = rpt->r_pos.x + rnd(rpt->r_max.x - 2) + 1;
-	    } while ((rpt->r_flags & ISMAZE) && chat(epos.y,epos.x) != PASSAGE);
+	    } while ((rpt->r_flags & ISMAZE) && chat(epos.y,epos.x) != PASSAGE
+		&& maze_edge(epos.y, rpt->r_pos.x + 1, 0, 1, rpt->r_max.x - 2));
 	distance = abs(spos.y - epos.y) - 1;	/* distance to move */
 	turn_delta.y = 0;			/* direction to turn */
 	turn_delta.x = (spos.x < epos.x ? 1 : -1);
@@ -191,12 +213,14 @@ int r1, r2;
 	    {
 		spos.x = rpf->r_pos.x + rpf->r_max.x - 1;
 		spos.y = rpf->r_pos.y + rnd(rpf->r_max.y - 2) + 1;
-	    } while ((rpf->r_flags & ISMAZE) && chat(spos.y,spos.x) != PASSAGE);
+	    } while ((rpf->r_flags & ISMAZE) && chat(spos.y,spos.x) != PASSAGE
+		&& maze_edge(rpf->r_pos.y + 1, spos.x, 1, 0, rpf->r_max.y - 2));
 	if (!(rpt->r_flags & ISGONE))
 	    do
 	    {
 		epos.y = rpt->r_pos.y + rnd(rpt->r_max.y - 2) + 1;
-	    } while ((rpt->r_flags & ISMAZE) && chat(epos.y,epos.x) != PASSAGE);
+	    } while ((rpt->r_flags & ISMAZE) && chat(epos.y,epos.x) != PASSAGE
+		&& maze_edge(rpt->r_pos.y + 1, epos.x, 1, 0, rpt->r_max.y - 2));
 	distance = abs(spos.x - epos.x) - 1;
 	turn_delta.y = (spos.y < epos.y ? 1 : -1);
 	turn_delta.x = 0;
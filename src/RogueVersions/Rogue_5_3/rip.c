@@ -57,6 +57,9 @@ char monst;
     };
     int	endit();
 
+#ifdef ROGUE_COLLECTION
+    note_game_end(amount, flags, monst);
+#endif
     start_score();
 
     if (flags != -1)
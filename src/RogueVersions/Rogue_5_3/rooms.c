@@ -204,8 +204,8 @@ register struct room *rp;
 {
 	register int	starty, startx;
 
-	for (starty = 0; starty < MAXCOLS/3; starty++)
-		for (startx = 0; startx < MAXLINES/3; startx++)
+	for (starty = 0; starty <= MAXCOLS/3; starty++)
+		for (startx = 0; startx <= MAXLINES/3; startx++)
 			Maze[starty][startx].used = Maze[starty][startx].nexits = 0;
 
 	Maxy = rp->r_max.y;
@@ -294,16 +294,11 @@ register char *start;
 unsigned int size;
 register FILE *outf;
 {
-    register char *ep;
-
-    ep = encstr;
-
-    while (size--)
-    {
-	putc(*start++/* ^ *ep++*/, outf);
-	if (*ep == '\0')
-	    ep = encstr;
-    }
+    /*
+     * the encryption is switched off, so the bytes go out as they are
+     * in one block
+     */
+    fwrite(start, 1, size, outf);
 }
 
 /*
@@ -315,19 +310,8 @@ register char *start;
 unsigned int size;
 register int inf;
 {
-    register char *ep;
-    register int read_size;
-
-    if ((read_size = read(inf, start, size)) == -1 || read_size == 0)
-	return read_size;
-
-    ep = encstr;
-
-    while (size--)
-    {
-	*start++;// ^= *ep++;
-	if (*ep == '\0')
-	    ep = encstr;
-    }
-    return read_size;
+    /*
+     * nothing to decrypt, as encwrite doesn't encrypt
+     */
+    return read(inf, start, size);
 }
@@ -18,6 +18,19 @@
 
 static coord ch_ret;				/* Where chasing takes you */
 
+/*
+ * The exit of each room and passage nearest to where a monster is
+ * headed.  Most monsters are after the hero, so an answer found for one
+ * is good for the rest of the turn.
+ */
+static struct exit_memo {
+    coord em_dest;			/* where the monster is headed */
+    coord *em_exit;			/* nearest exit, NULL if there are none */
+    int em_dist;			/* distance from em_exit to em_dest */
+    int em_turn;			/* chase_turn the answer was found on */
+} exit_memo[MAXROOMS + MAXPASS];
+static int chase_turn = 0;		/* bumped each time runners() starts */
+
 /*
  * runners:
  *	Make all the running monsters move.
@@ -30,6 +43,7 @@ runners(void)
     int wastarget;
     coord orig_pos;
 
+    chase_turn++;
     for (tp = mlist; tp != NULL; tp = next)
     {
         /* remember this in case the monster's "next" is changed */
@@ -110,6 +124,45 @@ relocate(THING *th, const coord *new_loc)
     }
 }
 
+/*
+ * near_exit:
+ *	Run to the exit of a room nearest to dest if it is closer than
+ *	*mindist, using this turn's answer for the room if there is one
+ */
+static void
+near_exit(struct room *rp, const coord *dest, coord *this, int *mindist)
+{
+    struct exit_memo *ep;
+    coord *cp;
+    int curdist;
+
+    if (rp >= rooms && rp < &rooms[MAXROOMS])
+	ep = &exit_memo[rp - rooms];
+    else
+	ep = &exit_memo[MAXROOMS + (rp - passages)];
+    if (ep->em_turn != chase_turn || !ce(ep->em_dest, *dest))
+    {
+	ep->em_turn = chase_turn;
+	ep->em_dest = *dest;
+	ep->em_exit = NULL;
+	ep->em_dist = 32767;
+	for (cp = rp->r_exit; cp < &rp->r_exit[rp->r_nexits]; cp++)
+	{
+	    curdist = dist_cp(dest, cp);
+	    if (curdist < ep->em_dist)
+	    {
+		ep->em_exit = cp;
+		ep->em_dist = curdist;
+	    }
+	}
+    }
+    if (ep->em_exit != NULL && ep->em_dist < *mindist)
+    {
+	*this = *ep->em_exit;
+	*mindist = ep->em_dist;
+    }
+}
+
 /*
  * do_chase:
  *	Make one thing chase another.
@@ -117,9 +170,8 @@ relocate(THING *th, const coord *new_loc)
 int
 do_chase(THING *th)
 {
-    coord *cp;
     struct room *rer, *ree;	/* room of chaser, room of chasee */
-    int mindist = 32767, curdist;
+    int mindist = 32767;
     int stoprun = FALSE;	/* TRUE means we are there */
     int door;
     THING *obj;
@@ -146,15 +198,7 @@ do_chase(THING *th)
 over:
     if (rer != ree)
     {
-	for (cp = rer->r_exit; cp < &rer->r_exit[rer->r_nexits]; cp++)
-	{
-	    curdist = dist_cp(th->t_dest, cp);
-	    if (curdist < mindist)
-	    {
-		this = *cp;
-		mindist = curdist;
-	    }
-	}
+	near_exit(rer, th->t_dest, &this, &mindist);
 	if (door)
 	{
 	    rer = &passages[flat(th->t_pos.y, th->t_pos.x) & F_PNUM];
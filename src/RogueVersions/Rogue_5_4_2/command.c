@@ -24,11 +24,11 @@ void
 command(void)
 {
     int ch;
-    int ntimes = 1;			/* Number of player moves */
     int *fp;
     THING *mp;
     static int countch, direction, newcount = FALSE;
 
+    ntimes = 1;
     if (on(player, ISHASTE))
 	ntimes++;
     /*
@@ -76,7 +76,9 @@ command(void)
 		ch = countch;
 	    else
 	    {
+		at_command = TRUE;
 		ch = readchar();
+		at_command = FALSE;
 		move_on = FALSE;
 		if (mpos != 0)		/* Erase message if its there */
 		{
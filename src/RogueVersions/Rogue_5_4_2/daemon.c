@@ -12,9 +12,100 @@
  */
 
 #include <curses.h>
+#include <limits.h>
+#include <string.h>
 #include "rogue.h"
 
 #define DAEMON -1
+#define FROZEN -1
+#define NKINDS 2			/* BEFORE and AFTER */
+
+/*
+ * Fuses don't count down one by one.  Each kind keeps a clock
+ * that do_fuses() advances, and a fuse remembers the tick it goes
+ * off on, so a turn with nothing due costs nothing.  The slots
+ * are still walked in order when something is due, so fuses go off
+ * in the same order they always did.  A fuse that could never go
+ * off (no time left) is frozen and keeps its own d_time.  d_time
+ * of the rest is only brought up to date for saving, by
+ * store_fuses().
+ */
+static int fuse_clock[NKINDS + 1];	/* ticks of each kind so far */
+static int fuse_next[NKINDS + 1];	/* no fuse of the kind is due before this */
+static int fuse_due[MAXDAEMONS];	/* tick a fuse goes off on, or FROZEN */
+static int d_top = MAXDAEMONS;		/* no slot past this is in use */
+static int scan_type = EMPTY;		/* the kind do_fuses() is walking */
+static int scan_slot;			/* and the slot it's at */
+
+/*
+ * fuse_kind:
+ *	Whether a slot holds a fuse with a clock
+ */
+static int
+fuse_kind(struct delayed_action *wire)
+{
+    return wire->d_type > EMPTY && wire->d_type <= NKINDS
+	&& fuse_due[wire - d_list] != FROZEN;
+}
+
+/*
+ * set_fuse:
+ *	Start a fuse's clock with the given time left, or freeze it
+ *	if it can never go off
+ */
+static void
+set_fuse(struct delayed_action *wire, int time)
+{
+    int i = (int) (wire - d_list);
+    int type = wire->d_type;
+
+    if (time <= 0 || type <= EMPTY || type > NKINDS)
+    {
+	wire->d_time = time;
+	fuse_due[i] = FROZEN;
+	return;
+    }
+    /*
+     * do_fuses() has already ticked this kind's clock, so a slot it
+     * hasn't reached yet still has this tick to come
+     */
+    if (type == scan_type && i > scan_slot)
+	time--;
+    wire->d_time = time;
+    fuse_due[i] = fuse_clock[type] + time;
+    if (fuse_due[i] < fuse_next[type])
+	fuse_next[type] = fuse_due[i];
+}
+
+/*
+ * fuse_left:
+ *	How many ticks a fuse has left
+ */
+static int
+fuse_left(struct delayed_action *wire)
+{
+    int i = (int) (wire - d_list);
+    int time;
+
+    if (!fuse_kind(wire))
+	return wire->d_time;
+    time = fuse_due[i] - fuse_clock[wire->d_type];
+    if (wire->d_type == scan_type && i > scan_slot)
+	time++;
+    return time;
+}
+
+/*
+ * drop_slot:
+ *	Empty a slot, and pull in the end of the list past it
+ */
+static void
+drop_slot(struct delayed_action *dev)
+{
+    dev->d_type = EMPTY;
+    while (d_top > 0 && d_list[d_top - 1].d_type == EMPTY)
+	d_top--;
+}
 
 /*
  * d_slot:
@@ -27,7 +118,11 @@ d_slot(void)
 
     for (dev = d_list; dev <= &d_list[MAXDAEMONS-1]; dev++)
 	if (dev->d_type == EMPTY)
+	{
+	    if (dev >= &d_list[d_top])
+		d_top = (int) (dev - d_list) + 1;
 	    return dev;
+	}
 #ifdef MASTER
     debug("Ran out of fuse slots");
 #endif
@@ -43,7 +138,7 @@ find_slot(void (*func)())
 {
     struct delayed_action *dev;
 
-    for (dev = d_list; dev <= &d_list[MAXDAEMONS-1]; dev++)
+    for (dev = d_list; dev < &d_list[d_top]; dev++)
 	if (dev->d_type != EMPTY && func == dev->d_func)
 	    return dev;
     return NULL;
@@ -58,11 +153,13 @@ start_daemon(void (*func)(), int arg, int type)
 {
     struct delayed_action *dev;
 
-    dev = d_slot();
+    if ((dev = d_slot()) == NULL)
+	return;
     dev->d_type = type;
     dev->d_func = func;
     dev->d_arg = arg;
     dev->d_time = DAEMON;
+    fuse_due[dev - d_list] = FROZEN;
 }
 
 /*
@@ -79,7 +176,7 @@ kill_daemon(void (*func)())
     /*
      * Take it out of the list
      */
-    dev->d_type = EMPTY;
+    drop_slot(dev);
 }
 
 /*
@@ -95,7 +192,7 @@ do_daemons(int flag)
     /*
      * Loop through the devil list
      */
-    for (dev = d_list; dev <= &d_list[MAXDAEMONS-1]; dev++)
+    for (dev = d_list; dev < &d_list[d_top]; dev++)
 	/*
 	 * Executing each one, giving it the proper arguments
 	 */
@@ -112,11 +209,12 @@ fuse(void (*func)(), int arg, int time, int type)
 {
     struct delayed_action *wire;
 
-    wire = d_slot();
+    if ((wire = d_slot()) == NULL)
+	return;
     wire->d_type = type;
     wire->d_func = func;
     wire->d_arg = arg;
-    wire->d_time = time;
+    set_fuse(wire, time);
 }
 
 /*
@@ -130,7 +228,10 @@ lengthen(void (*func)(), int xtime)
 
     if ((wire = find_slot(func)) == NULL)
 	return;
-    wire->d_time += xtime;
+    if (fuse_kind(wire) || wire->d_time + xtime > 0)
+	set_fuse(wire, fuse_left(wire) + xtime);
+    else
+	wire->d_time += xtime;
 }
 
 /*
@@ -144,7 +245,7 @@ extinguish(void (*func)())
 
     if ((wire = find_slot(func)) == NULL)
 	return;
-    wire->d_type = EMPTY;
+    drop_slot(wire);
 }
 
 /*
@@ -155,18 +256,72 @@ void
 do_fuses(int flag)
 {
     struct delayed_action *wire;
+    int next;
+
+    if (flag <= EMPTY || flag > NKINDS)
+	return;
+    if (++fuse_clock[flag] < fuse_next[flag])
+	return;
 
     /*
      * Step though the list
      */
-    for (wire = d_list; wire <= &d_list[MAXDAEMONS-1]; wire++)
+    scan_type = flag;
+    for (wire = d_list; wire < &d_list[d_top]; wire++)
+    {
+	scan_slot = (int) (wire - d_list);
 	/*
-	 * Decrementing counters and starting things we want.  We also need
-	 * to remove the fuse from the list once it has gone off.
+	 * Starting things we want.  We also need to remove the fuse
+	 * from the list once it has gone off.
 	 */
-	if (flag == wire->d_type && wire->d_time > 0 && --wire->d_time == 0)
+	if (flag == wire->d_type && fuse_kind(wire)
+	    && fuse_due[scan_slot] == fuse_clock[flag])
 	{
-	    wire->d_type = EMPTY;
+	    drop_slot(wire);
 	    (*wire->d_func)(wire->d_arg);
 	}
+    }
+    scan_type = EMPTY;
+
+    next = INT_MAX;
+    for (wire = d_list; wire < &d_list[d_top]; wire++)
+	if (flag == wire->d_type && fuse_kind(wire)
+	    && fuse_due[wire - d_list] < next)
+	    next = fuse_due[wire - d_list];
+    fuse_next[flag] = next;
+}
+
+/*
+ * store_fuses:
+ *	Bring every fuse's d_time up to date, for saving
+ */
+void
+store_fuses(void)
+{
+    struct delayed_action *wire;
+
+    for (wire = d_list; wire <= &d_list[MAXDAEMONS-1]; wire++)
+	if (fuse_kind(wire))
+	    wire->d_time = fuse_left(wire);
+}
+
+/*
+ * load_fuses:
+ *	Start the fuses' clocks again from d_list, after it has been
+ *	read back in or cleared
+ */
+void
+load_fuses(void)
+{
+    struct delayed_action *wire;
+
+    memset(fuse_next, 0, sizeof fuse_next);
+    d_top = MAXDAEMONS;
+    for (wire = d_list; wire <= &d_list[MAXDAEMONS-1]; wire++)
+	if (wire->d_type != EMPTY && wire->d_time != DAEMON)
+	    set_fuse(wire, wire->d_time);
+	else
+	    fuse_due[wire - d_list] = FROZEN;
+    while (d_top > 0 && d_list[d_top - 1].d_type == EMPTY)
+	d_top--;
 }
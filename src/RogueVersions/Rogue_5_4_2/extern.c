@@ -116,10 +116,12 @@ FILE *scoreboard = NULL;		/* File descriptor for score file */
 int food_left;				/* Amount of food in hero's stomach */
 int lastscore = -1;			/* Score before this turn */
 int no_command = 0;			/* Number of turns asleep */
+int ntimes = 1;				/* Player moves left this turn */
 int no_move = 0;			/* Number of turns held in place */
 int purse = 0;				/* How much gold he has */
 int quiet = 0;				/* Number of quiet turns */
 int vf_hit = 0;				/* Number of time flytrap has hit */
+int at_command = FALSE;			/* Waiting for the next command */
 
 unsigned int dnum;				/* Dungeon number */
 unsigned int seed;				/* Random number seed */
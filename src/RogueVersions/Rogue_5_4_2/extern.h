@@ -112,7 +112,18 @@ typedef unsigned int pid_t;
 #define MAXLINES	32	/* maximum number of screen lines used */
 #define MAXCOLS		80	/* maximum number of screen columns used */
 
+#ifdef ROGUE_COLLECTION
+/* every draw is counted, so two builds can be checked against each other */
+extern unsigned int rnd_draws;
+void	note_game_end(int amount, int flags, int monst);
+struct GameSnapshot;
+int __declspec(dllexport) snapshot_game(struct GameSnapshot *snap);
+int __declspec(dllexport) restore_game(const struct GameSnapshot *snap);
+void __declspec(dllexport) release_snapshot(struct GameSnapshot *snap);
+#define RN		(rnd_draws++, ((seed = seed*11109+13849) >> 16) & 0xffff)
+#else
 #define RN		(((seed = seed*11109+13849) >> 16) & 0xffff)
+#endif
 #ifdef CTRL
 #undef CTRL
 #endif
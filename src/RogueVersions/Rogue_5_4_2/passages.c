@@ -124,6 +124,25 @@ do_passages(void)
     passnum();
 }
 
+/*
+ * maze_edge:
+ *	See if any of the len spots from (y, x) a door could go on
+ *	is part of the maze.  Small mazes in the top row sometimes
+ *	have none, and looking for one would never end.
+ */
+static int
+maze_edge(int y, int x, int dy, int dx, int len)
+{
+    while (len-- > 0)
+    {
+	if (flat(y, x) & F_PASS)
+	    return TRUE;
+	y += dy;
+	x += dx;
+    }
+    return FALSE;
+}
+
 /*
  * conn:
  *	Draw a corridor from a room in a certain direction.
@@ -176,12 +195,14 @@ conn(int r1, int r2)
 	    {
 		spos.x = rpf->r_pos.x + rnd(rpf->r_max.x - 2) + 1;
 		spos.y = rpf->r_pos.y + rpf->r_max.y - 1;
-	    } while ((rpf->r_flags&ISMAZE) && !(flat(spos.y, spos.x)&F_PASS));
+	    } while ((rpf->r_flags&ISMAZE) && !(flat(spos.y, spos.x)&F_PASS)
+		&& maze_edge(spos.y, rpf->r_pos.x + 1, 0, 1, rpf->r_max.x - 2));
 	if (!(rpt->r_flags & ISGONE))
 	    do
 	    {
 		epos.x = rpt->r_pos.x + rnd(rpt->r_max.x - 2) + 1;
-	    } while ((rpt->r_flags&ISMAZE) && !(flat(epos.y, epos.x)&F_PASS));
+	    } while ((rpt->r_flags&ISMAZE) && !(flat(epos.y, epos.x)&F_PASS)
+		&& maze_edge(epos.y, rpt->r_pos.x + 1, 0, 1, rpt->r_max.x - 2));
 	distance = abs(spos.y - epos.y) - 1;	/* distance to move */
 	turn_delta.y = 0;			/* direction to turn */
 	turn_delta.x = (spos.x < epos.x ? 1 : -1);
@@ -202,12 +223,14 @@ conn(int r1, int r2)
 	    {
 		spos.x = rpf->r_pos.x + rpf->r_max.x - 1;
 		spos.y = rpf->r_pos.y + rnd(rpf->r_max.y - 2) + 1;
-	    } while ((rpf->r_flags&ISMAZE) && !(flat(spos.y, spos.x)&F_PASS));
+	    } while ((rpf->r_flags&ISMAZE) && !(flat(spos.y, spos.x)&F_PASS)
+		&& maze_edge(rpf->r_pos.y + 1, spos.x, 1, 0, rpf->r_max.y - 2));
 	if (!(rpt->r_flags & ISGONE))
 	    do
 	    {
 		epos.y = rpt->r_pos.y + rnd(rpt->r_max.y - 2) + 1;
-	    } while ((rpt->r_flags&ISMAZE) && !(flat(epos.y, epos.x)&F_PASS));
+	    } while ((rpt->r_flags&ISMAZE) && !(flat(epos.y, epos.x)&F_PASS)
+		&& maze_edge(rpt->r_pos.y + 1, epos.x, 1, 0, rpt->r_max.y - 2));
 	distance = abs(spos.x - epos.x) - 1;
 	turn_delta.y = (spos.y < epos.y ? 1 : -1);
 	turn_delta.x = 0;
@@ -64,6 +64,9 @@ score(int amount, int flags, int monst)
 	"killed with Amulet"
     };
 
+#ifdef ROGUE_COLLECTION
+    note_game_end(amount, flags, monst);
+#endif
     start_score();
 
  if (flags >= 0
@@ -492,14 +492,14 @@ typedef struct STONE STONE;
  * External variables
  */
 
-extern int after, again, allscore, door_stop, fight_flush,
+extern int after, again, allscore, at_command, door_stop, fight_flush,
 	   firstmove, has_hit, inv_describe, jump, kamikaze,
 	   lower_msg, move_on, msg_esc, pack_used[], hplusfix, showac,
 	   passgo, playing, q_comm, running, save_msg, see_floor,
 	   seenstairs, stat_msg, terse, to_death, tombstone,
            amulet, count, dir_ch, food_left, hungry_state, inpack,
 	   inv_type, lastscore, level, max_hit, max_level, mpos, take,
-	   n_objs, no_command, no_food, no_move, noscore, ntraps, purse,
+	   n_objs, no_command, no_food, no_move, noscore, ntimes, ntraps, purse,
 	   quiet, vf_hit, runch, last_comm, l_last_comm, last_dir, l_last_dir,
 	   numscores, total, between, group, cNWOOD, cNMETAL, cNSTONES,
 	   cNCOLORS;
@@ -605,6 +605,7 @@ int 	dropcheck(const THING *obj);
 void	eat(void);
 int     encclearerr();
 int     encerror();
+int     encflush(FILE *outf);
 void    encseterr(int err);
 size_t  encread(char *start, size_t size, FILE *inf);
 size_t	encwrite(const char *start, size_t size, FILE *outf);
@@ -662,6 +663,7 @@ int	is_current(const THING *obj);
 int 	is_magic(const THING *obj);
 int     is_symlink(const char *sp); 
 void	kill_daemon(void (*func)());
+void	load_fuses(void);
 void	killed(THING *tp, int pr);
 const char *killname(int monst, int doart);
 void	land(void);
@@ -760,6 +762,7 @@ void	start_score(void);
 void	status(void);
 int	step_ok(int ch);
 void	stomach(void);
+void	store_fuses(void);
 void	strucpy(char *s1, const char *s2, size_t len);
 void	swander(void);
 int	swing(int at_lvl, int op_arm, int wplus);
@@ -144,6 +144,7 @@ save_file(FILE *savef)
     sprintf(buf,"%d x %d\n", LINES, COLS);
     encwrite(buf,80,savef);
     rs_save_file(savef);
+    encflush(savef);
     fflush(savef);
     fclose(savef);
     exit(0);
@@ -284,6 +285,83 @@ encclearerr()
     return(n);
 }
 
+/*
+ * Each encwrite and encread starts the cipher afresh, which is what
+ * the save and score file formats expect.  Within one call it is
+ * carried on from block to block, and encwrite collects what it
+ * writes in encbuf until the block fills or encflush is called.
+ */
+struct encstate {
+    const char *e1, *e2;		/* places in the two keys */
+    char fb;				/* running feedback */
+};
+
+static char encbuf[BUFSIZ];		/* encrypted, not yet written */
+static size_t enclen = 0;		/* bytes used in encbuf */
+static FILE *encfile = NULL;		/* file encbuf is going to */
+
+/*
+ * encstart:
+ *	Start the cipher at the beginning of both keys
+ */
+static void
+encstart(struct encstate *es)
+{
+    es->e1 = encstr;
+    es->e2 = statlist;
+    es->fb = 0;
+}
+
+/*
+ * enccrypt:
+ *	Encrypt or decrypt a buffer in place, carrying the cipher on
+ */
+static void
+enccrypt(struct encstate *es, char *start, size_t size)
+{
+    const char *e1, *e2;
+    char fb;
+    int temp;
+
+    e1 = es->e1;
+    e2 = es->e2;
+    fb = es->fb;
+
+    while (size--)
+    {
+	*start++ ^= *e1 ^ *e2 ^ fb;
+	temp = *e1++;
+	fb = fb + ((char) (temp * *e2++));
+	if (*e1 == '\0')
+	    e1 = encstr;
+	if (*e2 == '\0')
+	    e2 = statlist;
+    }
+
+    es->e1 = e1;
+    es->e2 = e2;
+    es->fb = fb;
+}
+
+/*
+ * encflush:
+ *	Write out what encwrite has collected for a file.  This has to
+ *	be done before the file is closed, rewound or read.
+ */
+int
+encflush(FILE *outf)
+{
+    if (outf != NULL && outf == encfile)
+    {
+	if (!encerrno && fwrite(encbuf, 1, enclen, outf) != enclen)
+	    encerrno = errno;
+	enclen = 0;
+	encfile = NULL;
+    }
+
+    return encerrno;
+}
+
 /*
  * encwrite:
  *	Perform an encrypted write
@@ -292,34 +370,38 @@ encclearerr()
 size_t
 encwrite(const char *start, size_t size, FILE *outf)
 {
-    const char *e1, *e2;
-    char fb;
-    int temp;
+    struct encstate es;
+    size_t n;
     size_t o_size = size;
-    e1 = encstr;
-    e2 = statlist;
-    fb = 0;
 
     if (encerrno) {
 	errno = encerrno;
 	return 0;
     }
 
-    while(size)
+    if (outf != encfile)
     {
-	if (putc(*start++ ^ *e1 ^ *e2 ^ fb, outf) == EOF)
+	encflush(encfile);
+	encfile = outf;
+    }
+
+    encstart(&es);
+
+    while (size && !encerrno)
+    {
+	if (enclen == sizeof encbuf)
 	{
-	    encerrno = errno;
-            break;
+	    encflush(outf);
+	    encfile = outf;
 	}
-
-	temp = *e1++;
-	fb = fb + ((char) (temp * *e2++));
-	if (*e1 == '\0')
-	    e1 = encstr;
-	if (*e2 == '\0')
-	    e2 = statlist;
-	size--;
+	n = sizeof encbuf - enclen;
+	if (n > size)
+	    n = size;
+	memcpy(encbuf + enclen, start, n);
+	enccrypt(&es, encbuf + enclen, n);
+	enclen += n;
+	start += n;
+	size -= n;
     }
 
     return(o_size - size);
@@ -332,33 +414,18 @@ encwrite(const char *start, size_t size, FILE *outf)
 size_t
 encread(char *start, size_t size, FILE *inf)
 {
-    const char *e1, *e2;
-    char fb;
-    int temp;
-    size_t read_size;
+    struct encstate es;
     size_t items;
-    fb = 0;
 
     if (encerrno) {
 	errno = encerrno;
 	return 0;
     }
 
-    items = read_size = fread(start,1,size,inf);
-
-    e1 = encstr;
-    e2 = statlist;
+    items = fread(start,1,size,inf);
 
-    while (read_size--)
-    {
-	*start++ ^= *e1 ^ *e2 ^ fb;
-	temp = *e1++;
-	fb = fb + (char)(temp * *e2++);
-	if (*e1 == '\0')
-	    e1 = encstr;
-	if (*e2 == '\0')
-	    e2 = statlist;
-    }
+    encstart(&es);
+    enccrypt(&es, start, items);
 
     if (items != size)
 	encerrno = errno;
@@ -421,5 +488,6 @@ wr_score(SCORE *top_ten)
           encwrite(scoreline,100,scoreboard);
     }
 
+    encflush(scoreboard);
     rewind(scoreboard); 
 }
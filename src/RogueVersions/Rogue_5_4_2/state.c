@@ -34,6 +34,9 @@
 #include <curses.h>
 #include <errno.h>
 #include "rogue.h"
+#ifdef ROGUE_COLLECTION
+#include <game_snapshot.h>
+#endif
 
 /************************************************************************/
 /* Save State Code                                                      */
@@ -73,15 +76,123 @@ static int format_error = FALSE;
 static int endian = 0x01020304;
 #define  big_endian ( *((char *)&endian) == 0x01 )
 
+#ifdef ROGUE_COLLECTION
+/*
+ * a snapshot starts with the magic number, the format and a checksum of
+ * everything after them, so restore_game can turn away a bad one before
+ * it touches the game
+ */
+#define SNAP_MAGIC	0x52534E50
+#define SNAP_FORMAT	1
+#define SNAP_HEADER	(3 * sizeof(unsigned int))
+
+static struct GameSnapshot *snap_out = NULL;	/* snapshot being written */
+static const struct GameSnapshot *snap_in = NULL; /* snapshot being read */
+static size_t snap_pos = 0;			/* read position in snap_in */
+
+/*
+ * snap_write:
+ *	Append to the snapshot being written, growing it as needed
+ */
+static void
+snap_write(const void *ptr, size_t size)
+{
+    unsigned char *data;
+    size_t cap;
+
+    if (encerror())
+	return;
+
+    if (snap_out->size + size > snap_out->capacity)
+    {
+	cap = snap_out->capacity ? snap_out->capacity : 64 * 1024;
+	while (cap < snap_out->size + size)
+	    cap *= 2;
+	if ((data = realloc(snap_out->data, cap)) == NULL)
+	{
+	    encseterr(ENOMEM);
+	    return;
+	}
+	snap_out->data = data;
+	snap_out->capacity = cap;
+    }
+    memcpy(snap_out->data + snap_out->size, ptr, size);
+    snap_out->size += size;
+}
+
+/*
+ * snap_read:
+ *	Read the next bytes of the snapshot being restored
+ */
+static void
+snap_read(void *ptr, size_t size)
+{
+    if (encerror())
+	return;
+
+    if (snap_pos + size > snap_in->size)
+    {
+	encseterr(EILSEQ);
+	return;
+    }
+    memcpy(ptr, snap_in->data + snap_pos, size);
+    snap_pos += size;
+}
+
+/*
+ * snap_checksum:
+ *	FNV-1a over a snapshot's contents
+ */
+static unsigned int
+snap_checksum(const unsigned char *data, size_t size)
+{
+    unsigned int h = 2166136261u;
+
+    while (size-- > 0)
+	h = (h ^ *data++) * 16777619u;
+    return h;
+}
+
+/*
+ * snap_valid:
+ *	Check that a snapshot is one this engine took, intact
+ */
+static int
+snap_valid(const struct GameSnapshot *sp)
+{
+    unsigned int head[3];
+
+    if (sp->data == NULL || sp->size < SNAP_HEADER)
+	return FALSE;
+    memcpy(head, sp->data, SNAP_HEADER);
+    return head[0] == SNAP_MAGIC && head[1] == SNAP_FORMAT &&
+	head[2] == snap_checksum(sp->data + SNAP_HEADER, sp->size - SNAP_HEADER);
+}
+#endif
+
 void
 rs_write(FILE *savef, const void *ptr, size_t size)
 {
+#ifdef ROGUE_COLLECTION
+    if (snap_out != NULL)
+    {
+	snap_write(ptr, size);
+	return;
+    }
+#endif
     encwrite(ptr, size, savef);
 }
 
 void
 rs_read(FILE *savef, void *ptr, size_t size)
 {
+#ifdef ROGUE_COLLECTION
+    if (snap_in != NULL)
+    {
+	snap_read(ptr, size);
+	return;
+    }
+#endif
     encread(ptr, size, savef);
 }
 
@@ -374,6 +485,15 @@ rs_read_window(FILE *savef, WINDOW *win)
             rs_read_int(savef, &value);
 
             if ((row < height) && (col < width))
+#ifdef ROGUE_COLLECTION
+		/*
+		 * keep the attributes exactly; a glyph drawn raw has to go
+		 * back raw, or addch takes the ring for a tab
+		 */
+		if (snap_in != NULL && !(value & A_ALTCHARSET))
+		    mvwaddch(win,row,col,value);
+		else
+#endif
                 mvwaddrawch(win,row,col,value);
         }
 }
@@ -660,13 +780,13 @@ rs_read_daemons(FILE *savef, struct delayed_action *dlist, int cnt)
             default:dlist[i].d_func = NULL;
                     break;
         }
-    }
 
-    if (dlist[i].d_func == NULL)
-    {
-        dlist[i].d_type = 0;
-        dlist[i].d_arg = 0;
-        dlist[i].d_time = 0;
+        if (dlist[i].d_func == NULL)
+        {
+            dlist[i].d_type = 0;
+            dlist[i].d_arg = 0;
+            dlist[i].d_time = 0;
+        }
     }
 }       
         
@@ -785,6 +905,11 @@ rs_read_rooms(FILE *savef, struct room *r, int cnt)
 	    rs_read_room(savef,&r[n]);
 }
 
+/*
+ * Passages are numbered on from the rooms.  Older saves wrote -1 for a
+ * passage, which is read as NULL and put right by rs_fix_rooms() once
+ * the map is in.
+ */
 void
 rs_write_room_reference(FILE *savef, struct room *rp)
 {
@@ -793,6 +918,9 @@ rs_write_room_reference(FILE *savef, struct room *rp)
     for (i = 0; i < MAXROOMS; i++)
         if (&rooms[i] == rp)
             room = i;
+    for (i = 0; i < MAXPASS; i++)
+        if (&passages[i] == rp)
+            room = MAXROOMS + i;
 
     rs_write_int(savef, room);
 }
@@ -804,10 +932,34 @@ rs_read_room_reference(FILE *savef, struct room **rp)
     
     rs_read_int(savef, &i);
 
-    if (!encerror())
+    if (encerror())
+	return;
+    if (i < -1 || i >= MAXROOMS + MAXPASS)
+	encseterr(EILSEQ);
+    else if (i == -1)
+	*rp = NULL;
+    else if (i >= MAXROOMS)
+	*rp = &passages[i - MAXROOMS];
+    else
 	*rp = &rooms[i];
 }
 
+/*
+ * rs_fix_rooms:
+ *	Find the rooms a save left out, now that the map is read
+ */
+void
+rs_fix_rooms(void)
+{
+    THING *tp;
+
+    if (proom == NULL)
+	proom = roomin(&hero);
+    for (tp = mlist; tp != NULL; tp = next(tp))
+	if (tp->t_room == NULL)
+	    tp->t_room = roomin(&tp->t_pos);
+}
+
 void
 rs_write_monsters(FILE *savef, struct monster *m, int cnt)
 {
@@ -1375,6 +1527,7 @@ rs_save_file(FILE *savef)
     rs_write_obj_info(savef, scr_info,  MAXSCROLLS);  
     rs_write_obj_info(savef, weap_info,  MAXWEAPONS+1);  
     rs_write_obj_info(savef, ws_info, MAXSTICKS);      
+    store_fuses();
     rs_write_daemons(savef, &d_list[0], 20);
     rs_write_int(savef,between);
     rs_write_int(savef, group);
@@ -1437,6 +1590,8 @@ rs_restore_file(FILE *savef)
     rs_read_stats(savef, &max_stats);
     rs_read_rooms(savef, rooms, MAXROOMS);
     rs_read_rooms(savef, passages, MAXPASS);
+    if (!encerror())
+	rs_fix_rooms();
     rs_read_monsters(savef,monsters,26);                  
     rs_read_obj_info(savef, things,  NUMTHINGS);  
     rs_read_obj_info(savef, arm_info,   MAXARMORS);         
@@ -1446,9 +1601,210 @@ rs_restore_file(FILE *savef)
     rs_read_obj_info(savef, weap_info, MAXWEAPONS+1);       
     rs_read_obj_info(savef, ws_info, MAXSTICKS);       
     rs_read_daemons(savef, d_list, 20);
+    load_fuses();
     rs_read_int(savef,&between);
     rs_read_int(savef,&group);
     rs_read_window(savef,stdscr);
 
     return( encclearerr() );
 }
+
+#ifdef ROGUE_COLLECTION
+/*
+ * rs_write_play:
+ *	Write the state of play that a save file leaves out, since a
+ *	restored save starts afresh but a snapshot carries on
+ */
+static void
+rs_write_play(FILE *savef)
+{
+    rs_write_int(savef, no_command);
+    rs_write_int(savef, ntimes);
+    rs_write_int(savef, count);
+    rs_write_int(savef, running);
+    rs_write_int(savef, runch);
+    rs_write_int(savef, door_stop);
+    rs_write_int(savef, firstmove);
+    rs_write_int(savef, to_death);
+    rs_write_int(savef, kamikaze);
+    rs_write_int(savef, max_hit);
+    rs_write_int(savef, take);
+    rs_write_int(savef, move_on);
+    rs_write_int(savef, last_comm);
+    rs_write_int(savef, last_dir);
+    rs_write_int(savef, l_last_comm);
+    rs_write_int(savef, l_last_dir);
+    rs_write_object_reference(savef, pack, last_pick);
+    rs_write_object_reference(savef, pack, l_last_pick);
+    rs_write_int(savef, dir_ch);
+    rs_write_coord(savef, delta);
+    rs_write_coord(savef, oldpos);
+    rs_write_room_reference(savef, oldrp);
+    rs_write_int(savef, mpos);
+}
+
+/*
+ * rs_read_play:
+ *	Read what rs_write_play wrote
+ */
+static void
+rs_read_play(FILE *savef)
+{
+    rs_read_int(savef, &no_command);
+    rs_read_int(savef, &ntimes);
+    rs_read_int(savef, &count);
+    rs_read_int(savef, &running);
+    rs_read_int(savef, &runch);
+    rs_read_int(savef, &door_stop);
+    rs_read_int(savef, &firstmove);
+    rs_read_int(savef, &to_death);
+    rs_read_int(savef, &kamikaze);
+    rs_read_int(savef, &max_hit);
+    rs_read_int(savef, &take);
+    rs_read_int(savef, &move_on);
+    rs_read_int(savef, &last_comm);
+    rs_read_int(savef, &last_dir);
+    rs_read_int(savef, &l_last_comm);
+    rs_read_int(savef, &l_last_dir);
+    rs_read_object_reference(savef, pack, &last_pick);
+    rs_read_object_reference(savef, pack, &l_last_pick);
+    rs_read_int(savef, &dir_ch);
+    rs_read_coord(savef, &delta);
+    rs_read_coord(savef, &oldpos);
+    rs_read_room_reference(savef, &oldrp);
+    rs_read_int(savef, &mpos);
+}
+
+/*
+ * forget_guesses:
+ *	Free the names the player has called a kind of object
+ */
+static void
+forget_guesses(struct obj_info *info, int cnt)
+{
+    int i;
+
+    for (i = 0; i < cnt; i++)
+    {
+	free(info[i].oi_guess);
+	info[i].oi_guess = NULL;
+    }
+}
+
+/*
+ * snapshot_game:
+ *	Copy the game into memory, without the encryption, the exit, or
+ *	the curses teardown of saving it to a file
+ */
+int
+snapshot_game(struct GameSnapshot *sp)
+{
+    unsigned int head[3];
+    int y, x, attrs, err;
+
+    if (!at_command)
+	return EBUSY;
+
+    getyx(stdscr, y, x);
+    attrs = getattrs(stdscr);
+    sp->size = 0;
+    snap_out = sp;
+    head[0] = SNAP_MAGIC;
+    head[1] = SNAP_FORMAT;
+    head[2] = 0;
+    encclearerr();
+    snap_write(head, SNAP_HEADER);
+    err = encclearerr();
+    if (err == 0)
+	err = rs_save_file(NULL);
+    if (err == 0)
+    {
+	rs_write_play(NULL);
+	rs_write_int(NULL, y);
+	rs_write_int(NULL, x);
+	rs_write_int(NULL, attrs);
+	err = encclearerr();
+    }
+    snap_out = NULL;
+    move(y, x);		/* writing stdscr moved the cursor */
+    if (err != 0)
+	return err;
+
+    head[2] = snap_checksum(sp->data + SNAP_HEADER, sp->size - SNAP_HEADER);
+    memcpy(sp->data, head, SNAP_HEADER);
+    return 0;
+}
+
+/*
+ * restore_game:
+ *	Replace the game with one from snapshot_game.  A snapshot that
+ *	doesn't check out is turned away with the game untouched; once it
+ *	does, the only way left to fail is running out of memory part way,
+ *	which loses the game.
+ */
+int
+restore_game(const struct GameSnapshot *sp)
+{
+    THING *tp;
+    int i, y, x, attrs, err;
+
+    if (!at_command)
+	return EBUSY;
+    if (!snap_valid(sp))
+	return EILSEQ;
+
+    /*
+     * everything the snapshot allocates afresh has to go first
+     */
+    for (tp = mlist; tp != NULL; tp = next(tp))
+	free_list(tp->t_pack);
+    free_list(mlist);
+    free_list(lvl_obj);
+    free_list(pack);
+    for (i = 0; i < MAXSCROLLS; i++)
+    {
+	free(s_names[i]);
+	s_names[i] = NULL;
+    }
+    forget_guesses(things, NUMTHINGS);
+    forget_guesses(arm_info, MAXARMORS);
+    forget_guesses(pot_info, MAXPOTIONS);
+    forget_guesses(ring_info, MAXRINGS);
+    forget_guesses(scr_info, MAXSCROLLS);
+    forget_guesses(weap_info, MAXWEAPONS + 1);
+    forget_guesses(ws_info, MAXSTICKS);
+
+    snap_in = sp;
+    snap_pos = SNAP_HEADER;
+    attrset(0);			/* or the window comes back in its color */
+    err = rs_restore_file(NULL);
+    if (err == 0)
+    {
+	rs_read_play(NULL);
+	rs_read_int(NULL, &y);
+	rs_read_int(NULL, &x);
+	rs_read_int(NULL, &attrs);
+	err = encclearerr();
+    }
+    snap_in = NULL;
+    if (err != 0)
+	return err;
+
+    attrset(attrs);
+    move(y, x);
+    refresh();
+    return 0;
+}
+
+/*
+ * release_snapshot:
+ *	Free a snapshot's buffer
+ */
+void
+release_snapshot(struct GameSnapshot *sp)
+{
+    free(sp->data);
+    sp->data = NULL;
+    sp->size = sp->capacity = 0;
+}
+#endif
@@ -0,0 +1,158 @@
+/*
+ * sweep:
+ *	Generate levels without playing them, for dungeon statistics
+ *
+ * Rogue: Exploring the Dungeons of Doom
+ * Copyright (C) 1980-1983, 1985, 1999 Michael Toy, Ken Arnold and Glenn Wichman
+ * All rights reserved.
+ *
+ * See the file LICENSE.TXT for full copyright and licensing information.
+ */
+
+#include <curses.h>
+#include <stdlib.h>
+#include <string.h>
+#include <level_stats.h>
+#include "rogue.h"
+
+#ifdef ROGUE_COLLECTION
+
+/*
+ * sweep_init:
+ *	Do the parts of main() that only happen once
+ */
+static void
+sweep_init(void)
+{
+    static int initialized = FALSE;
+
+    if (initialized)
+	return;
+    initialized = TRUE;
+    init_game(NULL, NULL, 25, 80);
+    initscr();
+    init_probs();
+    hw = newwin(LINES, COLS, 0, 0);
+    /*
+     * a monster waking up in the first room can print a message,
+     * which looks around from the last room she was in
+     */
+    oldrp = &passages[0];
+}
+
+/*
+ * sweep_start:
+ *	Start a new game with the given seed the way main() does, so
+ *	the first level matches a game run with SEED set
+ */
+static void
+sweep_start(int s)
+{
+    int i;
+
+    free_list(pack);
+    inpack = 0;
+    memset(pack_used, 0, 26 * sizeof pack_used[0]);
+    for (i = 0; i < MAXSCROLLS; i++)
+    {
+	free(s_names[i]);
+	s_names[i] = NULL;
+    }
+    player.t_flags = 0;
+    memset(d_list, 0, sizeof d_list);
+    load_fuses();
+    seed = s;
+    init_player();
+    init_names();
+    init_colors();
+    init_stones();
+    init_materials();
+}
+
+/*
+ * sweep_count:
+ *	Summarize the level new_level() just made
+ */
+static void
+sweep_count(struct LevelStats *sp)
+{
+    static char walkable[MAXLINES * MAXCOLS];
+    struct room *rp;
+    THING *tp;
+    int y, x, ch, fl;
+
+    for (rp = rooms; rp < &rooms[MAXROOMS]; rp++)
+    {
+	if (rp->r_flags & ISGONE)
+	    sp->gone_rooms++;
+	else
+	    sp->rooms++;
+	if (rp->r_flags & ISMAZE)
+	    sp->maze_rooms++;
+	else if ((rp->r_flags & (ISDARK|ISGONE)) == ISDARK)
+	    sp->dark_rooms++;
+    }
+    for (tp = mlist; tp != NULL; tp = next(tp))
+	sp->monsters++;
+    for (tp = lvl_obj; tp != NULL; tp = next(tp))
+	switch (tp->o_type)
+	{
+	    case GOLD: sp->items[STAT_GOLD]++;
+	    when POTION: sp->items[STAT_POTION]++;
+	    when SCROLL: sp->items[STAT_SCROLL]++;
+	    when FOOD: sp->items[STAT_FOOD]++;
+	    when WEAPON: sp->items[STAT_WEAPON]++;
+	    when ARMOR: sp->items[STAT_ARMOR]++;
+	    when RING: sp->items[STAT_RING]++;
+	    when STICK: sp->items[STAT_STICK]++;
+	    when AMULET: sp->items[STAT_AMULET]++;
+	}
+    sp->traps = ntraps;
+
+    for (y = 0; y < NUMLINES; y++)
+	for (x = 0; x < NUMCOLS; x++)
+	{
+	    ch = chat(y, x);
+	    fl = flat(y, x);
+	    if (ch == DOOR)
+		sp->doors++;
+	    else if ((ch == VWALL || ch == HWALL) && !(fl & F_REAL))
+		sp->secret_doors++;
+	    /*
+	     * hidden passages are left blank and secret doors look like
+	     * walls, so neither is walkable until it is searched for
+	     */
+	    walkable[y * NUMCOLS + x] = step_ok(ch);
+	}
+    level_stair_distance(walkable, NUMLINES, NUMCOLS, hero.y, hero.x, stairs.y, stairs.x, sp);
+}
+
+/*
+ * sweep_levels:
+ *	Make count levels at the given depth, one per seed, and
+ *	record what is on each of them
+ */
+int
+sweep_levels(int first_seed, int count, int depth, struct LevelStats *stats)
+{
+    struct LevelStats *sp;
+
+    sweep_init();
+    for (sp = stats; sp < &stats[count]; sp++)
+    {
+	memset(sp, 0, sizeof *sp);
+	sp->seed = first_seed + (int) (sp - stats);
+	sp->depth = depth;
+	sweep_start(sp->seed);
+	level = max_level = depth;
+	no_food = 0;
+	ntraps = 0;
+	amulet = FALSE;
+	mpos = 0;
+	new_level();
+	sweep_count(sp);
+    }
+    return count;
+}
+
+#endif
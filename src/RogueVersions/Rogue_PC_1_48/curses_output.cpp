@@ -167,7 +167,7 @@ private:
     int m_attr = 0x7;
     bool m_cursor = false;
     bool m_curtain_down = false;
-    bool m_should_render = true;
+    int m_render_stops = 0; //stop_rendering calls that haven't been resumed yet
 
     WINDOW* m_backup_window;
 };
@@ -621,12 +621,13 @@ int PdCursesOutput::columns() const
 
 void PdCursesOutput::stop_rendering()
 {
-    m_should_render = false;
+    ++m_render_stops;
 }
 
 void PdCursesOutput::resume_rendering()
 {
-    m_should_render = true;
+    if (m_render_stops > 0 && --m_render_stops > 0)
+        return;
     Render();
     ApplyCursor();
 }
@@ -638,14 +639,14 @@ void PdCursesOutput::play_sound(const char * id)
 
 void PdCursesOutput::Render()
 {
-    if (!m_should_render || m_curtain_down)
+    if (m_render_stops > 0 || m_curtain_down)
         return;
     ::refresh();
 }
 
 void PdCursesOutput::ApplyCursor()
 {
-    if (!m_should_render || m_curtain_down)
+    if (m_render_stops > 0 || m_curtain_down)
         return;
     ::curs_set(m_cursor);
 }
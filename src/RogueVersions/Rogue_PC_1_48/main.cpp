@@ -1,6 +1,7 @@
 #include <memory>
 #include "curses_input.h"
 #include <main.h>
+#include <rip.h>
 #include <output_interface.h>
 #include <input_interface.h>
 #include <display_interface.h>
@@ -9,6 +10,12 @@ extern "C"
 {
     __declspec(dllexport) int rogue_main(int argc, char **argv);
     __declspec(dllexport) void init_game(struct DisplayInterface* screen, struct InputInterface* input, int lines, int cols);
+    __declspec(dllexport) int sweep_levels(int first_seed, int count, int depth, struct LevelStats* stats);
+    __declspec(dllexport) void get_agent_state(struct AgentState* state);
+    __declspec(dllexport) int get_distance_map(int field, int* distances, int lines, int cols);
+    __declspec(dllexport) void reseed_game(unsigned int seed);
+    __declspec(dllexport) unsigned int get_random_draws();
+    __declspec(dllexport) int get_game_end(struct GameEnd* end);
     void init_curses(DisplayInterface* screen, InputInterface* input, int lines, int cols);
 
     std::shared_ptr<InputInterfaceEx> s_input;
@@ -30,3 +37,39 @@ int rogue_main(int argc, char **argv)
 
     return 0;
 }
+
+int sweep_levels(int first_seed, int count, int depth, LevelStats* stats)
+{
+    static std::shared_ptr<OutputInterface> output;
+    if (!output) {
+        init_game(nullptr, nullptr, 25, 80);
+        output = CreateCursesOutput();
+    }
+
+    return sweep_main(first_seed, count, depth, stats, output);
+}
+
+void get_agent_state(AgentState* state)
+{
+    describe_game(state);
+}
+
+int get_distance_map(int field, int* distances, int lines, int cols)
+{
+    return describe_distances(field, distances, lines, cols);
+}
+
+void reseed_game(unsigned int seed)
+{
+    reseed_main(seed);
+}
+
+unsigned int get_random_draws()
+{
+    return random_draws();
+}
+
+int get_game_end(GameEnd* end)
+{
+    return describe_ending(end) ? 1 : 0;
+}
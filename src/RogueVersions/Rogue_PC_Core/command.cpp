@@ -49,6 +49,7 @@ namespace
         { '.', do_rest },
         { '>', do_go_down_stairs },
         { '<', do_go_up_stairs },
+        { '_', do_travel },
 
         //informational/utility actions
         { 'i', do_inventory },
@@ -263,6 +264,10 @@ Command get_command()
     game->repeat_last_action = false;
     look(true);
 
+    //a travel picks the direction of each step once the last one has been taken
+    if (game->in_travel_cmd())
+        continue_travel();
+
     if (!game->in_run_cmd())
         game->m_stop_at_door = false;
     
@@ -330,12 +335,23 @@ bool dispatch_command(Command c)
 }
 
 
+//is_quiet_repeat: A rest or search that has more turns to go.  These are what long
+//counts are used for, and nobody needs to watch each turn of them.
+bool is_quiet_repeat(const Command& c)
+{
+    return (c.ch == '.' || c.ch == 's') && game->last_turn.command.count > 0;
+}
+
 void execute_player_command()
 {
     bool counts_as_turn;
     do
     {
         Command c = get_command();
+        //the game plays on exactly as it would have, only the screen is held back
+        //until a key is wanted, which is when the repeat or run ends or is interrupted
+        if (is_quiet_repeat(c) || game->in_run_cmd())
+            game->hold_output();
         counts_as_turn = dispatch_command(c);
 
         //todo: why is this here?
@@ -1,6 +1,9 @@
 //Contains functions for dealing with things that happen in the future.
 //@(#)daemon.c5.2 (Berkeley) 6/18/82
 
+#include <algorithm>
+#include <climits>
+#include <vector>
 #include "rogue.h"
 #include "daemon.h"
 #include "io.h"
@@ -8,7 +11,6 @@
 #define EMPTY  0
 #define FULL  1
 #define DAEMON  -1
-#define MAXDAEMONS  20
 
 //todo: log/add debug screen for fuses
 /*
@@ -28,31 +30,93 @@ fuses used in original code:
   -rollwand: create wandering monster
 */
 
+//Fuses don't count down one by one.  fuse_clock is advanced by do_fuses, and a
+//fuse remembers the tick it goes off on, so a turn with nothing due costs
+//nothing.  The slots are still walked in order when something is due, so fuses
+//go off in the same order they always did.  A fuse with no time left can never
+//go off, so it's frozen and keeps its d_time like a daemon does.
 struct delayed_action
 {
     void(*d_func)(int);
     int d_arg;
     int d_time;
-} d_list[MAXDAEMONS];
+    int d_due; //tick the fuse goes off on, or FROZEN
+};
 
-//d_slot: Find an empty slot in the daemon/fuse list
-struct delayed_action *d_slot()
+namespace
 {
-    struct delayed_action *dev;
+    const int FROZEN = -1;
+
+    //grows as it needs to, and shrinks back when the slots at the end empty
+    std::vector<delayed_action> d_list;
+
+    int fuse_clock = 0; //ticks so far
+    int fuse_next = INT_MAX; //no fuse is due before this
+    int scan_slot = -1; //the slot do_fuses is at, if it's walking the list
+
+    bool is_fuse(const delayed_action& wire)
+    {
+        return wire.d_func != EMPTY && wire.d_due != FROZEN;
+    }
+
+    //set_fuse: Start a fuse's clock with the given time left, or freeze it if it can never go off
+    void set_fuse(int i, int time)
+    {
+        delayed_action& wire = d_list[i];
+        if (time <= 0) {
+            wire.d_time = time;
+            wire.d_due = FROZEN;
+            return;
+        }
+        //do_fuses has already ticked the clock, so a slot it hasn't reached yet still has this tick to come
+        if (scan_slot >= 0 && i > scan_slot)
+            --time;
+        wire.d_time = time;
+        wire.d_due = fuse_clock + time;
+        fuse_next = std::min(fuse_next, wire.d_due);
+    }
+
+    //fuse_left: How many ticks a fuse has left
+    int fuse_left(int i)
+    {
+        const delayed_action& wire = d_list[i];
+        if (!is_fuse(wire))
+            return wire.d_time;
+        int time = wire.d_due - fuse_clock;
+        if (scan_slot >= 0 && i > scan_slot)
+            ++time;
+        return time;
+    }
 
-    for (dev = d_list; dev < &d_list[MAXDAEMONS]; dev++) if (dev->d_func == EMPTY) return dev;
+    //drop_slot: Empty a slot, and let go of the end of the list past it
+    void drop_slot(int i)
+    {
+        //a fuse that put itself out has already gone
+        if (i < (int)d_list.size())
+            d_list[i].d_func = EMPTY;
+        while (!d_list.empty() && d_list.back().d_func == EMPTY)
+            d_list.pop_back();
+    }
+}
 
-    debug("Ran out of fuse slots");
-    return NULL;
+//d_slot: Find an empty slot in the daemon/fuse list
+int d_slot()
+{
+    for (size_t i = 0; i < d_list.size(); ++i)
+        if (d_list[i].d_func == EMPTY)
+            return (int)i;
+
+    d_list.push_back(delayed_action());
+    return (int)d_list.size() - 1;
 }
 
 //find_slot: Find a particular slot in the table
-struct delayed_action *find_slot(void(*func)(int))
+int find_slot(void(*func)(int))
 {
-    struct delayed_action *dev;
-
-    for (dev = d_list; dev < &d_list[MAXDAEMONS]; dev++) if (func == dev->d_func) return dev;
-    return NULL;
+    for (size_t i = 0; i < d_list.size(); ++i)
+        if (func == d_list[i].d_func)
+            return (int)i;
+    return -1;
 }
 
 void daemon(void(*func)(), int arg)
@@ -64,23 +128,20 @@ void daemon(void(*func)(), int arg)
 //daemon: Start a daemon, takes a function.
 void daemon(void(*func)(int), int arg)
 {
-    struct delayed_action *dev;
-
-    dev = d_slot();
-    dev->d_func = func;
-    dev->d_arg = arg;
-    dev->d_time = DAEMON;
+    int i = d_slot();
+    d_list[i].d_func = func;
+    d_list[i].d_arg = arg;
+    d_list[i].d_time = DAEMON;
+    d_list[i].d_due = FROZEN;
 }
 
 //do_daemons: Run all the daemons, passing the argument to the function.
 void do_daemons()
 {
-    struct delayed_action *dev;
-
     //Loop through the devil list, Executing each one, giving it the proper arguments
-    for (dev = d_list; dev < &d_list[MAXDAEMONS]; dev++)
-        if (dev->d_time == DAEMON && dev->d_func != 0)
-            (*dev->d_func)(dev->d_arg);
+    for (size_t i = 0; i < d_list.size(); ++i)
+        if (d_list[i].d_time == DAEMON && d_list[i].d_func != 0)
+            (*d_list[i].d_func)(d_list[i].d_arg);
 }
 
 void fuse(void(*func)(), int arg, int time)
@@ -91,12 +152,10 @@ void fuse(void(*func)(), int arg, int time)
 //fuse: Start a fuse to go off in a certain number of turns
 void fuse(void(*func)(int), int arg, int time)
 {
-    struct delayed_action *wire;
-
-    wire = d_slot();
-    wire->d_func = func;
-    wire->d_arg = arg;
-    wire->d_time = time;
+    int i = d_slot();
+    d_list[i].d_func = func;
+    d_list[i].d_arg = arg;
+    set_fuse(i, time);
 }
 
 void lengthen(void(*func)(), int xtime)
@@ -107,10 +166,12 @@ void lengthen(void(*func)(), int xtime)
 //lengthen: Increase the time until a fuse goes off
 void lengthen(void(*func)(int), int xtime)
 {
-    struct delayed_action *wire;
-
-    if ((wire = find_slot(func)) == NULL) return;
-    wire->d_time += xtime;
+    int i = find_slot(func);
+    if (i < 0) return;
+    if (is_fuse(d_list[i]) || d_list[i].d_time + xtime > 0)
+        set_fuse(i, fuse_left(i) + xtime);
+    else
+        d_list[i].d_time += xtime;
 }
 
 void extinguish(void(*func)())
@@ -121,25 +182,35 @@ void extinguish(void(*func)())
 //extinguish: Put out a fuse
 void extinguish(void(*func)(int))
 {
-    struct delayed_action *wire;
-
-    if ((wire = find_slot(func)) == NULL) return;
-    wire->d_func = EMPTY;
+    int i = find_slot(func);
+    if (i < 0) return;
+    drop_slot(i);
 }
 
 //do_fuses: Decrement counters and start needed fuses
 void do_fuses()
 {
-    struct delayed_action *wire;
+    if (++fuse_clock < fuse_next)
+        return;
 
     //Step through the list
-    //Decrementing counters and starting things we want.  We also need to remove the fuse from the list once it has gone off.
-    for (wire = d_list; wire < &d_list[MAXDAEMONS]; wire++)
+    //Starting things we want.  We also need to remove the fuse from the list once it has gone off.
+    //The slot stays taken, with no time left, while its function runs.
+    for (size_t i = 0; i < d_list.size(); ++i)
     {
-        if (wire->d_func != EMPTY && wire->d_time > 0 && --wire->d_time == 0)
+        scan_slot = (int)i;
+        if (is_fuse(d_list[i]) && d_list[i].d_due == fuse_clock)
         {
-            (*wire->d_func)(wire->d_arg);
-            wire->d_func = EMPTY;
+            d_list[i].d_time = 0;
+            d_list[i].d_due = FROZEN;
+            (*d_list[i].d_func)(d_list[i].d_arg);
+            drop_slot(i);
         }
     }
+    scan_slot = -1;
+
+    fuse_next = INT_MAX;
+    for (size_t i = 0; i < d_list.size(); ++i)
+        if (is_fuse(d_list[i]))
+            fuse_next = std::min(fuse_next, d_list[i].d_due);
 }
@@ -124,6 +124,7 @@ void run_monsters()
     //and Nymphs disappear as part of their attack.  Ice Monsters and Dragons can
     //kill themselves or others with their projectiles.  The logic here to avoid
     //iterator invalidation is horrendous.
+    game->level().forget_exits();
     for (auto it = game->level().monsters.begin(); it != game->level().monsters.end();)
     {
         //save the next iterator in case the monster dies during its own turn
@@ -0,0 +1,80 @@
+//Distance fields over the known map, for travel and for programs playing the game
+#include "distance_maps.h"
+#include "rogue.h"
+#include "game_state.h"
+#include "level.h"
+#include "hero.h"
+#include "misc.h"
+#include "move.h"
+#include "output_shim.h"
+
+bool DistanceMaps::is_source(Level& level, int field, Coord p)
+{
+    switch (field)
+    {
+    case DIST_STAIRS:
+        return level.get_tile(p) == STAIRS && level.is_seen(p);
+
+    case DIST_UNEXPLORED:
+        if (!level.is_known_walkable(p))
+            return false;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                Coord n = { p.x + dx, p.y + dy };
+                if (!offmap(n) && !level.is_seen(n))
+                    return true;
+            }
+        }
+        return false;
+    }
+    return false;
+}
+
+const short* DistanceMaps::get(Level& level, int field)
+{
+    Field& f = m_fields[field];
+    Coord hero = game->hero().position();
+    if (f.version == m_version && (field != DIST_HERO || f.hero == hero))
+        return f.distances.data();
+
+    f.version = m_version;
+    f.hero = hero;
+    f.distances.assign(MAXLINES * MAXCOLS, -1);
+    short* dist = f.distances.data();
+
+    //every source starts at 0, so each square ends up counting to the nearest one
+    const int COLS = game->screen().columns();
+    std::vector<Coord> queue;
+    if (field == DIST_HERO) {
+        queue.push_back(hero);
+    }
+    else {
+        for (int y = 1; y < maxrow(); y++) {
+            for (int x = 0; x < COLS; x++) {
+                if (is_source(level, field, { x, y }))
+                    queue.push_back({ x, y });
+            }
+        }
+    }
+    for (Coord p : queue)
+        dist[p.y * MAXCOLS + p.x] = 0;
+
+    for (size_t i = 0; i < queue.size(); ++i)
+    {
+        Coord p = queue[i];
+        short d = dist[p.y * MAXCOLS + p.x] + 1;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                Coord n = { p.x + dx, p.y + dy };
+                if (offmap(n) || dist[n.y * MAXCOLS + n.x] >= 0)
+                    continue;
+                //the hero's own square is known even where the floor around it is dark
+                if (!(level.is_known_walkable(n) || n == hero) || !diag_ok(p, n))
+                    continue;
+                dist[n.y * MAXCOLS + n.x] = d;
+                queue.push_back(n);
+            }
+        }
+    }
+    return dist;
+}
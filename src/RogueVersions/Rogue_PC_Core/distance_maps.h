@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+#include <coord.h>
+#include <distance_map.h>
+
+struct Level;
+
+//The DIST_ fields of a level, kept until they go stale.  A field is worked out
+//again only when it's asked for after the known map has changed, or for
+//DIST_HERO, after the hero has moved.
+struct DistanceMaps
+{
+    //get: A field, MAXLINES rows of MAXCOLS squares laid out like the screen, -1 where there's no known way
+    const short* get(Level& level, int field);
+
+    //invalidate: The known map has changed, so every field is stale
+    void invalidate() { ++m_version; }
+
+private:
+    //is_source: If a square is one of the squares a field counts the moves to
+    bool is_source(Level& level, int field, Coord p);
+
+    struct Field
+    {
+        std::vector<short> distances;
+        int version = -1;       //m_version when it was worked out
+        Coord hero = { -1, -1 }; //where the hero was then
+    };
+    Field m_fields[DIST_NUM_FIELDS];
+    int m_version = 0;
+};
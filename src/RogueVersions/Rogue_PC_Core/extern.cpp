@@ -8,7 +8,7 @@
 struct Random;
 struct GameState;
 
-#define MAXHELPC  65
+#define MAXHELPC  66
 const char* const helpcoms[MAXHELPC] =
 {
   "F1     list of commands",
@@ -36,6 +36,7 @@ const char* const helpcoms[MAXHELPC] =
   ".      rest",
   ">      go down a staircase",
   "<      go up a staircase",
+  "_      travel to the stairs or a square",
   "Esc    cancel command",
   "d      drop object",
   "e      eat food",
@@ -59,6 +59,22 @@ namespace
         return "";
 #endif
     }
+
+    //A file in the data directory overrides the table compiled into the game
+    std::string GetOverride(const std::string& filename)
+    {
+        std::ifstream file(filename);
+        return file ? filename : std::string();
+    }
+
+    void LoadItemTables()
+    {
+        std::string path = GetPath("data");
+        LoadScrolls(GetOverride(path + "scrolls.dat"));
+        LoadPotions(GetOverride(path + "potions.dat"));
+        LoadRings(GetOverride(path + "rings.dat"));
+        LoadSticks(GetOverride(path + "sticks.dat"));
+    }
 }
 
 GameState::GameState(int seed, std::shared_ptr<OutputInterface> output, std::shared_ptr<InputInterfaceEx> input) :
@@ -67,11 +83,7 @@ GameState::GameState(int seed, std::shared_ptr<OutputInterface> output, std::sha
     m_curses(new OutputShim(output)),
     m_level(new Level)
 {
-    std::string path = GetPath("data");
-    LoadScrolls(path + "scrolls.dat");
-    LoadPotions(path + "potions.dat");
-    LoadRings(path + "rings.dat");
-    LoadSticks(path + "sticks.dat");
+    LoadItemTables();
 
     options.init_environment();
     process_environment();
@@ -85,7 +97,7 @@ void Options::deserialize(std::istream& in)
         std::string key, value;
         read_string(in, &key);
         read_string(in, &value);
-        m_environment[key] = value;
+        set_environment(key, value);
     }
 }
 
@@ -144,11 +156,7 @@ GameState::GameState(Random* random, const std::string& filename, bool show_repl
     m_input_interface.reset(new CapturedInput(std::move(combo)));
 
     m_level.reset(new Level);
-    std::string path = GetPath("data");
-    LoadScrolls(path + "scrolls.dat");
-    LoadPotions(path + "potions.dat");
-    LoadRings(path + "rings.dat");
-    LoadSticks(path + "sticks.dat");
+    LoadItemTables();
 
     if (!m_show_replay)
     {
@@ -176,13 +184,13 @@ void GameState::cancel_repeating_cmd()
 
 void Options::init_environment()
 {
-    m_environment["name"] = "Rodney";
-    m_environment["fruit"] = "Slime Mold";
-    m_environment["macro"] = "v";
-    m_environment["scorefile"] = "roguepc.scr";
-    m_environment["savefile"] = "rogue.sav";
-    m_environment["throws_affect_mimics"] = "false";
-    m_environment["hplusfix"] = "false";
+    set_environment("name", "Rodney");
+    set_environment("fruit", "Slime Mold");
+    set_environment("macro", "v");
+    set_environment("scorefile", "roguepc.scr");
+    set_environment("savefile", "rogue.sav");
+    set_environment("throws_affect_mimics", "false");
+    set_environment("hplusfix", "false");
 }
 
 void Options::from_file(std::istream & in, char delimiter)
@@ -257,6 +265,41 @@ std::string Options::get_environment(const std::string& key) const
 void Options::set_environment(const std::string& key, const std::string& value)
 {
     m_environment[key] = value;
+    parse_option(key, value);
+}
+
+void Options::parse_option(const std::string& key, const std::string& value)
+{
+    if (key == "pause_replay")
+        m_start_replay_paused = value == "true";
+    else if (key == "hide_replay")
+        m_hide_replay = value == "true";
+    else if (key == "menu")
+        m_show_inventory_menu = value != "false";
+    else if (key == "dir_key_clears_more")
+        m_dir_key_clears_more = value == "true";
+    else if (key == "prompt_for_name")
+        m_prompt_for_name = value != "false";
+    else if (key == "small_screen")
+        m_narrow_screen = value == "true";
+    else if (key == "screen")
+        m_monochrome = value == "bw";
+    else if (key == "use_exp_level_names")
+        m_use_exp_level_names = value != "false";
+    else if (key == "showac")
+        m_show_armor_class = value == "true";
+    else if (key == "trap_bugfix")
+        m_trap_bugfix = value != "false";
+    else if (key == "room_bugfix")
+        m_room_bugfix = value != "false";
+    else if (key == "confused_bugfix")
+        m_confused_bugfix = value != "false";
+    else if (key == "hplusfix")
+        m_hit_plus_bugfix = value != "false";
+    else if (key == "throws_affect_mimics")
+        m_throws_affect_mimics = value == "true";
+    else if (key == "emulate_version")
+        m_act_like_v1_1 = value == "1.1";
 }
 
 void GameState::set_logfile(const std::string & filename)
@@ -331,100 +374,31 @@ void GameState::set_fast_play(bool enable)
         m_fast_play_enabled = enable;
 }
 
-void GameState::set_monster_data(std::string s)
-{
-    m_monster_data.push_back(std::move(s));
-}
-
-//todo:
-//monster config
-//all extern/global variables
-//all static variables
-
-bool Options::throws_affect_mimics() const
-{
-    return get_environment("throws_affect_mimics") == "true";
-}
-
-bool Options::act_like_v1_1() const
-{
-    return get_environment("emulate_version") == "1.1";
-}
-
-bool Options::disable_scroll_lock() const
-{
-    return true;
-}
-
-bool Options::disable_save() const
+void GameState::hold_output()
 {
-    return true;
+    if (m_output_held)
+        return;
+    m_output_held = true;
+    screen().stop_rendering();
 }
 
-bool Options::show_inventory_menu() const
+void GameState::release_output()
 {
-    return get_environment("menu") != "false";
+    if (!m_output_held)
+        return;
+    m_output_held = false;
+    screen().resume_rendering();
 }
 
-bool Options::dir_key_clears_more() const
-{
-    return get_environment("dir_key_clears_more") == "true";
-}
-
-bool Options::prompt_for_name() const
-{
-    return get_environment("prompt_for_name") != "false";
-}
-
-bool Options::start_replay_paused() const
-{
-    return get_environment("pause_replay") == "true";
-}
-
-bool Options::hide_replay() const
-{
-    return get_environment("hide_replay") == "true";
-}
-
-bool Options::narrow_screen() const
-{
-    return get_environment("small_screen") == "true";
-}
-
-bool Options::monochrome() const
-{
-    return get_environment("screen") == "bw";
-}
-
-bool Options::use_exp_level_names() const
-{
-    return get_environment("use_exp_level_names") != "false";
-}
-
-bool Options::show_armor_class() const
-{
-    return get_environment("showac") == "true";
-}
-
-bool Options::trap_bugfix() const
-{
-    return get_environment("trap_bugfix") != "false";
-}
-
-bool Options::room_bugfix() const
-{
-    return get_environment("room_bugfix") != "false";
-}
-
-bool Options::confused_bugfix() const
+void GameState::set_monster_data(std::string s)
 {
-    return get_environment("confused_bugfix") != "false";
+    m_monster_data.push_back(std::move(s));
 }
 
-bool Options::hit_plus_bugfix() const
-{
-    return get_environment("hplusfix") != "false";
-}
+//todo:
+//monster config
+//all extern/global variables
+//all static variables
 
 int GameState::get_level()
 {
@@ -449,3 +423,8 @@ int GameState::max_level()
     return m_max_level;
 }
 
+void GameState::set_level(int level)
+{
+    m_level_number = m_max_level = level;
+}
+
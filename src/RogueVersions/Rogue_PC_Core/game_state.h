@@ -19,30 +19,30 @@ struct Item;
 
 struct Options
 {
-    bool start_replay_paused() const;
-    bool hide_replay() const;
+    bool start_replay_paused() const { return m_start_replay_paused; }
+    bool hide_replay() const { return m_hide_replay; }
 
     //control options
-    bool show_inventory_menu() const;
-    bool dir_key_clears_more() const;
-    bool prompt_for_name() const;
+    bool show_inventory_menu() const { return m_show_inventory_menu; }
+    bool dir_key_clears_more() const { return m_dir_key_clears_more; }
+    bool prompt_for_name() const { return m_prompt_for_name; }
 
     //graphics options
-    bool narrow_screen() const;
-    bool monochrome() const;
-    bool use_exp_level_names() const;
-    bool show_armor_class() const;
+    bool narrow_screen() const { return m_narrow_screen; }
+    bool monochrome() const { return m_monochrome; }
+    bool use_exp_level_names() const { return m_use_exp_level_names; }
+    bool show_armor_class() const { return m_show_armor_class; }
 
     //rule changing options
-    bool trap_bugfix() const;
-    bool room_bugfix() const;
-    bool confused_bugfix() const;
-    bool hit_plus_bugfix() const;
-    bool throws_affect_mimics() const;
-    bool act_like_v1_1() const;
+    bool trap_bugfix() const { return m_trap_bugfix; }
+    bool room_bugfix() const { return m_room_bugfix; }
+    bool confused_bugfix() const { return m_confused_bugfix; }
+    bool hit_plus_bugfix() const { return m_hit_plus_bugfix; }
+    bool throws_affect_mimics() const { return m_throws_affect_mimics; }
+    bool act_like_v1_1() const { return m_act_like_v1_1; }
 
-    bool disable_scroll_lock() const;
-    bool disable_save() const;
+    bool disable_scroll_lock() const { return true; }
+    bool disable_save() const { return true; }
 
 public:
     void init_environment();
@@ -58,7 +58,29 @@ public:
     void deserialize(std::istream& savefile);
 
 private:
+    //parse_option: Update the typed copy of an environment string, if the game checks it during play
+    void parse_option(const std::string& key, const std::string& value);
+
     std::map<std::string, std::string> m_environment; //customizable environment strings 
+
+    //Typed copies of the environment strings, kept up to date by set_environment so
+    //the rules checked during play don't need a string lookup.  The initial values
+    //are what an unset string means.
+    bool m_start_replay_paused = false;
+    bool m_hide_replay = false;
+    bool m_show_inventory_menu = true;
+    bool m_dir_key_clears_more = false;
+    bool m_prompt_for_name = true;
+    bool m_narrow_screen = false;
+    bool m_monochrome = false;
+    bool m_use_exp_level_names = true;
+    bool m_show_armor_class = false;
+    bool m_trap_bugfix = true;
+    bool m_room_bugfix = true;
+    bool m_confused_bugfix = true;
+    bool m_hit_plus_bugfix = true;
+    bool m_throws_affect_mimics = false;
+    bool m_act_like_v1_1 = false;
 };
 
 struct GameState
@@ -89,6 +111,10 @@ struct GameState
     bool fast_play() const;
     void set_fast_play(bool enable);
 
+    //Screen output is held back while a run, a travel or a repeated rest or search plays out, and shown once it ends
+    void hold_output();
+    void release_output();
+
     void load_monster_cfg_entry(const std::string& line);
     void set_monster_data(std::string s);
 
@@ -96,6 +122,7 @@ struct GameState
     int next_level();
     int prev_level();
     int max_level();
+    void set_level(int level);
 
     struct LastTurnState
     {
@@ -113,7 +140,8 @@ struct GameState
 
     bool in_smart_run_mode() const;
     bool in_run_cmd() const { return m_running; }
-    void stop_run_cmd() { m_running = false; }
+    bool in_travel_cmd() const { return m_traveling; }
+    void stop_run_cmd() { m_running = false; m_traveling = false; }
     bool stop_at_door() const { return m_stop_at_door; }
     bool first_move() const { return m_first_move; }
 
@@ -123,6 +151,10 @@ struct GameState
     bool m_running = false;       //True if player is running //todo: i really need to understand this one
     bool m_stop_at_door = false;  //Stop running when we pass a door
     bool m_first_move = false;     //First move after setting stop_at_door
+    bool m_traveling = false;      //The run is a travel, which picks the direction of each step itself
+    Coord m_travel_dest = { 0, 0 };
+    std::vector<Coord> m_travel_path; //Squares left to walk, from the destination back to the hero
+    int m_travel_monsters = 0;     //Monsters in view when the last step was taken
 
     int no_food = 0;             //Number of levels without food
     int turns_since_heal = 0;    //Number of turns_since_heal turns
@@ -140,6 +172,7 @@ private:
     bool m_fast_play_enabled = false; //If 'Fast Play' has been enabled
     bool m_in_replay = false;         //If we are currently replaying a saved game
     bool m_show_replay = true;        //If we render the game during a replay
+    bool m_output_held = false;       //If rendering is stopped for a batch of turns
     int m_level_number = 1;           //Which floor of the dungeon we're on
     int m_max_level = 1;              //Maximum floor reached
 
@@ -0,0 +1,46 @@
+@echo off
+rem Turns the item tables in data\*.dat into item_tables.h, so the game doesn't
+rem have to read them every time it starts.  The header is only replaced when a
+rem table changed, so an unchanged one doesn't trigger a rebuild.
+rem
+rem usage: gen_item_tables.bat <data dir> <header>
+setlocal
+set data=%~1
+set out=%~2
+set tmp_out=%out%.tmp
+
+(
+echo //Generated from data\*.dat by gen_item_tables.bat.  Edit the .dat files, not this.
+echo #pragma once
+echo.
+echo struct ItemTableEntry
+echo {
+echo     const char* type;
+echo     const char* name;
+echo     int prob;
+echo     int worth;
+echo };
+) > "%tmp_out%"
+
+for %%t in (scrolls potions rings sticks) do call :table %%t || exit /b 1
+
+fc /b "%tmp_out%" "%out%" > nul 2>&1
+if errorlevel 1 (move /y "%tmp_out%" "%out%" > nul) else (del "%tmp_out%")
+exit /b 0
+
+:table
+if not exist "%data%\%1.dat" (
+    echo gen_item_tables: can't find %data%\%1.dat 1>&2
+    exit /b 1
+)
+>> "%tmp_out%" echo.
+>> "%tmp_out%" echo constexpr ItemTableEntry %1_table[] = {
+for /f "tokens=1-4" %%a in ('findstr /r /v "^[#;]" "%data%\%1.dat"') do call :row %%a %%b %%c %%d
+>> "%tmp_out%" echo };
+exit /b 0
+
+:row
+set name=%2
+set name=%name:_= %
+>> "%tmp_out%" echo     { "%1", "%name%", %3, %4 },
+exit /b 0
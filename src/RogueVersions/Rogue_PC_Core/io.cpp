@@ -438,6 +438,7 @@ int getinfo_impl(char *str, int size)
     bool wason;
     int ret = 1;
 
+    game->release_output();
     retstr = str;
     *str = 0;
     wason = game->screen().cursor(true);
@@ -473,6 +474,7 @@ int getinfo_impl(char *str, int size)
 
 int getinfo(char *str, int size)
 {
+    game->release_output();
     game->screen().cursor(true);
     std::string s = game->input_interface().GetNextString(size-1);
     game->log("input", "GetNextString: " + s);
@@ -486,6 +488,8 @@ int readchar()
 {
     byte ch;
 
+    //whoever is asked for a key has to see the screen first
+    game->release_output();
     if (!game->typeahead.empty()) {
         handle_key_state();
         ch = game->typeahead.back();
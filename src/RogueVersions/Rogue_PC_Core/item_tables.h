@@ -0,0 +1,79 @@
+//Generated from data\*.dat by gen_item_tables.bat.  Edit the .dat files, not this.
+#pragma once
+
+struct ItemTableEntry
+{
+    const char* type;
+    const char* name;
+    int prob;
+    int worth;
+};
+
+constexpr ItemTableEntry scrolls_table[] = {
+    { "S_CONFUSE", "monster confusion", 8, 140 },
+    { "S_MAP", "magic mapping", 5, 150 },
+    { "S_HOLD", "hold monster", 3, 180 },
+    { "S_SLEEP", "sleep", 5, 5 },
+    { "S_ARMOR", "enchant armor", 8, 160 },
+    { "S_IDENT", "identify", 27, 100 },
+    { "S_SCARE", "scare monster", 4, 200 },
+    { "S_GFIND", "food detection", 4, 50 },
+    { "S_TELEP", "teleportation", 7, 165 },
+    { "S_ENCH", "enchant weapon", 10, 150 },
+    { "S_CREATE", "create monster", 5, 75 },
+    { "S_REMOVE", "remove curse", 8, 105 },
+    { "S_AGGR", "aggravate monsters", 4, 20 },
+    { "S_NOP", "blank paper", 1, 5 },
+    { "S_VORPAL", "vorpalize weapon", 1, 300 },
+};
+
+constexpr ItemTableEntry potions_table[] = {
+    { "P_CONFUSE", "confusion", 8, 5 },
+    { "P_PARALYZE", "paralysis", 10, 5 },
+    { "P_POISON", "poison", 8, 5 },
+    { "P_STRENGTH", "gain strength", 15, 150 },
+    { "P_SEEINVIS", "see invisible", 2, 100 },
+    { "P_HEALING", "healing", 15, 130 },
+    { "P_MFIND", "monster detection", 6, 130 },
+    { "P_TFIND", "magic detection", 6, 105 },
+    { "P_RAISE", "raise level", 2, 250 },
+    { "P_XHEAL", "extra healing", 5, 200 },
+    { "P_HASTE", "haste self", 4, 190 },
+    { "P_RESTORE", "restore strength", 14, 130 },
+    { "P_BLIND", "blindness", 4, 5 },
+    { "P_NOP", "thirst quenching", 1, 5 },
+};
+
+constexpr ItemTableEntry rings_table[] = {
+    { "R_PROTECT", "protection", 9, 400 },
+    { "R_ADDSTR", "add strength", 9, 400 },
+    { "R_SUSTSTR", "sustain strength", 5, 280 },
+    { "R_SEARCH", "searching", 10, 420 },
+    { "R_SEEINVIS", "see invisible", 10, 310 },
+    { "R_NOP", "adornment", 1, 10 },
+    { "R_AGGR", "aggravate monster", 10, 10 },
+    { "R_ADDHIT", "dexterity", 8, 440 },
+    { "R_ADDDAM", "increase damage", 8, 400 },
+    { "R_REGEN", "regeneration", 4, 460 },
+    { "R_DIGEST", "slow digestion", 9, 240 },
+    { "R_TELEPORT", "teleportation", 5, 30 },
+    { "R_STEALTH", "stealth", 7, 470 },
+    { "R_SUSTARM", "maintain armor", 5, 380 },
+};
+
+constexpr ItemTableEntry sticks_table[] = {
+    { "WS_LIGHT", "light", 12, 250 },
+    { "WS_HIT", "striking", 9, 75 },
+    { "WS_ELECT", "lightning", 3, 330 },
+    { "WS_FIRE", "fire", 3, 330 },
+    { "WS_COLD", "cold", 3, 330 },
+    { "WS_POLYMORPH", "polymorph", 15, 310 },
+    { "WS_MISSILE", "magic missile", 10, 170 },
+    { "WS_HASTE_M", "haste monster", 9, 5 },
+    { "WS_SLOW_M", "slow monster", 11, 350 },
+    { "WS_DRAIN", "drain life", 9, 300 },
+    { "WS_NOP", "nothing", 1, 5 },
+    { "WS_TELAWAY", "teleport away", 5, 340 },
+    { "WS_TELTO", "teleport to", 5, 50 },
+    { "WS_CANCEL", "cancellation", 5, 280 },
+};
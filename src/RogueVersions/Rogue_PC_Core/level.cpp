@@ -21,11 +21,14 @@
 #include "potion.h"
 #include "monster.h"
 #include "amulet.h"
+#include <level_stats.h>
 
 void Level::clear_level()
 {
     memset(the_level, ' ', (MAXLINES - 3)*MAXCOLS);
     memset(the_flags, F_REAL, (MAXLINES - 3)*MAXCOLS);
+    room_map_stale = true;
+    distance_maps.invalidate();
 }
 
 int INDEX(Coord p)
@@ -61,7 +64,10 @@ byte Level::get_tile_or_monster(Coord p, bool mimic_as_monster)
 
 void Level::set_tile(Coord p, byte c)
 {
-    the_level[INDEX(p)] = c;
+    byte& tile = the_level[INDEX(p)];
+    if (tile != c)
+        distance_maps.invalidate();
+    tile = c;
 }
 
 byte Level::get_flags(Coord p)
@@ -71,16 +77,24 @@ byte Level::get_flags(Coord p)
 
 void Level::set_flag(Coord p, byte f)
 {
+    if (f & F_SEEN & ~the_flags[INDEX(p)])
+        distance_maps.invalidate();
     the_flags[INDEX(p)] |= f;
+    if (f & (F_PASS | F_PNUM))
+        room_map_stale = true;
 }
 
 void Level::unset_flag(Coord p, byte f)
 {
     the_flags[INDEX(p)] &= ~f;
+    if (f & (F_PASS | F_PNUM))
+        room_map_stale = true;
 }
 
 void Level::copy_flags(Coord p, byte f)
 {
+    if ((the_flags[INDEX(p)] ^ f) & (F_PASS | F_PNUM))
+        room_map_stale = true;
     the_flags[INDEX(p)] = f;
 }
 
@@ -94,6 +108,29 @@ bool Level::is_maze(Coord p)
     return (get_flags(p) & F_MAZE) != 0;
 }
 
+bool Level::is_seen(Coord p)
+{
+    return (get_flags(p) & F_SEEN) != 0;
+}
+
+bool Level::is_known_walkable(Coord p)
+{
+    if (!is_seen(p))
+        return false;
+    byte ch = get_tile(p);
+    return step_ok(ch) && ch != TRAP;
+}
+
+int Level::distance_to(int field, Coord p)
+{
+    return distance_maps.get(*this, field)[p.y * MAXCOLS + p.x];
+}
+
+const short* Level::distance_field(int field)
+{
+    return distance_maps.get(*this, field);
+}
+
 bool Level::is_real(Coord p)
 {
     return (get_flags(p) & F_REAL) != 0;
@@ -104,6 +141,33 @@ int Level::get_passage_num(Coord p)
     return get_flags(p) & F_PNUM;
 }
 
+//get_room_from_position: Find what room some coordinates are in. NULL means they aren't in any room.
+Room* Level::get_room_from_position(Coord pos)
+{
+    int i = INDEX(pos);
+    if (i < 0 || i >= (MAXLINES - 3)*MAXCOLS)
+        return find_room(pos);
+
+    if (room_map_stale) {
+        memset(the_room_map, 0, sizeof(the_room_map));
+        room_map_stale = false;
+    }
+
+    //only answers are remembered, so being nowhere is still noticed every time
+    if (the_room_map[i]) {
+        if (the_room_map[i] <= MAXROOMS)
+            return &rooms[the_room_map[i] - 1];
+        return &passages[the_room_map[i] - MAXROOMS - 1];
+    }
+
+    Room* room = find_room(pos);
+    if (room >= rooms && room < rooms + MAXROOMS)
+        the_room_map[i] = (byte)(room - rooms + 1);
+    else if (room)
+        the_room_map[i] = (byte)(room - passages + MAXROOMS + 1);
+    return room;
+}
+
 int Level::get_trap_type(Coord p)
 {
     return get_flags(p) & F_TMASK;
@@ -147,6 +211,39 @@ Room * Level::get_passage(Coord pos)
     return &passages[get_passage_num(pos)];
 }
 
+int Level::nearest_exit(Room* room, Coord dest, Coord* exit_pos)
+{
+    ExitMemo* memo;
+    if (room >= rooms && room < rooms + MAXROOMS)
+        memo = &exit_memo[room - rooms];
+    else
+        memo = &exit_memo[MAXROOMS + (room - passages)];
+
+    if (memo->turn != exit_turn || memo->dest != dest) {
+        memo->turn = exit_turn;
+        memo->dest = dest;
+        memo->exit = -1;
+        memo->dist = 32767;
+        for (int i = 0; i < room->m_num_exits; i++)
+        {
+            int dist = distance(dest, room->m_exits[i]);
+            if (dist < memo->dist) {
+                memo->exit = i;
+                memo->dist = dist;
+            }
+        }
+    }
+
+    if (memo->exit >= 0)
+        *exit_pos = room->m_exits[memo->exit];
+    return memo->dist;
+}
+
+void Level::forget_exits()
+{
+    ++exit_turn;
+}
+
 //monster_at: returns pointer to monster at coordinate. if no monster there return NULL
 Monster* Level::monster_at(Coord p, bool include_disguised)
 {
@@ -216,8 +313,10 @@ void Level::show_map(bool reveal_interior)
                 if (game->screen().curch() != DOOR)
                     game->screen().standout();
             }
-            if (ch != ' ')
+            if (ch != ' ') {
                 game->screen().add_tile(p, ch);
+                set_flag(p, F_SEEN);
+            }
             game->screen().standend();
         }
     }
@@ -242,6 +341,7 @@ void Level::new_level(int do_implode)
 
     //Clean things off from last level
     clear_level();
+    forget_exits();
 
     //Free up the monsters on the last level
     for (auto it = monsters.begin(); it != monsters.end(); ++it) {
@@ -257,6 +357,7 @@ void Level::new_level(int do_implode)
     game->log("level", ss.str());
 
     do_rooms(); //Draw rooms
+    room_map_stale = true;
 
     if (do_implode) {
         if (!game->options.act_like_v1_1())
@@ -359,6 +460,21 @@ void Level::put_things()
     }
 }
 
+//room_is_full: See if every spot in a room already has something on it.  A small room that
+//already holds the gold and the amulet doesn't always have space for all of a treasure room's
+//treasure, and looking for a spot would never end.
+bool room_is_full(Level& level, Room* room)
+{
+    for (int y = 1; y < room->m_size.y - 1; y++) {
+        for (int x = 1; x < room->m_size.x - 1; x++) {
+            Coord p = { room->m_ul_corner.x + x, room->m_ul_corner.y + y };
+            if (isfloor(level.get_tile(p)))
+                return false;
+        }
+    }
+    return true;
+}
+
 //treas_room: Add a treasure room
 void Level::treas_room()
 {
@@ -373,7 +489,7 @@ void Level::treas_room()
     spots = (room->m_size.y - 2)*(room->m_size.x - 2) - MINTREAS;
     if (spots > (MAXTREAS - MINTREAS)) spots = (MAXTREAS - MINTREAS);
     num_monst = nm = rnd(spots) + MINTREAS;
-    while (nm--)
+    while (nm-- && !room_is_full(*this, room))
     {
         do {
             rnd_pos(room, &pos);
@@ -473,6 +589,69 @@ bool Level::has_monsters() const
     return !monsters.empty();
 }
 
+void Level::get_stats(LevelStats* stats)
+{
+    char walkable[MAXLINES*MAXCOLS] = {};
+    Coord stairs = game->hero().position();
+
+    for (int i = 0; i < MAXROOMS; ++i) {
+        Room* room = &rooms[i];
+        if (room->is_gone())
+            ++stats->gone_rooms;
+        else
+            ++stats->rooms;
+        if (room->is_maze())
+            ++stats->maze_rooms;
+        else if (room->is_dark() && !room->is_gone())
+            ++stats->dark_rooms;
+    }
+    stats->monsters = (int)monsters.size();
+    for (auto it = items.begin(); it != items.end(); ++it) {
+        switch ((*it)->m_type)
+        {
+        case GOLD: ++stats->items[STAT_GOLD]; break;
+        case POTION: ++stats->items[STAT_POTION]; break;
+        case SCROLL: ++stats->items[STAT_SCROLL]; break;
+        case FOOD: ++stats->items[STAT_FOOD]; break;
+        case WEAPON: ++stats->items[STAT_WEAPON]; break;
+        case ARMOR: ++stats->items[STAT_ARMOR]; break;
+        case RING: ++stats->items[STAT_RING]; break;
+        case STICK: ++stats->items[STAT_STICK]; break;
+        case AMULET: ++stats->items[STAT_AMULET]; break;
+        }
+    }
+
+    const int COLS = game->screen().columns();
+    const int ROWS = maxrow();
+    for (int y = 1; y < ROWS; y++) {
+        for (int x = 0; x < COLS; x++) {
+            Coord p = { x, y };
+            byte ch = get_tile(p);
+            switch (ch)
+            {
+            case VWALL: case HWALL: case ULWALL: case URWALL: case LLWALL: case LRWALL:
+                if (!is_real(p))
+                    ++stats->secret_doors;
+                break;
+            case DOOR:
+                ++stats->doors;
+                break;
+            case STAIRS:
+                stairs = p;
+                break;
+            default:
+                //traps aren't kept anywhere but in the flags
+                if (isfloor(ch) && !is_real(p))
+                    ++stats->traps;
+            }
+            //secret doors look like walls, so they aren't walkable until they're found
+            walkable[y*COLS + x] = step_ok(ch);
+        }
+    }
+    Coord hero = game->hero().position();
+    level_stair_distance(walkable, ROWS, COLS, hero.y, hero.x, stairs.y, stairs.x, stats);
+}
+
 int rnd_gold()
 {
     return (rnd(50 + 10 * game->get_level()) + 2);
@@ -2,10 +2,12 @@
 #include "rogue.h"
 #include <coord.h>
 #include "room.h"
+#include "distance_maps.h"
 
 struct Room;
 struct Item;
 struct Monster;
+struct LevelStats;
 
 //Flags for level map
 #define F_PASS   0x040 //is a passageway
@@ -13,6 +15,7 @@ struct Monster;
 #define F_REAL   0x010 //the level tile is actual (not set for secret doors or traps)
 #define F_PNUM   0x00f //passage number mask
 #define F_TMASK  0x007 //trap number mask
+#define F_SEEN   0x080 //the hero has seen this square, so travel can plan through it
 
 struct Level {
     Level();
@@ -43,6 +46,16 @@ struct Level {
     bool is_passage(Coord p);
     bool is_maze(Coord p);
     bool is_real(Coord p);
+    bool is_seen(Coord p);
+
+    //is_known_walkable: Check if the hero has seen a square and knows it can be walked on without springing a trap
+    bool is_known_walkable(Coord p);
+
+    //distance_to: Moves from p to the nearest square of a DIST_ field over known walkable squares, -1 if there's no known way
+    int distance_to(int field, Coord p);
+
+    //distance_field: All of a DIST_ field, MAXLINES rows of MAXCOLS squares laid out like the screen
+    const short* distance_field(int field);
     int get_passage_num(Coord p);
     int get_trap_type(Coord p);
 
@@ -52,6 +65,13 @@ struct Level {
 
     Room* get_passage(Coord pos);
 
+    //nearest_exit: Find the exit of a room nearest to a destination.  Returns its distance, or 32767 if the room has no exits.
+    //Answers are remembered until forget_exits is called.
+    int nearest_exit(Room* room, Coord dest, Coord* exit_pos);
+
+    //forget_exits: Start a new turn of nearest_exit answers
+    void forget_exits();
+
     //monster_at: returns pointer to monster at coordinate. if no monster there return NULL
     Monster* monster_at(Coord p, bool include_disguised =true); //todo: remove default
 
@@ -75,12 +95,20 @@ struct Level {
 
     Room* rnd_room();
 
+    //get_stats: Summarize the level for level generation sweeps
+    void get_stats(LevelStats* stats);
+
     std::list<Item*> items; //List of objects on this level
     std::list<Monster*> monsters; //List of monsters on the level
 private:
     byte the_level[(MAXLINES - 3)*MAXCOLS];
     byte the_flags[(MAXLINES - 3)*MAXCOLS];
 
+    //The room or passage at each position, plus one, filled in as positions are
+    //asked about.  Rooms and passages only change while a level is being made.
+    byte the_room_map[(MAXLINES - 3)*MAXCOLS];
+    bool room_map_stale = true;
+
     Room rooms[MAXROOMS]; //One for each room -- A level
     Room passages[MAXPASS] =
     {
@@ -98,6 +126,18 @@ private:
         { 11,{ 0, 0 },{ 0, 0 },{ 0, 0 }, 0, IS_GONE | IS_DARK, 0, 0 }
     };
 
+    //The nearest exit of each room and passage found this turn
+    struct ExitMemo {
+        Coord dest;
+        int exit;
+        int dist;
+        int turn;
+    };
+    ExitMemo exit_memo[MAXROOMS + MAXPASS] = {};
+    int exit_turn = 1;
+
+    DistanceMaps distance_maps;
+
     //conn: Draw a corridor from a room in a certain direction.
     void Level::conn(int r1, int r2);
 
@@ -108,6 +148,9 @@ private:
     void numpass(Coord p);
 
     void psplat(Coord p);
+
+    //find_room: The slow search behind get_room_from_position
+    Room* find_room(Coord pos);
 };
 
 int rnd_gold();
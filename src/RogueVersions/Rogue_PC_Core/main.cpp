@@ -19,8 +19,12 @@
 #include <ctime>
 #include <cstdio>
 #include <cstdarg>
+#include <cstring>
 
 #include <display_interface.h>
+#include <level_stats.h>
+#include <agent_state.h>
+#include <distance_map.h>
 #include "random.h"
 #include "game_state.h"
 #include "main.h"
@@ -45,6 +49,7 @@
 #include "rooms.h"
 #include "input_interface_ex.h"
 #include "mach_dep.h"
+#include "item.h"
 
 int get_seed()
 {
@@ -304,6 +309,113 @@ int game_main(int argc, char **argv, std::shared_ptr<OutputInterface> output, st
     return 0;
 }
 
+//With no player attached there is nobody to answer a --More--, so just get past it
+struct SweepInput : public InputInterfaceEx
+{
+    virtual bool HasMoreInput() override { return true; }
+    virtual char GetNextChar(bool *is_replay) override { return ' '; }
+    virtual std::string GetNextString(int size) override { return ""; }
+    virtual void Serialize(std::ostream& out) override {}
+};
+
+//sweep_main: Generate levels without playing them, for dungeon statistics
+int sweep_main(int first_seed, int count, int depth, LevelStats* stats, std::shared_ptr<OutputInterface> output)
+{
+    //The item tables are loaded once, so unlike the Unix versions a seed here
+    //only fixes the level, not the level you'd get playing with that SEED.
+    if (!game) {
+        g_random = new Random(first_seed);
+        game = new GameState(first_seed, output, std::shared_ptr<InputInterfaceEx>(new SweepInput));
+        setup_screen();
+        init_things();
+    }
+
+    for (LevelStats* s = stats; s < stats + count; ++s) {
+        memset(s, 0, sizeof(*s));
+        s->seed = first_seed + int(s - stats);
+        s->depth = depth;
+
+        g_random->set_seed(s->seed);
+        game->CreateHero(game->options.get_environment("name"));
+        extinguish(unconfuse); //a medusa in the first room may have confused the last hero
+        game->set_level(depth);
+        game->no_food = 0;
+        game->screen().clear();
+        game->level().new_level(false);
+        game->level().get_stats(s);
+    }
+    return count;
+}
+
+//describe_game: Fill in the hero's stats, depth, and pack for a program playing the game
+void describe_game(AgentState* state)
+{
+    memset(state, 0, sizeof(*state));
+    if (!game)
+        return;
+
+    Hero& hero = game->hero();
+    state->str = hero.calculate_strength();
+    state->max_str = hero.calculate_max_strength();
+    state->exp = hero.experience();
+    state->level = hero.m_stats.m_level;
+    state->ac = hero.calculate_armor();
+    state->hp = hero.get_hp();
+    state->hp_max = hero.m_stats.m_max_hp;
+    strncpy(state->damage, hero.m_stats.m_damage.c_str(), sizeof(state->damage) - 1);
+    state->depth = game->get_level();
+    state->gold = hero.get_purse();
+
+    char letter = 'a';
+    for (auto it = hero.m_pack.begin(); it != hero.m_pack.end() && state->item_count < AGENT_PACK_SIZE; ++it) {
+        Item* obj = *it;
+        AgentItem& item = state->items[state->item_count++];
+        item.letter = letter++;
+        switch (obj->m_type)
+        {
+        case GOLD: item.kind = STAT_GOLD; break;
+        case POTION: item.kind = STAT_POTION; break;
+        case SCROLL: item.kind = STAT_SCROLL; break;
+        case FOOD: item.kind = STAT_FOOD; break;
+        case WEAPON: item.kind = STAT_WEAPON; break;
+        case ARMOR: item.kind = STAT_ARMOR; break;
+        case RING: item.kind = STAT_RING; break;
+        case STICK: item.kind = STAT_STICK; break;
+        case AMULET: item.kind = STAT_AMULET; break;
+        default: item.kind = -1; break;
+        }
+        item.count = obj->m_count;
+        strncpy(item.name, obj->inventory_name(hero, false).c_str(), sizeof(item.name) - 1);
+    }
+}
+
+//describe_distances: Fill in a DIST_ field, laid out like the screen, for a program playing the game
+int describe_distances(int field, int* distances, int lines, int cols)
+{
+    if (!game || field < 0 || field >= DIST_NUM_FIELDS)
+        return -1;
+
+    const short* dist = game->level().distance_field(field);
+    for (int y = 0; y < lines; ++y) {
+        for (int x = 0; x < cols; ++x)
+            distances[y * cols + x] = (y < MAXLINES && x < MAXCOLS) ? dist[y * MAXCOLS + x] : -1;
+    }
+    return 0;
+}
+
+//random_draws: How many random numbers the game has drawn
+unsigned int random_draws()
+{
+    return g_random ? g_random->get_draws() : 0;
+}
+
+//reseed_main: Start the random numbers over, so copies of one game can each play out a different future
+void reseed_main(unsigned int seed)
+{
+    if (g_random)
+        g_random->set_seed(int(seed));
+}
+
 //do_quit: Have player make certain, then exit.
 bool do_quit()
 {
@@ -2,6 +2,8 @@
 
 struct OutputInterface;
 struct InputInterfaceEx;
+struct LevelStats;
+struct AgentState;
 
 //do_quit: Have player make certain, then exit.
 bool do_quit();
@@ -14,3 +16,18 @@ void fatal(char *msg, ...);
 
 //game_main: The main program, of course
 int game_main(int argc, char **argv, std::shared_ptr<OutputInterface> output, std::shared_ptr<InputInterfaceEx> input);
+
+//sweep_main: Generate levels without playing them, for dungeon statistics
+int sweep_main(int first_seed, int count, int depth, LevelStats* stats, std::shared_ptr<OutputInterface> output);
+
+//describe_game: Fill in the hero's stats, depth, and pack for a program playing the game
+void describe_game(AgentState* state);
+
+//describe_distances: Fill in a DIST_ field, laid out like the screen, for a program playing the game
+int describe_distances(int field, int* distances, int lines, int cols);
+
+//random_draws: How many random numbers the game has drawn
+unsigned int random_draws();
+
+//reseed_main: Start the random numbers over, so copies of one game can each play out a different future
+void reseed_main(unsigned int seed);
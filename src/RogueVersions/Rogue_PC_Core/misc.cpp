@@ -151,6 +151,7 @@ void reveal_position(const Coord pos, const bool wakeup, int* passcount)
         game->screen().standout();
     game->screen().add_tile(pos, tile);
     game->screen().standend();
+    game->level().set_flag(pos, F_SEEN);
 
     // determine whether we need to stop a running player
     if (game->in_smart_run_mode()) 
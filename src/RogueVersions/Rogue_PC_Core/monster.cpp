@@ -273,14 +273,12 @@ Monster* Monster::do_chase() //todo: understand
         //run to the door nearest to our goal.
         if (monster_room != destination_room && (monster_room->is_maze()) == 0)
         {
-            //loop through doors
-            for (int i = 0; i < monster_room->m_num_exits; i++)
-            {
-                dist = distance(*m_destination, monster_room->m_exits[i]);
-                if (dist < mindist) {
-                    tempdest = monster_room->m_exits[i];
-                    mindist = dist;
-                }
+            //head for the door nearest the goal
+            Coord exit_pos;
+            dist = game->level().nearest_exit(monster_room, *m_destination, &exit_pos);
+            if (dist < mindist) {
+                tempdest = exit_pos;
+                mindist = dist;
             }
             if (door)
             {
@@ -1,5 +1,7 @@
 //Hero movement commands
 //move.c      1.4 (A.I. Design)       12/22/84
+#include <algorithm>
+#include <vector>
 #include <ctype.h>
 
 #include "random.h"
@@ -128,7 +130,7 @@ bool this_move_counts; //todo: remove
 
 bool do_hit_boundary()
 {
-    if (game->in_run_cmd() && is_gone(game->hero().room()) && !game->hero().is_blind())
+    if (game->in_run_cmd() && !game->in_travel_cmd() && is_gone(game->hero().room()) && !game->hero().is_blind())
     {
         switch (game->run_character)
         {
@@ -180,7 +182,8 @@ bool do_move_impl(bool can_pickup, bool confused_move)
 
     ch = game->level().get_tile_or_monster(new_position);
     //When the hero is on the door do not allow him to run until he enters the room all the way
-    if ((game->level().get_tile(game->hero().position()) == DOOR) && (ch == FLOOR))
+    //A travel has planned its way through the door, so it keeps going.
+    if ((game->level().get_tile(game->hero().position()) == DOOR) && (ch == FLOOR) && !game->in_travel_cmd())
         game->stop_run_cmd();
     if (!(is_real) && ch == FLOOR) {
         ch = TRAP;
@@ -201,7 +204,8 @@ bool do_move_impl(bool can_pickup, bool confused_move)
         return !do_hit_boundary();
 
     case DOOR:
-        game->stop_run_cmd();
+        if (!game->in_travel_cmd())
+            game->stop_run_cmd();
         if (game->level().is_passage(game->hero().position()))
             enter_room(new_position);
         finish_do_move(is_passage, is_maze);
@@ -282,6 +286,172 @@ bool do_move(Command c) //todo:understand
 }
 
 
+namespace
+{
+    //plan_travel: Find the shortest way from the hero to dest over the squares the hero knows can be
+    //walked on, by walking down the DIST_HERO field from dest.  The path runs from dest back to the
+    //hero's position, and is empty if there's no known way.
+    std::vector<Coord> plan_travel(Coord dest)
+    {
+        std::vector<Coord> path;
+        if (offmap(dest) || game->level().distance_to(DIST_HERO, dest) < 0)
+            return path;
+
+        const short* dist = game->level().distance_field(DIST_HERO);
+        Coord p = dest;
+        path.push_back(p);
+        while (dist[p.y * MAXCOLS + p.x] > 0)
+        {
+            //any square one move closer that the game lets us step from will do
+            short closer = dist[p.y * MAXCOLS + p.x] - 1;
+            Coord next = p;
+            for (int dy = -1; dy <= 1 && next == p; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    Coord n = { p.x + dx, p.y + dy };
+                    if (!offmap(n) && dist[n.y * MAXCOLS + n.x] == closer && diag_ok(n, p)) {
+                        next = n;
+                        break;
+                    }
+                }
+            }
+            if (next == p)
+                return std::vector<Coord>();
+            p = next;
+            path.push_back(p);
+        }
+        return path;
+    }
+
+    //find_stairs: Find the stairs, if the hero has seen them
+    bool find_stairs(Coord* pos)
+    {
+        const int COLS = game->screen().columns();
+        for (int y = 1; y < maxrow(); y++) {
+            for (int x = 0; x < COLS; x++) {
+                Coord p = { x, y };
+                if (game->level().get_tile(p) == STAIRS && game->level().is_seen(p)) {
+                    *pos = p;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    //pick_travel_dest: Ask where to travel.  > or < picks the stairs.  Otherwise the direction
+    //keys move the cursor, shifted ones 8 squares at a time, and . or Enter picks the square under it.
+    bool pick_travel_dest(Coord* dest)
+    {
+        const int COLS = game->screen().columns();
+        Coord pos = game->hero().position();
+        byte ch;
+
+        msg("travel where? ");
+        bool was_on = game->screen().cursor(true);
+        for (;;)
+        {
+            game->screen().move(pos.y, pos.x);
+            ch = readchar();
+            Coord delta;
+            if (ch == ESCAPE || ch == '>' || ch == '<' || ch == '.' || ch == '\r' || ch == '\n')
+                break;
+            if (find_dir(ch, &delta)) {
+                int n = isupper(ch) ? 8 : 1;
+                pos.x = std::min(std::max(pos.x + delta.x * n, 0), COLS - 1);
+                pos.y = std::min(std::max(pos.y + delta.y * n, 1), maxrow() - 1);
+            }
+        }
+        game->screen().cursor(was_on);
+        msg("");
+
+        if (ch == ESCAPE)
+            return false;
+        if ((ch == '>' || ch == '<') && !find_stairs(&pos)) {
+            msg("you haven't found the stairs");
+            return false;
+        }
+        *dest = pos;
+        return true;
+    }
+
+    //visible_monsters: Count the monsters the hero can see for what they are
+    int visible_monsters()
+    {
+        int count = 0;
+        for (auto m : game->level().monsters) {
+            if (!m->is_disguised() && game->hero().can_see_monster(m))
+                ++count;
+        }
+        return count;
+    }
+
+    //dir_char: The movement key for a step of delta
+    char dir_char(Coord delta)
+    {
+        static const char keys[3][4] = { "yku", "h l", "bjn" };
+        return keys[delta.y + 1][delta.x + 1];
+    }
+}
+
+//do_travel: Start the hero travelling to the stairs or a square picked on the map
+bool do_travel()
+{
+    Coord dest;
+    if (!pick_travel_dest(&dest) || dest == game->hero().position())
+        return false;
+
+    std::vector<Coord> path = plan_travel(dest);
+    if (path.empty()) {
+        msg("you don't know a way there");
+        return false;
+    }
+
+    //a travel is a run that steers itself, so everything that interrupts a run stops it too
+    game->m_running = true;
+    game->m_traveling = true;
+    game->m_stop_at_door = false;
+    game->m_travel_dest = dest;
+    game->m_travel_path = std::move(path);
+    game->m_travel_monsters = visible_monsters();
+    return false;
+}
+
+//continue_travel: Point the run at the next square of the travel path
+void continue_travel()
+{
+    std::vector<Coord>& path = game->m_travel_path;
+    Coord pos = game->hero().position();
+
+    //the last step landed where it was meant to
+    if (path.size() >= 2 && path[path.size() - 2] == pos)
+        path.pop_back();
+    if (pos == game->m_travel_dest) {
+        game->stop_run_cmd();
+        return;
+    }
+
+    //plan again if something moved the hero off the path, or what's ahead turned out to be a trap
+    if (path.back() != pos || !game->level().is_known_walkable(path[path.size() - 2]))
+        path = plan_travel(game->m_travel_dest);
+    if (path.size() < 2) {
+        game->stop_run_cmd();
+        return;
+    }
+
+    //stop for anything new coming into view, and never walk into a monster
+    Coord next = path[path.size() - 2];
+    Monster* monster = game->level().monster_at(next, false);
+    int monsters = visible_monsters();
+    if (monsters > game->m_travel_monsters || (monster && game->hero().can_see_monster(monster))) {
+        game->stop_run_cmd();
+        return;
+    }
+    game->m_travel_monsters = monsters;
+
+    Coord delta = { next.x - pos.x, next.y - pos.y };
+    game->run_character = dir_char(delta);
+}
+
 //door_open: Called to illuminate a room.  If it is dark, remove anything that might move.
 void door_open(Room *room)
 {
@@ -11,6 +11,13 @@ int diag_ok(const Coord sp, const Coord ep);
 //do_run: Start the hero running
 bool do_run(Command c);
 
+//do_travel: Start the hero travelling to the stairs or a square picked on the map
+bool do_travel();
+
+//continue_travel: Point the run at the next square of the travel path, planning it again if the
+//hero has been moved off it.  Ends the travel on arrival or when there's no known way on.
+void continue_travel();
+
 //do_move: Check to see that a move is legal.  If it is handle the consequences (fighting, picking up, etc.)
 bool do_move(Command c);
 
@@ -18,6 +18,11 @@ int Random::get_seed() const
     return seed;
 }
 
+unsigned int Random::get_draws() const
+{
+    return draws;
+}
+
 //rnd: Pick a very random number.
 int Random::rnd(int range)
 {
@@ -27,6 +32,7 @@ int Random::rnd(int range)
 //Random number generator - adapted from the FORTRAN version in "Software Manual for the Elementary Functions" by W.J. Cody, Jr and William Waite.
 long Random::ran()
 {
+    ++draws;
     seed *= 125;
     seed -= (seed / 2796203) * 2796203;
     return seed;
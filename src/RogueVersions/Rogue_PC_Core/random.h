@@ -7,6 +7,9 @@ struct Random
     void set_seed(int s);
     int get_seed() const;
 
+    //get_draws: How many numbers have been drawn, so two builds can be checked against each other
+    unsigned int get_draws() const;
+
     //rnd: Pick a very random number.
     int rnd(int range);
 
@@ -15,6 +18,7 @@ private:
     long ran();
 
     int seed;
+    unsigned int draws = 0;
 };
 
 //rnd: Pick a very random number.
@@ -8,6 +8,7 @@
 #include <fcntl.h>
 #include <time.h>
 #include <sys/stat.h>
+#include <agent_state.h>
 #include "random.h"
 #include "game_state.h"
 #include "rip.h"
@@ -28,6 +29,7 @@
 #define TOPSCORES 10
 
 static int sc_fd;
+static GameEnd s_game_end = { -1, 0, 0 };
 
 struct LeaderboardEntry
 {
@@ -54,6 +56,15 @@ int get_year()
     return timeinfo->tm_year + 1900;
 }
 
+//describe_ending: Fill in how the game ended for a program playing it, or return false while it's still going
+bool describe_ending(GameEnd* end)
+{
+    if (s_game_end.flags < 0)
+        return false;
+    *end = s_game_end;
+    return true;
+}
+
 //score: Figure score and post it.
 void score(int amount, int flags, char monst)
 {
@@ -65,6 +76,10 @@ void score(int amount, int flags, char monst)
 
     if (amount || flags || monst)
     {
+        s_game_end.flags = flags;
+        s_game_end.monster = flags == 0 ? monst : 0;
+        s_game_end.score = amount;
+
         std::string filename = game->options.get_environment("autosave_pc");
         if(!filename.empty())
             game->save_game(filename);
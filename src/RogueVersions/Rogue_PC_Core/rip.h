@@ -1,3 +1,5 @@
+struct GameEnd;
+
 void score(int amount, int flags, char monst);
 
 //death: Do something really fun when he dies
@@ -8,3 +10,6 @@ void total_winner();
 
 //killname: Convert a code to a monster name
 char *killname(char monst, bool doart);
+
+//describe_ending: Fill in how the game ended for a program playing it, or return false while it's still going
+bool describe_ending(GameEnd* end);
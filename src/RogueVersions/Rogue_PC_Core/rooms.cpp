@@ -194,6 +194,7 @@ void enter_room(Coord cp)
             for (x = room->m_ul_corner.x; x < room->m_size.x + room->m_ul_corner.x; x++)
             {
                 Coord pos = { x, y };
+                game->level().set_flag(pos, F_SEEN);
                 //Displaying monsters is all handled in the chase code now
                 monster = game->level().monster_at(pos);
                 if (monster == NULL || !game->hero().can_see_monster(monster))
@@ -257,8 +258,8 @@ void leave_room(Coord cp)
     door_open(room);
 }
 
-//get_room_from_position: Find what room some coordinates are in. NULL means they aren't in any room.
-Room* Level::get_room_from_position(Coord pos)
+//find_room: The slow search behind get_room_from_position
+Room* Level::find_room(Coord pos)
 {
     struct Room *room;
 
@@ -175,7 +175,7 @@ private:
     int m_attr = 0x7;
     bool m_cursor = false;
     bool m_curtain_down = false;
-    bool m_should_render = true;
+    int m_render_stops = 0; //stop_rendering calls that haven't been resumed yet
 
     struct Data
     {
@@ -604,12 +604,13 @@ int ScreenOutput::columns() const
 
 void ScreenOutput::stop_rendering()
 {
-    m_should_render = false;
+    ++m_render_stops;
 }
 
 void ScreenOutput::resume_rendering()
 {
-    m_should_render = true;
+    if (m_render_stops > 0 && --m_render_stops > 0)
+        return;
     ApplyMove();
     Render();
     ApplyCursor();
@@ -621,7 +622,7 @@ void ScreenOutput::play_sound(const char * id)
 
 void ScreenOutput::Render()
 {
-    if (!m_should_render || m_curtain_down)
+    if (m_render_stops > 0 || m_curtain_down)
         return;
 
     m_screen->UpdateRegion(m_data.buffer);
@@ -629,7 +630,7 @@ void ScreenOutput::Render()
 
 void ScreenOutput::Render(Region rect)
 {
-    if (!m_should_render || m_curtain_down)
+    if (m_render_stops > 0 || m_curtain_down)
         return;
 
     m_screen->UpdateRegion(m_data.buffer, rect);
@@ -637,7 +638,7 @@ void ScreenOutput::Render(Region rect)
 
 void ScreenOutput::ApplyMove()
 {
-    if (!m_should_render || m_curtain_down)
+    if (m_render_stops > 0 || m_curtain_down)
         return;
 
     m_screen->MoveCursor({ m_col, m_row });
@@ -645,7 +646,7 @@ void ScreenOutput::ApplyMove()
 
 void ScreenOutput::ApplyCursor()
 {
-    if (!m_should_render || m_curtain_down)
+    if (m_render_stops > 0 || m_curtain_down)
         return;
 
     m_screen->SetCursor(m_cursor);
@@ -26,6 +26,7 @@
 #include "level.h"
 #include "food.h"
 #include "hero.h"
+#include "item_tables.h"
 
 template<typename T>
 Item* createInstance() { return new T; }
@@ -60,7 +61,10 @@ struct vector_entry
 
 struct ItemFactory
 {
-    void LoadItems(const std::string & filename);
+    //Uses the table compiled in from data\*.dat unless a file is given
+    template <size_t N>
+    void LoadItems(const std::string& filename, const ItemTableEntry (&table)[N]) { LoadItems(filename, table, N); }
+    void LoadItems(const std::string& filename, const ItemTableEntry* table, size_t count);
 
     Item* Create();
     Item* Summon(int i);
@@ -74,6 +78,7 @@ protected:
 
 private:
     void LoadItem(const std::string& line, int* probability);
+    void AddItem(const std::string& type, const std::string& name, int prob, int worth, int* probability);
 
     virtual std::string GetIdentifier(int* worth) = 0;
     virtual std::string GetKind() { return std::string(); }
@@ -137,19 +142,22 @@ void ItemFactory::LoadItem(const std::string& line, int* probability)
 
     std::istringstream ss(line);
 
-    std::string type;
-    ss >> type;
-    auto i = m_types.find(type);
-    if (i == m_types.end())
-        throw std::runtime_error("Unknown type: " + type);
-
-    std::string name;
+    std::string type, name;
     int prob, worth;
-    ss >> name >> prob >> worth;
+    ss >> type >> name >> prob >> worth;
     if (!ss)
         throw std::runtime_error("Error reading: " + line);
 
     std::replace(name.begin(), name.end(), '_', ' ');
+    AddItem(type, name, prob, worth, probability);
+}
+
+void ItemFactory::AddItem(const std::string& type, const std::string& name, int prob, int worth, int* probability)
+{
+    auto i = m_types.find(type);
+    if (i == m_types.end())
+        throw std::runtime_error("Unknown type: " + type);
+
     *probability += prob;
     std::string id = GetIdentifier(&worth);
     std::string kind = GetKind();
@@ -159,20 +167,24 @@ void ItemFactory::LoadItem(const std::string& line, int* probability)
     m_items.push_back(e);
 }
 
-void ItemFactory::LoadItems(const std::string & filename)
+void ItemFactory::LoadItems(const std::string& filename, const ItemTableEntry* table, size_t count)
 {
     int probability = 0;
 
-    if (filename.empty())
-        throw std::runtime_error("No scroll file provided");
-
-    std::ifstream file(filename);
-    if (!file)
-        throw std::runtime_error("Error opening: " + filename);
+    if (filename.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            AddItem(table[i].type, table[i].name, table[i].prob, table[i].worth, &probability);
+        }
+    }
+    else {
+        std::ifstream file(filename);
+        if (!file)
+            throw std::runtime_error("Error opening: " + filename);
 
-    std::string line;
-    while (std::getline(file, line)) {
-        LoadItem(line, &probability);
+        std::string line;
+        while (std::getline(file, line)) {
+            LoadItem(line, &probability);
+        }
     }
 
     if (probability != 100)
@@ -214,7 +226,7 @@ ScrollFactory s_scrolls;
 
 void LoadScrolls(const std::string & filename)
 {
-    s_scrolls.LoadItems(filename);
+    s_scrolls.LoadItems(filename, scrolls_table);
 }
 
 void PrintScrollDiscoveries()
@@ -315,7 +327,7 @@ PotionFactory s_potions;
 
 void LoadPotions(const std::string & filename)
 {
-    s_potions.LoadItems(filename);
+    s_potions.LoadItems(filename, potions_table);
 }
 
 void PrintPotionDiscoveries()
@@ -475,7 +487,7 @@ StickFactory s_sticks;
 
 void LoadSticks(const std::string & filename)
 {
-    s_sticks.LoadItems(filename);
+    s_sticks.LoadItems(filename, sticks_table);
 }
 
 void PrintStickDiscoveries()
@@ -575,7 +587,7 @@ RingFactory s_rings;
 
 void LoadRings(const std::string & filename)
 {
-    s_rings.LoadItems(filename);
+    s_rings.LoadItems(filename, rings_table);
 }
 
 void PrintRingDiscoveries()
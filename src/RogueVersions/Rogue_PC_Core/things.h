@@ -26,6 +26,7 @@ Item* CreateRing();
 Item* SummonRing(int i);
 int NumRingTypes();
 
+//An empty filename loads the table compiled in from data\*.dat
 void LoadScrolls(const std::string& filename);
 void LoadPotions(const std::string& filename);
 void LoadSticks(const std::string& filename);
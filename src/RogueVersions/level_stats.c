@@ -0,0 +1,45 @@
+#include <stdlib.h>
+#include <level_stats.h>
+
+void level_stair_distance(const char* walkable, int lines, int cols, int from_y, int from_x, int to_y, int to_x, struct LevelStats* stats)
+{
+    int* dist;
+    int* queue;
+    int head = 0, tail = 0;
+    int dy, dx;
+
+    stats->stair_distance = -1;
+    dist = malloc(sizeof(int) * lines * cols);
+    queue = malloc(sizeof(int) * lines * cols);
+    for (head = 0; head < lines * cols; ++head)
+        dist[head] = -1;
+    head = 0;
+
+    dist[from_y * cols + from_x] = 0;
+    queue[tail++] = from_y * cols + from_x;
+    while (head < tail) {
+        int p = queue[head++];
+        int y = p / cols, x = p % cols;
+        if (y == to_y && x == to_x) {
+            stats->stair_distance = dist[p];
+            break;
+        }
+        for (dy = -1; dy <= 1; ++dy) {
+            for (dx = -1; dx <= 1; ++dx) {
+                int ny = y + dy, nx = x + dx;
+                if ((!dy && !dx) || ny < 0 || ny >= lines || nx < 0 || nx >= cols)
+                    continue;
+                if (!walkable[ny * cols + nx] || dist[ny * cols + nx] != -1)
+                    continue;
+                //can't cut a corner past a wall
+                if (dy && dx && (!walkable[ny * cols + x] || !walkable[y * cols + nx]))
+                    continue;
+                dist[ny * cols + nx] = dist[p] + 1;
+                queue[tail++] = ny * cols + nx;
+            }
+        }
+    }
+
+    free(queue);
+    free(dist);
+}
@@ -3,7 +3,17 @@
 #define CLEAR_MSG                     msg("")
 
 #ifdef ROGUE_COLLECTION
+struct DisplayInterface;
+struct InputInterface;
 void __declspec(dllexport) init_game(struct DisplayInterface* screen, struct InputInterface* input, int lines, int cols);
+struct LevelStats;
+int __declspec(dllexport) sweep_levels(int first_seed, int count, int depth, struct LevelStats* stats);
+struct AgentState;
+void __declspec(dllexport) get_agent_state(struct AgentState* state);
+void __declspec(dllexport) reseed_game(unsigned int seed);
+unsigned int __declspec(dllexport) get_random_draws(void);
+struct GameEnd;
+int __declspec(dllexport) get_game_end(struct GameEnd* end);
 #include <setjmp.h>
 extern jmp_buf exception_env;
 
@@ -0,0 +1,56 @@
+#pragma once
+#include "level_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AGENT_PACK_SIZE 26
+#define AGENT_NAME_SIZE 80
+
+//One thing in the hero's pack
+struct AgentItem
+{
+    char letter;                 //inventory letter
+    int kind;                    //STAT_POTION etc., -1 for anything else
+    int count;
+    char name[AGENT_NAME_SIZE];  //as the inventory shows it
+};
+
+//What an agent can know about the hero without reading the screen, filled in
+//by an engine's get_agent_state export.  The stats follow Agent::Stats; a few
+//names differ so they don't collide with the engines' macros.
+struct AgentState
+{
+    int str;
+    int str_add;                 //exceptional strength (18/xx), 3.6.3 only
+    int max_str;
+    int exp;
+    int level;                   //level of mastery
+    int ac;                      //armor class as the status line shows it, lower is better
+    int hp;
+    int hp_max;
+    char damage[16];
+    int depth;
+    int gold;
+    int item_count;
+    struct AgentItem items[AGENT_PACK_SIZE];  //the pack, in inventory order
+};
+
+typedef void (*get_agent_state_fn)(struct AgentState* state);
+
+//How a game ended, filled in by an engine's get_game_end export from what the
+//game handed its score()
+struct GameEnd
+{
+    int flags;                   //0 killed, 1 quit, 2 won, 3 killed with the amulet
+    int monster;                 //what did the killing, in the game's own coding, 0 unless killed
+    int score;                   //the gold the score file gets
+};
+
+//Returns 0 while the game is still going
+typedef int (*get_game_end_fn)(struct GameEnd* end);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,26 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Distance fields an engine can work out.  Each counts the moves to the nearest
+//of a set of squares, over the squares the hero has seen and knows can be
+//walked on, with diagonal moves allowed where the game allows them.
+enum
+{
+    DIST_HERO,        //to the hero
+    DIST_STAIRS,      //to the stairs, once they've been seen
+    DIST_UNEXPLORED,  //to the nearest known square next to one that hasn't been seen
+    DIST_NUM_FIELDS
+};
+
+//Fills in lines x cols distances, laid out like the screen, with a field's
+//moves from each square, or -1 where there's no known way.  Only while the
+//game is waiting for a key.  Returns 0, or -1 if there's no game going or the
+//engine doesn't know the field.
+typedef int (*get_distance_map_fn)(int field, int* distances, int lines, int cols);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//A copy of a game in progress, kept in memory for lookahead and replay
+//checkpoints.  The engine that fills it in owns the buffer, so it has to be
+//given back with that engine's release_snapshot.
+struct GameSnapshot
+{
+    unsigned char* data;
+    size_t size;                 //bytes in use
+    size_t capacity;             //bytes allocated
+};
+
+//Copy the game into a snapshot, reusing its buffer.  Returns 0, EBUSY if the
+//game isn't waiting for a command, or another errno value on failure.
+typedef int (*snapshot_game_fn)(struct GameSnapshot* snap);
+
+//Replace the game with one from a snapshot the same engine took.  Returns 0,
+//EBUSY if the game isn't waiting for a command, or EILSEQ if the snapshot is
+//damaged or from another engine, both leaving the game as it was.  Past those
+//checks it can only fail for lack of memory, and then the game is lost and
+//has to be ended.
+typedef int (*restore_game_fn)(const struct GameSnapshot* snap);
+
+typedef void (*release_snapshot_fn)(struct GameSnapshot* snap);
+
+#ifdef __cplusplus
+}
+#endif
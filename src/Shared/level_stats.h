@@ -0,0 +1,51 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Kinds of object counted on a level
+enum
+{
+    STAT_GOLD,
+    STAT_POTION,
+    STAT_SCROLL,
+    STAT_FOOD,
+    STAT_WEAPON,
+    STAT_ARMOR,
+    STAT_RING,
+    STAT_STICK,
+    STAT_AMULET,
+    STAT_NUM_ITEMS
+};
+
+//Summary of one generated level, filled in by an engine's sweep_levels export
+struct LevelStats
+{
+    int seed;
+    int depth;
+    int rooms;          //rooms that are really there
+    int gone_rooms;     //rooms replaced by a passage junction
+    int dark_rooms;
+    int maze_rooms;
+    int doors;
+    int secret_doors;
+    int traps;
+    int monsters;
+    int items[STAT_NUM_ITEMS];
+    int stair_distance; //moves from the hero to the stairs without searching, -1 if unreachable
+};
+
+//Generates count levels at the given depth, seeding the generator with
+//first_seed, first_seed+1, ... and writes one entry per level to stats.
+//Nothing is drawn.  Returns the number of levels generated.
+typedef int (*sweep_levels_fn)(int first_seed, int count, int depth, struct LevelStats* stats);
+
+//Fills in stats->stair_distance with a breadth first search over an
+//lines x cols grid of walkable (non-zero) squares.  Diagonal moves need both
+//orthogonal neighbours to be walkable, as in the game.
+void level_stair_distance(const char* walkable, int lines, int cols, int from_y, int from_x, int to_y, int to_x, struct LevelStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
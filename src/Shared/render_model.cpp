@@ -0,0 +1,163 @@
+#include <map>
+#include "pc_gfx_charmap.h"
+#include "render_model.h"
+
+namespace
+{
+    std::map<int, int> unix_chars = {
+        { PASSAGE,   '#' },
+        { DOOR,      '+' },
+        { FLOOR,     '.' },
+        { PLAYER,    '@' },
+        { TRAP,      '^' },
+        { STAIRS,    '%' },
+        { GOLD,      '*' },
+        { POTION,    '!' },
+        { SCROLL,    '?' },
+        { FOOD,      ':' },
+        { STICK,     '/' },
+        { ARMOR,     ']' },
+        { AMULET,    ',' },
+        { RING,      '=' },
+        { WEAPON,    ')' },
+        { VWALL,     '|' },
+        { HWALL,     '-' },
+        { ULWALL,    '-' },
+        { URWALL,    '-' },
+        { LLWALL,    '-' },
+        { LRWALL,    '-' },
+        { 204,       '|' },
+        { 185,       '|' },
+    };
+
+    unsigned int GetColor(int chr, int attr)
+    {
+        //if it is inside a room
+        if (attr == 0x07 || attr == 0) switch (chr)
+        {
+        case DOOR:
+        case VWALL: case HWALL:
+        case ULWALL: case URWALL: case LLWALL: case LRWALL:
+            return 0x06; //brown
+        case FLOOR:
+            return 0x0a; //light green
+        case STAIRS:
+            return 0x20; //black on light green
+        case TRAP:
+            return 0x05; //magenta
+        case GOLD:
+        case PLAYER:
+            return 0x0e; //yellow
+        case POTION:
+        case SCROLL:
+        case STICK:
+        case ARMOR:
+        case AMULET:
+        case RING:
+        case WEAPON:
+            return 0x09; //light blue
+        case FOOD:
+            return 0x04; //red
+        }
+        //if inside a passage or a maze
+        else if (attr == 0x70) switch (chr)
+        {
+        case FOOD:
+            return 0x74; //red on grey
+        case GOLD: case PLAYER:
+            return 0x7e; //yellow on grey
+        case POTION: case SCROLL: case STICK: case ARMOR: case AMULET: case RING: case WEAPON:
+            return 0x71; //blue on grey
+        }
+
+        return attr;
+    }
+
+    unsigned char FlipColor(unsigned char c)
+    {
+        return ((c & 0x0f) << 4) | ((c & 0xf0) >> 4);
+    }
+}
+
+RenderModel::RenderModel(const RenderOptions& options, GlyphMap map) :
+    m_options(options),
+    m_map(map),
+    m_cells(0x20000),
+    m_message(0x200)
+{
+    for (int tile = 0; tile < 2; ++tile) {
+        for (int color = 0; color < 0x100; ++color) {
+            for (int ch = 0; ch < 0x100; ++ch)
+                m_cells[(tile << 16) | (color << 8) | ch] = Compile(ch, color, tile != 0, false);
+        }
+        for (int ch = 0; ch < 0x100; ++ch)
+            m_message[(tile << 8) | ch] = Compile(ch, 0x70, tile != 0, true);
+    }
+}
+
+void RenderModel::Resolve(const uint32_t* data, Coord dimensions, Region rect, RenderCell* grid) const
+{
+    for (int y = rect.Top; y <= rect.Bottom; ++y) {
+        int i = y * dimensions.x + rect.Left;
+        int end = y * dimensions.x + rect.Right;
+        for (; i <= end; ++i)
+            grid[i] = Resolve(data[i], y);
+    }
+}
+
+RenderCell RenderModel::Compile(unsigned char ch, unsigned char color, bool is_tile, bool message_line) const
+{
+    RenderCell cell;
+    if (is_tile && m_options.tiles) {
+        cell.glyph = ch;
+        cell.color = color;
+        cell.flags = RenderCell::kTile;
+        return cell;
+    }
+
+    if (message_line) {
+        // Hack for consistent standout in msg lines.  Unix versions use '-'.
+        // PC uses ' ' with background color.  We want consistent behavior.
+        if (m_options.use_standout) {
+            if (ch == '-') {
+                ch = ' ';
+                is_tile = false;
+            }
+        }
+        else {
+            if (ch == ' ') {
+                ch = '-';
+                is_tile = false;
+            }
+            color = 0x07;
+        }
+    }
+
+    // Tiles from Unix versions come in with either color=0x00 (for regular state)
+    // or color=0x70 (for standout).  We need to translate these into more diverse
+    // colors.  Tiles from PC versions already have the correct color, so we
+    // technically don't need to do anything here, but it doesn't hurt to call
+    // GetColor.
+    if (is_tile) {
+        color = GetColor(ch, color);
+    }
+    if (!color || !m_options.use_colors) {
+        bool standout(color > 0x0f);
+        color = m_options.default_color;
+        if (standout && m_options.use_standout)
+            color = FlipColor(color);
+    }
+
+    cell.flags = (m_options.animate && ch == STAIRS) ? RenderCell::kBlink : 0;
+
+    if (m_options.use_unix_gfx && is_tile)
+    {
+        auto i = unix_chars.find(ch);
+        if (i != unix_chars.end())
+            ch = i->second;
+    }
+
+    cell.glyph = m_map ? m_map(ch) : ch;
+    cell.color = color;
+    return cell;
+}
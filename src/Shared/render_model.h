@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "display_interface_types.h"
+
+//What a graphics mode does to the game's characters on their way to the screen
+struct RenderOptions
+{
+    int default_color = 0x07;  //for text the game didn't color
+    bool tiles = false;        //tile cells are drawn from a tile sheet, as they come
+    bool use_unix_gfx = false;
+    bool use_colors = true;
+    bool use_standout = true;
+    bool animate = false;
+};
+
+//A screen cell as the front end draws it
+struct RenderCell
+{
+    enum { kTile = 0x01, kBlink = 0x02 };
+
+    uint16_t glyph;  //what to draw, or for kTile the game's character to find in the tile sheet
+    uint8_t color;
+    uint8_t flags;
+
+    uint16_t Glyph(int frame) const
+    {
+        return (flags & kBlink) && frame ? ' ' : glyph;
+    }
+};
+
+//Compiles a graphics mode into lookup tables over every character and color
+//the game can put in a cell, so the SDL and Qt front ends turn the screen into
+//glyphs and colors the same way, with one table load per cell.
+class RenderModel
+{
+public:
+    typedef uint16_t(*GlyphMap)(unsigned char);
+
+    //map turns a resolved character into the glyph the font draws it with
+    explicit RenderModel(const RenderOptions& options, GlyphMap map = nullptr);
+
+    RenderCell Resolve(uint32_t info, int y) const
+    {
+        //the message line has its own take on standout
+        if (y == 0 && (info >> 24) == 0x70)
+            return m_message[((info >> 8) & 0x100) | (info & 0xff)];
+        return m_cells[(info & 0x10000) | ((info >> 16) & 0xff00) | (info & 0xff)];
+    }
+
+    //Resolves rect of a screen buffer into a grid laid out the same way
+    void Resolve(const uint32_t* data, Coord dimensions, Region rect, RenderCell* grid) const;
+
+private:
+    RenderCell Compile(unsigned char ch, unsigned char color, bool is_tile, bool message_line) const;
+
+    RenderOptions m_options;
+    GlyphMap m_map;
+    std::vector<RenderCell> m_cells;    //by tile bit, color and character
+    std::vector<RenderCell> m_message;  //by tile bit and character, for standout on the top line
+};